@@ -0,0 +1,320 @@
+// fork_bench: pre-fork workers - memory per worker and fork safety
+//
+// Usage: fork_bench [workers=8] [iterations=1000000]
+//
+// The master forks <workers> children three times:
+//   idle - the child measures right after fork() (the floor)
+//   cold - singletons untouched before fork(); each worker resolves the dlsym
+//          table, maps the shm segment, builds its ThreadLogger ...
+//   warm - the master initializes everything first; workers inherit it. A
+//          master thread sits inside a hot_swap ReadSection and the master's
+//          ThreadLogWriter has unflushed records across the fork.
+// Each worker runs <iterations> accessor calls, logs, does one hot_swap
+// reload (a grace period: hangs if a dead thread's slot survived the fork)
+// and reports Rss / Pss / Private_Dirty from /proc/self/smaps_rollup, plus
+// the smaps entry of the dlsym table's own read-only page: a cold worker
+// dirties a private copy, a warm one must keep sharing the master's.
+//
+// Worker stdout is captured: every line must appear exactly once (no record
+// lost or written by both parent and child). A worker that hangs is killed
+// after 10 s and counted as a failure.
+#include "dso_common.hpp"
+#include "hot_swap_logger.hpp"
+#include "process_logger.hpp"
+#include "shm_logger.hpp"
+#include "thread_logger.hpp"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The dlsym variant resolves this against the executable
+extern "C" ProcessLogger& get_process_logger() {
+    static ProcessLogger instance("fork_bench");
+    return instance;
+}
+
+namespace {
+
+constexpr int kWorkerLines = 10;
+constexpr int kMasterLines = 50;
+
+struct Usage {
+    long rss_kb = 0;
+    long pss_kb = 0;
+    long private_dirty_kb = 0;
+    long table_private_kb = -1;  // The dlsym table page; -1 = not resolved
+    long table_shared_kb = -1;
+};
+
+Usage read_usage() {
+    Usage u;
+    FILE* f = std::fopen("/proc/self/smaps_rollup", "r");
+    if (!f) {
+        return u;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        long kb = 0;
+        if (std::sscanf(line, "Rss: %ld kB", &kb) == 1) {
+            u.rss_kb = kb;
+        } else if (std::sscanf(line, "Pss: %ld kB", &kb) == 1) {
+            u.pss_kb = kb;
+        } else if (std::sscanf(line, "Private_Dirty: %ld kB", &kb) == 1) {
+            u.private_dirty_kb = kb;
+        }
+    }
+    std::fclose(f);
+    return u;
+}
+
+// The table page is mprotect()ed on its own, so it is a VMA of its own:
+// that smaps entry is exactly the singleton's page
+void read_table_usage(Usage& u) {
+    const DlsymTable* table = g_dlsym_table.load(std::memory_order_acquire);
+    FILE* f = std::fopen("/proc/self/smaps", "r");
+    if (!table || !f) {
+        if (f) {
+            std::fclose(f);
+        }
+        return;
+    }
+    auto addr = reinterpret_cast<std::uintptr_t>(table);
+    bool ours = false;
+    char line[4096];
+    while (std::fgets(line, sizeof(line), f)) {
+        unsigned long start = 0;
+        unsigned long end = 0;
+        char perms[8];
+        long kb = 0;
+        if (std::sscanf(line, "%lx-%lx %7s", &start, &end, perms) == 3) {
+            ours = addr >= start && addr < end;
+        } else if (ours && std::sscanf(line, "Private_Dirty: %ld kB", &kb) == 1) {
+            u.table_private_kb = kb;
+        } else if (ours && std::sscanf(line, "Shared_Dirty: %ld kB", &kb) == 1) {
+            u.table_shared_kb = kb;
+        }
+    }
+    std::fclose(f);
+}
+
+// Every singleton the workers use
+void touch_singletons(std::uint64_t iterations) {
+    std::uintptr_t sum = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        sum += reinterpret_cast<std::uintptr_t>(&get_shm_logger());
+        sum += reinterpret_cast<std::uintptr_t>(&get_logger_via_dlsym());
+        hot_swap::ReadSection section;
+        sum += reinterpret_cast<std::uintptr_t>(&get_process_logger(section));
+        asm volatile("" : "+r"(sum));
+    }
+    get_thread_logger();
+}
+
+[[noreturn]] void worker(int id, bool measure_only, std::uint64_t iterations, int report_fd) {
+    alarm(10);
+    if (!measure_only) {
+        touch_singletons(iterations);
+        for (int i = 0; i < kWorkerLines; ++i) {
+            get_thread_logger().log(("worker " + std::to_string(id)).c_str());
+        }
+        reload_process_logger(("hot_swap/worker" + std::to_string(id)).c_str());
+    }
+    Usage u = read_usage();
+    read_table_usage(u);
+    std::cout.flush();
+    ssize_t ignored = write(report_fd, &u, sizeof(u));
+    (void)ignored;
+    _exit(0);  // The parent's atexit handlers and dtors are not ours to run
+}
+
+struct Result {
+    Usage avg;
+    long total_pss_kb = 0;
+    long table_private_kb = -1;  // Largest over the workers
+    long table_shared_kb = -1;   // Smallest over the workers
+    int failures = 0;
+};
+
+Result run_workers(int workers, bool measure_only, std::uint64_t iterations) {
+    Result r;
+    std::cout.flush();  // stdio buffers are copied into every child too
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+    for (int i = 0; i < workers; ++i) {
+        int p[2];
+        if (pipe(p) != 0) {
+            ++r.failures;
+            continue;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(p[0]);
+            worker(i, measure_only, iterations, p[1]);
+        }
+        close(p[1]);
+        pids.push_back(pid);
+        fds.push_back(p[0]);
+    }
+    int reported = 0;
+    for (std::size_t i = 0; i < pids.size(); ++i) {
+        Usage u;
+        bool ok = read(fds[i], &u, sizeof(u)) == sizeof(u);
+        close(fds[i]);
+        int status = 0;
+        waitpid(pids[i], &status, 0);
+        if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++r.failures;
+            continue;
+        }
+        r.avg.rss_kb += u.rss_kb;
+        r.avg.pss_kb += u.pss_kb;
+        r.avg.private_dirty_kb += u.private_dirty_kb;
+        r.total_pss_kb += u.pss_kb;
+        r.table_private_kb = std::max(r.table_private_kb, u.table_private_kb);
+        r.table_shared_kb = reported == 0 ? u.table_shared_kb
+                                          : std::min(r.table_shared_kb, u.table_shared_kb);
+        ++reported;
+    }
+    if (reported > 0) {
+        r.avg.rss_kb /= reported;
+        r.avg.pss_kb /= reported;
+        r.avg.private_dirty_kb /= reported;
+    }
+    return r;
+}
+
+std::size_t count(const std::string& text, const std::string& needle) {
+    std::size_t n = 0;
+    for (std::size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + needle.size())) {
+        ++n;
+    }
+    return n;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+    int workers = argc > 1 ? std::atoi(argv[1]) : 8;
+    std::uint64_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000ULL;
+    if (workers <= 0) {
+        std::fprintf(stderr, "usage: %s [workers] [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    // Logs (master and workers) go to a memfd, the report to the real stdout
+    std::cout.flush();
+    int out = dup(STDOUT_FILENO);
+    int captured = memfd_create("fork_bench.log", 0);
+    dup2(captured, STDOUT_FILENO);
+
+    Result idle = run_workers(workers, true, iterations);
+    Result cold = run_workers(workers, false, iterations);
+
+    // Warm: initialize in the master, then fork with a reader inside a
+    // section and buffered records still queued
+    touch_singletons(1);
+    std::mutex mutex;
+    std::condition_variable cv;
+    int phase = 0;
+    std::thread reader([&] {
+        hot_swap::ReadSection section;
+        std::unique_lock<std::mutex> lock(mutex);
+        phase = 1;
+        cv.notify_all();
+        cv.wait(lock, [&] { return phase == 2; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return phase == 1; });
+    }
+    Result warm;
+    {
+        ThreadLogWriter writer;
+        for (int i = 0; i < kMasterLines; ++i) {
+            get_thread_logger().log("master");
+        }
+        warm = run_workers(workers, false, iterations);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        phase = 2;
+    }
+    cv.notify_all();
+    reader.join();
+
+    std::cout.flush();
+    std::string log;
+    char buf[1 << 16];
+    ssize_t n;
+    lseek(captured, 0, SEEK_SET);
+    while ((n = read(captured, buf, sizeof(buf))) > 0) {
+        log.append(buf, static_cast<std::size_t>(n));
+    }
+    dup2(out, STDOUT_FILENO);
+    close(out);
+    close(captured);
+
+    std::printf("=== Fork: memory per worker (%d workers, %llu iterations each) ===\n", workers,
+                static_cast<unsigned long long>(iterations));
+    std::printf("%-6s %10s %10s %18s %14s\n", "mode", "Rss [kB]", "Pss [kB]", "Private_Dirty [kB]",
+                "sum Pss [kB]");
+    const std::pair<const char*, const Result*> rows[] = {{"idle", &idle}, {"cold", &cold},
+                                                          {"warm", &warm}};
+    int failures = 0;
+    for (const auto& row : rows) {
+        const Result& r = *row.second;
+        std::printf("%-6s %10ld %10ld %18ld %14ld%s\n", row.first, r.avg.rss_kb, r.avg.pss_kb,
+                    r.avg.private_dirty_kb, r.total_pss_kb, r.failures ? "  FAILED" : "");
+        failures += r.failures;
+    }
+
+    std::size_t master_lines = count(log, "[master] @");
+    std::size_t worker_lines = 0;
+    bool each_once = true;
+    for (int i = 0; i < workers; ++i) {
+        std::size_t lines = count(log, "[worker " + std::to_string(i) + "] @");
+        each_once = each_once && lines == 2 * kWorkerLines;  // cold + warm round
+        worker_lines += lines;
+    }
+    bool logs_ok = master_lines == kMasterLines && each_once;
+    std::printf("\n=== Fork: safety ===\n");
+    std::printf("master records  : %zu (expected %d, none duplicated by a child)\n", master_lines,
+                kMasterLines);
+    std::printf("worker records  : %zu (expected %d)\n", worker_lines, 2 * workers * kWorkerLines);
+    std::printf("worker reloads  : %s (grace period with a parent reader in a section)\n",
+                cold.failures + warm.failures == 0 ? "ok" : "FAILED");
+
+    // The whole-process numbers above are dominated by stacks, heap and libc;
+    // the singleton's own page is what pre-initializing actually saves
+    bool own_page = sysconf(_SC_PAGESIZE) == 4096;  // Else the table shares a VMA
+    bool table_ok = !own_page || (cold.table_private_kb > 0 && warm.table_private_kb == 0 &&
+                                  warm.table_shared_kb > 0);
+    std::printf("\n=== Fork: dlsym table page (worst worker) ===\n");
+    std::printf("%-6s %18s %17s\n", "mode", "Private_Dirty [kB]", "Shared_Dirty [kB]");
+    std::printf("%-6s %18ld %17ld\n", "cold", cold.table_private_kb, cold.table_shared_kb);
+    std::printf("%-6s %18ld %17ld%s\n", "warm", warm.table_private_kb, warm.table_shared_kb,
+                table_ok ? "" : "  FAILED");
+    if (!own_page) {
+        std::printf("(page size is not 4 KiB: the table is not on a page of its own, not checked)\n");
+    }
+
+    std::printf("\n=== Expected Result ===\n");
+    std::printf("table page: cold workers dirty a private copy, warm workers share the master's\n");
+    std::printf("  (the whole-process Private_Dirty barely moves: one page among stacks and heap)\n");
+    std::printf("every record exactly once, no worker hangs\n");
+    return failures == 0 && logs_ok && table_ok ? 0 : 1;
+}
@@ -0,0 +1,5 @@
+// dso_scope: inline variable, one per DSO (dso_scope_bench has the link modes)
+#include "bench_plugin.hpp"
+#include "logger.hpp"
+
+PROCESS_BENCH_PLUGIN(get_logger())
@@ -0,0 +1,6 @@
+// thread_scope: thread_local in a dlopen'ed DSO (__tls_get_addr), ctor on
+// each thread's first access
+#include "bench_plugin.hpp"
+#include "thread_logger.hpp"
+
+PROCESS_BENCH_PLUGIN(get_thread_logger())
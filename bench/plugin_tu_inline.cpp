@@ -0,0 +1,5 @@
+// tu_scope: C++17 inline variable, one per binary (here: per plugin)
+#include "bench_plugin.hpp"
+#include "logger_inline.hpp"
+
+PROCESS_BENCH_PLUGIN(get_logger_inline())
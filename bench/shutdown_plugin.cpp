@@ -0,0 +1,25 @@
+// One of many identical plugins loaded by shutdown_probe (copied to N files,
+// so each copy is its own DSO). Built -fvisibility=hidden: every copy has its
+// own dso_scope Logger, ProcessLogger and a small heap-owning table - the
+// per-DSO statics a normal exit destroys one DSO at a time.
+#include "logger.hpp"
+#include "process_logger.hpp"
+
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+ProcessLogger g_plugin_logger("shutdown_plugin");
+std::unordered_map<std::string, std::string> g_table;
+
+}  // namespace
+
+extern "C" __attribute__((visibility("default"))) void shutdown_plugin_entry(int id) {
+    for (int i = 0; i < 256; ++i) {
+        g_table.emplace("plugin." + std::to_string(id) + ".key." + std::to_string(i),
+                        std::string(48, 'v'));
+    }
+    get_logger().log("shutdown_plugin");
+    g_plugin_logger.log("shutdown_plugin");
+}
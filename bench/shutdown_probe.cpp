@@ -0,0 +1,146 @@
+// shutdown_probe: one process for shutdown_bench to time
+//
+// Usage: shutdown_probe <plugins> <threads> <timestamp fd>
+//   (SINGLETON_FAST_EXIT in the environment selects the fast path)
+//
+// Loads <plugins> copies of libshutdown_plugin.so, the shm logger and a
+// buffered ThreadLogWriter with <threads> parked workers, then writes
+// CLOCK_MONOTONIC to <timestamp fd> and shuts down the way a service would:
+//   normal - wake and join the workers, stop the writer, cleanup_shm_logger(),
+//            return from main() (static dtors, thread_local dtors, fini arrays)
+//   fast   - cleanup_shm_logger() (no munmap) and fast_exit::finish()
+// Workers flush their ThreadLogger batch before parking, so both paths
+// produce the same stdout; shutdown_bench checks that.
+#include "fast_exit.hpp"
+#include "process_logger.hpp"
+#include "shm_logger.hpp"
+#include "thread_logger.hpp"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::mutex g_mutex;
+std::condition_variable g_wake;
+int g_parked = 0;
+bool g_stop = false;
+
+bool copy_file(const char* from, const std::string& to) {
+    int in = open(from, O_RDONLY | O_CLOEXEC);
+    int out = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0755);
+    bool ok = in >= 0 && out >= 0;
+    char buf[1 << 16];
+    ssize_t n;
+    while (ok && (n = read(in, buf, sizeof(buf))) > 0) {
+        ok = write(out, buf, static_cast<std::size_t>(n)) == n;
+    }
+    if (in >= 0) {
+        close(in);
+    }
+    if (out >= 0) {
+        close(out);
+    }
+    return ok;
+}
+
+// Each copy is a separate file, so the loader maps a separate DSO
+bool load_plugins(int count) {
+    char dir[] = "/tmp/shutdown_probe.XXXXXX";
+    if (!mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return false;
+    }
+    bool ok = true;
+    for (int i = 0; i < count && ok; ++i) {
+        std::string path = std::string(dir) + "/plugin" + std::to_string(i) + ".so";
+        ok = copy_file(SHUTDOWN_PLUGIN, path);
+        void* handle = ok ? dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL) : nullptr;
+        auto entry = handle ? reinterpret_cast<void (*)(int)>(dlsym(handle, "shutdown_plugin_entry"))
+                            : nullptr;
+        if (!entry) {
+            std::fprintf(stderr, "shutdown_probe: %s: %s\n", path.c_str(),
+                         handle ? "no entry point" : dlerror());
+            ok = false;
+        } else {
+            entry(i);
+        }
+        unlink(path.c_str());  // The mapping stays
+    }
+    rmdir(dir);
+    return ok;
+}
+
+void worker(int id) {
+    for (int i = 0; i < 100; ++i) {
+        get_thread_logger().log(("worker " + std::to_string(id)).c_str());
+    }
+    get_thread_logger().flush();  // Quiescent point: nothing left in this thread's batch
+    std::unique_lock<std::mutex> lock(g_mutex);
+    ++g_parked;
+    g_wake.notify_all();
+    g_wake.wait(lock, [] { return g_stop; });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+    if (argc != 4) {
+        std::fprintf(stderr, "usage: %s <plugins> <threads> <timestamp fd>\n", argv[0]);
+        return 2;
+    }
+    int plugins = std::atoi(argv[1]);
+    int thread_count = std::atoi(argv[2]);
+    int ts_fd = std::atoi(argv[3]);
+
+    if (!load_plugins(plugins)) {
+        return 1;
+    }
+    get_shm_logger().log("shutdown_probe");
+
+    ThreadLogWriter writer;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    {
+        std::unique_lock<std::mutex> lock(g_mutex);
+        g_wake.wait(lock, [thread_count] { return g_parked == thread_count; });
+    }
+
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    std::uint64_t start_ns = static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+                             static_cast<std::uint64_t>(ts.tv_nsec);
+    ssize_t ignored = write(ts_fd, &start_ns, sizeof(start_ns));
+    (void)ignored;
+    close(ts_fd);
+
+    if (fast_exit::enabled()) {
+        cleanup_shm_logger();
+        return fast_exit::finish(0);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_stop = true;
+    }
+    g_wake.notify_all();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    writer.stop();
+    cleanup_shm_logger();
+    return 0;
+}
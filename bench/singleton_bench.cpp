@@ -0,0 +1,198 @@
+// singleton_bench: every accessor in the repo under 1..N threads, as JSON
+//
+// Usage: singleton_bench [iterations] [samples] [max_threads] [race_threads] > bench.json
+//
+// One probe per accessor (process_scope/bench/bench_probe.cpp): the three
+// lower scopes are built here, the process_scope variants are
+// process_scope_bench's probes. Each probe runs in its own process, since
+// main_owner / dlsym need the probe itself to own the logger.
+//
+//   scaling[]          - ns per accessor call from a dlopen'ed plugin, slowest
+//                        thread, at 1, 2, 4 .. max_threads threads
+//   first_access_us    - first call right after dlopen, median of fresh children
+//   load_us            - dlopen(RTLD_LAZY), median of fresh children
+//   first_access_race  - race_threads threads released together into the first
+//                        call (std::call_once in shm_logger.cpp,
+//                        resolve_get_logger()'s table, ...): slowest and median
+//                        thread, each the median of fresh children
+//
+// Progress and probe errors go to stderr; stdout is only the JSON document.
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Accessor {
+    const char* variant;
+    const char* probe;  // Executable name next to this one (after resolving symlinks)
+    const char* scope;
+    const char* accessor;
+};
+
+const Accessor kAccessors[] = {
+    {"tu_inline", "singleton_bench_tu_inline", "tu_scope", "get_logger_inline()"},
+    {"dso", "singleton_bench_dso", "dso_scope", "get_logger()"},
+    {"thread", "singleton_bench_thread", "thread_scope", "get_thread_logger()"},
+    {"core", "process_scope_bench_core", "process_scope", "get_process_logger()"},
+    {"core_api", "process_scope_bench_core_api", "process_scope", "*core_api()->logger"},
+    {"main_owner", "process_scope_bench_main_owner", "process_scope", "get_process_logger()"},
+    {"dlsym", "process_scope_bench_dlsym", "process_scope", "get_logger_via_dlsym()"},
+    {"shm", "process_scope_bench_shm", "process_scope", "get_shm_logger()"},
+    {"hot_swap", "process_scope_bench_hot_swap", "process_scope",
+     "get_process_logger(ReadSection)"},
+};
+
+struct Point {
+    unsigned threads;
+    double ns_per_call;
+};
+
+struct Result {
+    std::vector<Point> scaling;
+    double first_access_us = -1;
+    double load_us = -1;
+    unsigned race_threads = 0;
+    double race_max_us = -1;
+    double race_p50_us = -1;
+    bool ok = false;
+};
+
+// Directory of this executable, with a trailing '/'. /proc/self/exe, since
+// argv[0] is just a name when we were started through PATH, and a symlink's
+// directory does not hold the probes.
+std::string exe_dir(const char* argv0) {
+    char buf[4096];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    std::string self = n > 0 ? std::string(buf, static_cast<std::size_t>(n)) : std::string(argv0);
+    return self.substr(0, self.rfind('/') + 1);
+}
+
+// Runs the probe with its stdout on a pipe and parses the CSV it prints
+Result run_probe(const std::string& path, const std::vector<std::string>& params) {
+    Result r;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return r;
+    }
+    std::vector<char*> args{const_cast<char*>(path.c_str())};
+    for (const std::string& p : params) {
+        args.push_back(const_cast<char*>(p.c_str()));
+    }
+    args.push_back(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[1]);
+        execv(path.c_str(), args.data());
+        std::perror(path.c_str());
+        _exit(127);
+    }
+    close(fds[1]);
+    std::string out;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+        out.append(buf, static_cast<std::size_t>(n));
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    std::istringstream lines(out);
+    std::string line;
+    char name[64];
+    while (std::getline(lines, line)) {
+        Point p{};
+        if (std::sscanf(line.c_str(), "#race,%63[^,],%u,%lf,%lf", name, &r.race_threads,
+                        &r.race_max_us, &r.race_p50_us) == 4) {
+            continue;
+        }
+        if (std::sscanf(line.c_str(), "%63[^,],%u,%lf,%lf,%lf", name, &p.threads, &p.ns_per_call,
+                        &r.first_access_us, &r.load_us) == 5) {
+            r.scaling.push_back(p);
+        }
+    }
+    r.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && !r.scaling.empty();
+    return r;
+}
+
+// Negative values are "not measured"
+void print_number(double v) {
+    if (v < 0) {
+        std::printf("null");
+    } else {
+        std::printf("%.3f", v);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    unsigned long long iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000ULL;
+    int samples = argc > 2 ? std::atoi(argv[2]) : 11;
+    unsigned max_threads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : std::max(2u, hw);
+    unsigned race_threads = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4])) : std::max(8u, hw);
+    if (iters == 0 || samples <= 0 || max_threads == 0 || race_threads == 0) {
+        std::fprintf(stderr, "usage: %s [iterations] [samples] [max_threads] [race_threads]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::string dir = exe_dir(argv[0]);
+    std::vector<std::string> params{std::to_string(iters), std::to_string(samples),
+                                    std::to_string(max_threads), std::to_string(race_threads)};
+
+    utsname host{};
+    uname(&host);
+    std::printf("{\n");
+    std::printf("  \"schema\": \"singleton_bench/1\",\n");
+    std::printf("  \"host\": {\"cpus\": %u, \"kernel\": \"%s\", \"machine\": \"%s\", "
+                "\"compiler\": \"%s\"},\n",
+                hw, host.release, host.machine, __VERSION__);
+    std::printf("  \"params\": {\"iterations\": %llu, \"samples\": %d, \"max_threads\": %u, "
+                "\"race_threads\": %u},\n",
+                iters, samples, max_threads, race_threads);
+    std::printf("  \"accessors\": [");
+
+    int failures = 0;
+    const char* sep = "\n";
+    for (const Accessor& a : kAccessors) {
+        std::fprintf(stderr, "[singleton_bench] %s ...\n", a.variant);
+        Result r = run_probe(dir + a.probe, params);
+        if (!r.ok) {
+            std::fprintf(stderr, "[singleton_bench] %s: probe failed\n", a.variant);
+            ++failures;
+            continue;
+        }
+        std::printf("%s    {\"variant\": \"%s\", \"scope\": \"%s\", \"accessor\": \"%s\",\n", sep,
+                    a.variant, a.scope, a.accessor);
+        std::printf("     \"load_us\": ");
+        print_number(r.load_us);
+        std::printf(", \"first_access_us\": ");
+        print_number(r.first_access_us);
+        std::printf(",\n     \"scaling\": [");
+        for (std::size_t i = 0; i < r.scaling.size(); ++i) {
+            std::printf("%s{\"threads\": %u, \"ns_per_call\": %.3f}", i ? ", " : "",
+                        r.scaling[i].threads, r.scaling[i].ns_per_call);
+        }
+        std::printf("],\n     \"first_access_race\": {\"threads\": %u, \"max_us\": ", r.race_threads);
+        print_number(r.race_max_us);
+        std::printf(", \"p50_us\": ");
+        print_number(r.race_p50_us);
+        std::printf("}}");
+        sep = ",\n";
+    }
+    std::printf("\n  ],\n  \"failures\": %d\n}\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include "fast_exit.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+namespace fast_exit {
+namespace {
+
+struct Entry {
+    const char* name;
+    FlushFn fn;
+    void* ctx;
+};
+
+std::mutex g_mutex;
+Entry g_flushers[kMaxFlushers];
+int g_count = 0;
+
+// -1: not decided yet, read the environment on first use
+std::atomic<int> g_enabled{-1};
+
+}  // namespace
+
+bool add_flusher(const char* name, FlushFn fn, void* ctx) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_count == kMaxFlushers) {
+        return false;
+    }
+    g_flushers[g_count++] = Entry{name, fn, ctx};
+    return true;
+}
+
+void remove_flusher(FlushFn fn, void* ctx) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (int i = 0; i < g_count; ++i) {
+        if (g_flushers[i].fn == fn && g_flushers[i].ctx == ctx) {
+            for (int j = i + 1; j < g_count; ++j) {
+                g_flushers[j - 1] = g_flushers[j];
+            }
+            --g_count;
+            return;
+        }
+    }
+}
+
+bool enabled() {
+    int on = g_enabled.load(std::memory_order_relaxed);
+    if (on < 0) {
+        on = std::getenv("SINGLETON_FAST_EXIT") ? 1 : 0;
+        g_enabled.store(on, std::memory_order_relaxed);
+    }
+    return on != 0;
+}
+
+void set_enabled(bool on) {
+    g_enabled.store(on ? 1 : 0, std::memory_order_relaxed);
+}
+
+int finish(int code) {
+    if (!enabled()) {
+        return code;
+    }
+    // Run from a copy, so a flusher may add or remove entries
+    Entry flushers[kMaxFlushers];
+    int count;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        count = g_count;
+        for (int i = 0; i < count; ++i) {
+            flushers[i] = g_flushers[i];
+        }
+    }
+    // Newest first, like destructors. Whatever feeds a sink is created after
+    // it (a writer after the sink it writes into), so writers are flushed
+    // before the sinks they feed and no record reaches a stopped sink.
+    for (int i = count - 1; i >= 0; --i) {
+        flushers[i].fn(flushers[i].ctx);
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+    std::fflush(nullptr);
+    std::quick_exit(code);
+}
+
+}  // namespace fast_exit
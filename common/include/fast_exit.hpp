@@ -0,0 +1,61 @@
+#pragma once
+
+// Opt-in fast process exit. A normal exit runs every static destructor, the
+// main thread's thread_local destructors, every DSO's fini array and the
+// explicit cleanups (cleanup_shm_logger()'s munmap); none of that is needed
+// for correctness once the process is going away, and with many DSOs it is
+// what makes restarts slow.
+//
+//   int main() {
+//       startup_report::mark_main();
+//       ...
+//       return fast_exit::finish(0);
+//   }
+//
+// With SINGLETON_FAST_EXIT set (or set_enabled(true)), finish() runs the
+// registered flushers - the singletons that own buffered I/O, newest first -
+// flushes stdio and std::cout/cerr/clog, then calls quick_exit(): no
+// destructors, no atexit handlers, no munmap. Otherwise it returns `code` and
+// main() returns as usual.
+//
+// What is NOT flushed: records still sitting in another live thread's
+// ThreadLogger batch (only the owning thread may touch it). State that is
+// already in shared mappings - binary_log's chunks, the shm log ring, the shm
+// segment - survives the exit unchanged. Lives in libsingleton_startup.so so
+// every DSO registers into the same table.
+#define FAST_EXIT_API __attribute__((visibility("default")))
+
+namespace fast_exit {
+
+using FlushFn = void (*)(void* ctx);
+
+constexpr int kMaxFlushers = 32;
+
+// Returns false when the table is full (the owner then only flushes in its dtor)
+FAST_EXIT_API bool add_flusher(const char* name, FlushFn fn, void* ctx);
+FAST_EXIT_API void remove_flusher(FlushFn fn, void* ctx);
+
+// SINGLETON_FAST_EXIT in the environment, unless overridden
+FAST_EXIT_API bool enabled();
+FAST_EXIT_API void set_enabled(bool on);
+
+// Fast path: flush and quick_exit(code), never returns. Normal path: returns code
+FAST_EXIT_API int finish(int code);
+
+// Registers a member function of a long-lived object for the object's lifetime
+template <typename T, void (T::*Flush)()>
+class Flusher {
+public:
+    Flusher(const char* name, T* owner) : owner_(owner) { add_flusher(name, &call, owner_); }
+    ~Flusher() { remove_flusher(&call, owner_); }
+
+    Flusher(const Flusher&) = delete;
+    Flusher& operator=(const Flusher&) = delete;
+
+private:
+    static void call(void* ctx) { (static_cast<T*>(ctx)->*Flush)(); }
+
+    T* owner_;
+};
+
+}  // namespace fast_exit
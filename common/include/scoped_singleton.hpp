@@ -0,0 +1,112 @@
+#pragma once
+#include <type_traits>
+
+// scoped_singleton<T, Scope>: one T per Scope, with the storage each scope
+// needs and nothing more. Every accessor is a forced-inline static member,
+// so a call compiles to the same instructions as the hand-rolled versions
+// in the scope directories:
+//
+//   scope::tu       per translation unit  (tu_scope: `static Logger g_logger`)
+//   scope::dso      per executable / .so  (dso_scope: g_logger, hidden)
+//   scope::thread   per thread            (thread_scope: inline thread_local)
+//   scope::process  per process, across DSOs (default visibility: the
+//                   dynamic linker binds every image to one definition)
+//
+// Moving a singleton between scopes is a one-token change:
+//
+//   Logger& log = scoped_singleton<Logger, scope::dso>::get();
+//   Logger& log = scoped_singleton<Logger, scope::process>::get();
+//
+// Instances are constructed during static initialization (thread: on the
+// thread's first access), like the `inline` globals they replace.
+// scoped_singleton_check verifies the generated code against hand-written
+// accessors.
+namespace scope {
+
+// Marks a type as a scope policy for the static_assert in scoped_singleton
+struct policy_tag {};
+
+// Anonymous namespace: every TU that includes this header gets its own
+// `tu`, hence its own storage<T>
+namespace {
+struct tu : policy_tag {
+    template <typename T>
+    struct storage {
+        static inline T value{};
+
+        __attribute__((always_inline)) static T& get() noexcept { return value; }
+    };
+};
+}  // namespace
+
+// Hidden even without -fvisibility=hidden: each linked image keeps its own
+// copy and reaches it PC-relative (no GOT)
+struct dso : policy_tag {
+    template <typename T>
+    struct __attribute__((visibility("hidden"))) storage {
+        static inline T value{};
+
+        __attribute__((always_inline)) static T& get() noexcept { return value; }
+    };
+};
+
+struct thread : policy_tag {
+    template <typename T>
+    struct storage {
+        static inline thread_local T value{};
+
+        // May construct T (TLS init) on this thread's first access
+        __attribute__((always_inline)) static T& get() noexcept(
+            std::is_nothrow_default_constructible_v<T>) {
+            return value;
+        }
+    };
+};
+
+// Default visibility even inside -fvisibility=hidden code: the variable
+// becomes a unique symbol the dynamic linker resolves once for the whole
+// process. PIC code pays one GOT load for it. T itself must have default
+// visibility, otherwise the instantiation is hidden again (per DSO).
+struct process : policy_tag {
+    template <typename T>
+    struct __attribute__((visibility("default"))) storage {
+        static inline T value{};
+
+        __attribute__((always_inline)) static T& get() noexcept { return value; }
+    };
+};
+
+// Machine scope is an exclusive lock (os_scope's flock) or shared memory
+// (process_scope/shared_memory), not something an accessor can hand out.
+// Defined only so that picking it fails with one readable message.
+struct machine {
+    template <typename T>
+    struct storage {
+        static T& get() noexcept;
+    };
+};
+
+}  // namespace scope
+
+template <typename T, typename Scope>
+class scoped_singleton {
+    static_assert(!std::is_same_v<Scope, scope::machine>,
+                  "scope::machine has no in-process storage: use os_scope's flock "
+                  "singleton or process_scope/shared_memory");
+    static_assert(std::is_base_of_v<scope::policy_tag, Scope> ||
+                      std::is_same_v<Scope, scope::machine>,
+                  "Scope must be scope::tu, scope::dso, scope::thread or scope::process");
+    static_assert(std::is_object_v<T> && !std::is_const_v<T>,
+                  "scoped_singleton<T, Scope> needs a non-const object type");
+    static_assert(std::is_default_constructible_v<T>,
+                  "scoped_singleton<T, Scope> constructs T with T{}");
+
+    using storage = typename Scope::template storage<T>;
+
+public:
+    scoped_singleton() = delete;
+
+    __attribute__((always_inline)) static T& get() noexcept(noexcept(storage::get())) {
+        return storage::get();
+    }
+};
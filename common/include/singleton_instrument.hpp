@@ -0,0 +1,158 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Accessor instrumentation, compiled out unless SINGLETON_INSTRUMENT=1
+// (cmake -DSINGLETON_INSTRUMENT=ON). Place first in an accessor body:
+//
+//   ProcessLogger& get_process_logger() {
+//       SINGLETON_ACCESS("get_process_logger/core_shared_lib");
+//       return g_logger;
+//   }
+//
+// Per site: access count, latency of the first call (resolution + any
+// first-use ctor) and how many threads overlapped it and for how long (the
+// call_once / static-init waiters). Constructor times come from
+// startup_report::CtorTimer, aggregated per type and tag.
+//
+// Access counts live in a per-thread counter and are added to the site every
+// kFlushEvery calls and at thread exit; once a thread has seen the first call
+// finish, the hot path is that counter alone (no shared cache line, no
+// guard). The tables live in libsingleton_startup.so next to the startup
+// report; with SINGLETON_INSTRUMENT_REPORT set, mark_main() arranges for
+// print() at exit.
+#define SINGLETON_INSTRUMENT_API __attribute__((visibility("default")))
+
+namespace singleton_instrument {
+
+constexpr std::uint32_t kFlushEvery = 1024;
+
+struct Site {
+    char name[48];
+    std::atomic<std::uint64_t> accesses;
+    std::atomic<bool> first_done;
+    std::atomic<std::uint64_t> first_access_ns;  // Claimed by the first call to finish
+    std::atomic<bool> first_before_main;
+    std::atomic<std::uint32_t> init_waiters;
+    std::atomic<std::uint64_t> init_wait_ns;
+};
+
+struct SiteStats {
+    const char* name;
+    std::uint64_t accesses;
+    std::uint64_t first_access_ns;
+    bool first_before_main;
+    std::uint32_t init_waiters;
+    std::uint64_t init_wait_ns;
+};
+
+struct CtorStats {
+    const char* type;
+    const char* tag;
+    std::uint64_t count;
+    std::uint64_t total_ns;
+    std::uint64_t max_ns;
+    std::uint64_t before_main;
+};
+
+// A new entry per call: a site in a -fvisibility=hidden DSO registers once
+// per DSO, which is exactly the duplication worth seeing
+SINGLETON_INSTRUMENT_API Site& site(const char* name);
+SINGLETON_INSTRUMENT_API void finish_first(Site& site, std::uint64_t ns);
+// Called by startup_report::record()
+SINGLETON_INSTRUMENT_API void note_ctor(const char* type, const char* tag, std::uint64_t ns,
+                                        bool before_main);
+
+// Query: copy up to `max` entries, return how many exist
+SINGLETON_INSTRUMENT_API std::size_t sites(SiteStats* out, std::size_t max);
+SINGLETON_INSTRUMENT_API std::size_t ctors(CtorStats* out, std::size_t max);
+SINGLETON_INSTRUMENT_API void print();
+
+inline std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// One thread's unflushed accesses to one site. Lives in the library's TLS,
+// not the accessor's DSO, so the flush at thread exit never reads the TLS
+// of a DSO that has been dlclose()d since.
+struct ThreadCount {
+    Site* site;
+    std::uint32_t pending;
+};
+
+// What SINGLETON_ACCESS keeps in the accessor's DSO. Trivially constructible
+// and destructible, so the function-local thread_local needs no guard and no
+// TLS dtor; dlclose() may free it at any time.
+struct ThreadSlot {
+    ThreadCount* count = nullptr;
+    bool settled = false;  // This thread has seen first_done
+};
+
+// This thread's counter for `site`; flushed into it when the thread exits
+SINGLETON_INSTRUMENT_API ThreadCount& register_thread(Site& site);
+
+class AccessScope {
+public:
+    template <typename GetSite>
+    AccessScope(ThreadSlot& slot, GetSite get_site) : slot_(launder_tls(slot)) {
+        if (__builtin_expect(!slot_.settled, 0)) {
+            settle(get_site());
+        }
+        ThreadCount& count = *slot_.count;
+        if (++count.pending == kFlushEvery) {
+            count.site->accesses.fetch_add(kFlushEvery, std::memory_order_relaxed);
+            count.pending = 0;
+        }
+    }
+
+    ~AccessScope() {
+        if (__builtin_expect(start_ != 0, 0)) {
+            finish_first(*slot_.count->site, now_ns() - start_);
+        }
+    }
+
+    AccessScope(const AccessScope&) = delete;
+    AccessScope& operator=(const AccessScope&) = delete;
+
+private:
+    // In a dlopen'ed DSO every use of a thread_local is a __tls_get_addr
+    // call, and GCC repeats it after the settle() branch; one opaque copy
+    // of the address keeps it to one call per access
+    static ThreadSlot& launder_tls(ThreadSlot& slot) {
+        ThreadSlot* p = &slot;
+        asm("" : "+r"(p));
+        return *p;
+    }
+
+    // Until the first call has finished, every call is timed
+    __attribute__((noinline)) void settle(Site& site) {
+        if (!slot_.count) {
+            slot_.count = &register_thread(site);
+        }
+        if (site.first_done.load(std::memory_order_acquire)) {
+            slot_.settled = true;
+        } else {
+            start_ = now_ns();
+        }
+    }
+
+    ThreadSlot& slot_;
+    std::uint64_t start_ = 0;
+};
+
+}  // namespace singleton_instrument
+
+#if SINGLETON_INSTRUMENT
+#define SINGLETON_ACCESS(name)                                                  \
+    static thread_local ::singleton_instrument::ThreadSlot singleton_slot_;      \
+    ::singleton_instrument::AccessScope singleton_access_(                       \
+        singleton_slot_, []() -> ::singleton_instrument::Site& {                \
+            static ::singleton_instrument::Site& site = ::singleton_instrument::site(name); \
+            return site;                                                         \
+        })
+#else
+#define SINGLETON_ACCESS(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Records every singleton constructor with its duration and whether it ran
+// before main(). Lives in libsingleton_startup.so so all DSOs (including
+// -fvisibility=hidden plugins) share one table.
+//
+// Demos call startup_report::mark_main() first thing in main(). When the
+// environment variable SINGLETON_STARTUP_REPORT is set, the report is printed
+// to stderr at exit. Ctor times are also aggregated per type and tag for
+// singleton_instrument.hpp.
+#define STARTUP_REPORT_API __attribute__((visibility("default")))
+
+namespace startup_report {
+
+STARTUP_REPORT_API void record(const char* type, const char* tag, const void* obj,
+                               std::uint64_t ns);
+STARTUP_REPORT_API void mark_main();
+STARTUP_REPORT_API bool main_entered();
+STARTUP_REPORT_API void print();
+
+// Place first in a constructor body; records the body's duration
+class CtorTimer {
+public:
+    CtorTimer(const char* type, const void* obj, const char* tag = nullptr)
+        : type_(type), tag_(tag), obj_(obj), start_(std::chrono::steady_clock::now()) {}
+
+    ~CtorTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        record(type_, tag_, obj_, static_cast<std::uint64_t>(ns));
+    }
+
+    CtorTimer(const CtorTimer&) = delete;
+    CtorTimer& operator=(const CtorTimer&) = delete;
+
+private:
+    const char* type_;
+    const char* tag_;
+    const void* obj_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace startup_report
@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Compile-time log-level filtering and pre-split format strings.
+//
+//   SLOG(get_logger_inline(), Debug, "x={} y={}", x, y);
+//
+// - The level is a template parameter; calls below SINGLETON_LOG_LEVEL are
+//   discarded by `if constexpr`, and the macro form does not even evaluate
+//   its arguments.
+// - The format string is parsed at compile time: placeholder count is checked
+//   against the argument count, and the literal segments are stored in a
+//   constexpr table so the hot path only copies bytes.
+namespace static_log {
+
+enum class Level : int { Trace = 0, Debug, Info, Warn, Error, Off };
+
+// Default threshold: everything in debug builds, Info and up with NDEBUG.
+// Override with -DSINGLETON_LOG_LEVEL=<0..5> (see common/CMakeLists.txt).
+#ifndef SINGLETON_LOG_LEVEL
+#ifdef NDEBUG
+#define SINGLETON_LOG_LEVEL 2
+#else
+#define SINGLETON_LOG_LEVEL 0
+#endif
+#endif
+
+inline constexpr Level kMinLevel = static_cast<Level>(SINGLETON_LOG_LEVEL);
+
+template <Level L>
+inline constexpr bool enabled = L >= kMinLevel && L != Level::Off;
+
+constexpr std::string_view level_name(Level l) {
+    switch (l) {
+    case Level::Trace: return "TRACE";
+    case Level::Debug: return "DEBUG";
+    case Level::Info:  return "INFO";
+    case Level::Warn:  return "WARN";
+    case Level::Error: return "ERROR";
+    default:           return "OFF";
+    }
+}
+
+// --- Compile-time format parsing ---
+
+struct Segment {
+    std::size_t offset;
+    std::size_t length;
+};
+
+// Number of "{}" placeholders, or -1 if a brace is unbalanced
+constexpr int count_placeholders(std::string_view fmt) {
+    int n = 0;
+    for (std::size_t i = 0; i < fmt.size(); ++i) {
+        if (fmt[i] == '{') {
+            if (i + 1 >= fmt.size() || fmt[i + 1] != '}') {
+                return -1;
+            }
+            ++n;
+            ++i;
+        } else if (fmt[i] == '}') {
+            return -1;
+        }
+    }
+    return n;
+}
+
+// Literal text between placeholders: N placeholders -> N + 1 segments
+template <std::size_t N>
+constexpr std::array<Segment, N + 1> split_format(std::string_view fmt) {
+    std::array<Segment, N + 1> segs{};
+    std::size_t seg = 0;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < fmt.size(); ++i) {
+        if (fmt[i] == '{') {
+            segs[seg++] = Segment{start, i - start};
+            start = i + 2;
+            ++i;
+        }
+    }
+    segs[seg] = Segment{start, fmt.size() - start};
+    return segs;
+}
+
+// Fmt is a type with `static constexpr std::string_view str()` (see SLOG_FMT)
+template <typename Fmt>
+struct Parsed {
+    static constexpr std::string_view text = Fmt::str();
+    static constexpr int count = count_placeholders(text);
+    static_assert(count >= 0, "static_log: unbalanced '{' or '}' in format string");
+    static constexpr auto segments = split_format<static_cast<std::size_t>(count)>(text);
+};
+
+// --- Runtime emission (no parsing, only copies and number conversion) ---
+
+class Writer {
+public:
+    Writer(char* buf, std::size_t cap) : buf_(buf), end_(buf + cap - 1), pos_(buf) {}
+
+    void put(std::string_view s) {
+        std::size_t n = std::min<std::size_t>(s.size(), static_cast<std::size_t>(end_ - pos_));
+        std::memcpy(pos_, s.data(), n);
+        pos_ += n;
+    }
+
+    void arg(const char* s) { put(s ? std::string_view(s) : std::string_view("(null)")); }
+    void arg(std::string_view s) { put(s); }
+    void arg(bool b) { put(b ? "true" : "false"); }
+    void arg(char c) { put(std::string_view(&c, 1)); }
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T>> arg(T v) {
+        auto res = std::to_chars(pos_, end_, v);
+        if (res.ec == std::errc()) {
+            pos_ = res.ptr;
+        }
+    }
+
+    void arg(const void* p) {
+        put("0x");
+        auto res = std::to_chars(pos_, end_, reinterpret_cast<std::uintptr_t>(p), 16);
+        if (res.ec == std::errc()) {
+            pos_ = res.ptr;
+        }
+    }
+
+    const char* finish() {
+        *pos_ = '\0';
+        return buf_;
+    }
+
+private:
+    char* buf_;
+    char* end_;
+    char* pos_;
+};
+
+template <typename P, std::size_t... I, typename... Args>
+void format_impl(Writer& w, std::index_sequence<I...>, const Args&... args) {
+    ((w.put(P::text.substr(P::segments[I].offset, P::segments[I].length)), w.arg(args)), ...);
+    constexpr Segment last = P::segments[sizeof...(I)];
+    w.put(P::text.substr(last.offset, last.length));
+}
+
+// Render "LEVEL message" into buf (truncated, always NUL-terminated)
+template <Level L, typename Fmt, typename... Args>
+const char* format_to(char* buf, std::size_t cap, Fmt, const Args&... args) {
+    using P = Parsed<Fmt>;
+    static_assert(P::count == static_cast<int>(sizeof...(Args)),
+                  "static_log: placeholder count does not match argument count");
+    Writer w(buf, cap);
+    w.put(level_name(L));
+    w.put(" ");
+    format_impl<P>(w, std::index_sequence_for<Args...>{}, args...);
+    return w.finish();
+}
+
+inline constexpr std::size_t kLineSize = 128;
+
+}  // namespace static_log
+
+// Wraps a string literal into a type so it can be parsed at compile time
+#define SLOG_FMT(s)                                                        \
+    [] {                                                                   \
+        struct SlogFmt {                                                   \
+            static constexpr std::string_view str() { return s; }          \
+        };                                                                 \
+        return SlogFmt{};                                                  \
+    }()
+
+// Level-filtered log call; arguments are not evaluated when disabled
+#define SLOG(logger, level, fmt, ...)                                      \
+    do {                                                                   \
+        if constexpr (::static_log::enabled<::static_log::Level::level>) { \
+            (logger).template logf<::static_log::Level::level>(            \
+                SLOG_FMT(fmt), ##__VA_ARGS__);                             \
+        }                                                                  \
+    } while (0)
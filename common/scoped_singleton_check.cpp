@@ -0,0 +1,125 @@
+// scoped_singleton_check: scoped_singleton<T, Scope> vs hand-written accessors
+//
+// Usage: scoped_singleton_check
+//   code      - each scoped accessor in libscoped_singleton_codegen.so has
+//               the same size and the same bytes as its hand-written twin,
+//               except address fields (rel32 displacements: runs of <= 4
+//               differing bytes)
+//   instances - who shares an instance: two TUs of the library, the library
+//               and this executable, two threads
+// Exits 1 on any mismatch.
+#include "scoped_singleton.hpp"
+#include "scoped_singleton_probe.hpp"
+
+#include <dlfcn.h>
+#include <elf.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// st_size of `name` in the ELF file that contains `fn`
+std::size_t symbol_size(const void* fn, const char* name) {
+    Dl_info info{};
+    if (!dladdr(fn, &info) || !info.dli_fname) {
+        return 0;
+    }
+    std::ifstream in(info.dli_fname, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (image.size() < sizeof(Elf64_Ehdr)) {
+        return 0;
+    }
+    auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(image.data());
+    auto* shdrs = reinterpret_cast<const Elf64_Shdr*>(image.data() + ehdr->e_shoff);
+    for (int i = 0; i < ehdr->e_shnum; ++i) {
+        if (shdrs[i].sh_type != SHT_SYMTAB && shdrs[i].sh_type != SHT_DYNSYM) {
+            continue;
+        }
+        auto* syms = reinterpret_cast<const Elf64_Sym*>(image.data() + shdrs[i].sh_offset);
+        const char* strtab = image.data() + shdrs[shdrs[i].sh_link].sh_offset;
+        std::size_t count = shdrs[i].sh_size / sizeof(Elf64_Sym);
+        for (std::size_t s = 0; s < count; ++s) {
+            if (std::strcmp(strtab + syms[s].st_name, name) == 0) {
+                return syms[s].st_size;
+            }
+        }
+    }
+    return 0;
+}
+
+// Same instructions, ignoring the addresses they refer to
+bool same_code(const void* a, const void* b, std::size_t size) {
+    auto* pa = static_cast<const unsigned char*>(a);
+    auto* pb = static_cast<const unsigned char*>(b);
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        run = pa[i] == pb[i] ? 0 : run + 1;
+        if (run > 4) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int g_failures = 0;
+
+void check(bool ok) {
+    if (!ok) {
+        ++g_failures;
+    }
+}
+
+void code_row(const char* scope, const char* hand_name, CodegenProbe* (*hand)(),
+              const char* scoped_name, CodegenProbe* (*scoped)()) {
+    auto hp = reinterpret_cast<const void*>(hand);
+    auto sp = reinterpret_cast<const void*>(scoped);
+    std::size_t hs = symbol_size(hp, hand_name);
+    std::size_t ss = symbol_size(sp, scoped_name);
+    bool ok = hs != 0 && hs == ss && same_code(hp, sp, hs);
+    check(ok);
+    std::cout << std::left << std::setw(10) << scope << std::right << std::setw(10) << hs
+              << std::setw(12) << ss << "   " << (ok ? "same" : "DIFFERENT") << "\n";
+}
+
+void instance_row(const char* what, bool shared, bool want_shared) {
+    bool ok = shared == want_shared;
+    check(ok);
+    std::cout << std::left << std::setw(46) << what << (shared ? "shared  " : "separate")
+              << (ok ? "" : "   WRONG") << "\n";
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "=== scoped_singleton Check ===\n\n";
+    std::cout << std::left << std::setw(10) << "scope" << std::right << std::setw(10) << "hand(B)"
+              << std::setw(12) << "scoped(B)" << "   code\n";
+    code_row("tu", "hand_tu", hand_tu, "scoped_tu", scoped_tu);
+    code_row("dso", "hand_dso", hand_dso, "scoped_dso", scoped_dso);
+    code_row("thread", "hand_thread", hand_thread, "scoped_thread", scoped_thread);
+    code_row("process", "hand_process", hand_process, "scoped_process", scoped_process);
+
+    std::cout << "\n";
+    instance_row("tu: two TUs of the library", scoped_tu() == scoped_tu_other(), false);
+    instance_row("dso: two TUs of the library", scoped_dso() == scoped_dso_other(), true);
+    instance_row("dso: library vs executable",
+                 scoped_dso() == &scoped_singleton<CodegenProbe, scope::dso>::get(), false);
+    instance_row("process: library vs executable",
+                 scoped_process() == &scoped_singleton<CodegenProbe, scope::process>::get(), true);
+    CodegenProbe* other = nullptr;
+    std::thread([&other] { other = scoped_thread(); }).join();
+    instance_row("thread: main vs another thread", scoped_thread() == other, false);
+    instance_row("thread: library vs executable, same thread",
+                 scoped_thread() == &scoped_singleton<CodegenProbe, scope::thread>::get(), true);
+
+    std::cout << "\n" << (g_failures == 0 ? "OK" : "FAILED") << " (" << g_failures
+              << " mismatch(es))\n";
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+// Hand-written accessors next to their scoped_singleton equivalents, built
+// as a -fPIC shared object so visibility decides the code (GOT or not)
+#include "scoped_singleton_probe.hpp"
+#include "scoped_singleton.hpp"
+
+CodegenProbe::CodegenProbe() : value(42) {}
+
+// --- hand-written, as in the scope directories ---
+static CodegenProbe g_tu;                                               // tu_scope
+__attribute__((visibility("hidden"))) inline CodegenProbe g_dso;         // dso_scope
+inline thread_local CodegenProbe g_thread;                              // thread_scope
+__attribute__((visibility("default"))) inline CodegenProbe g_process;   // process-wide
+
+CODEGEN_API CodegenProbe* hand_tu() { return &g_tu; }
+CODEGEN_API CodegenProbe* hand_dso() { return &g_dso; }
+CODEGEN_API CodegenProbe* hand_thread() { return &g_thread; }
+CODEGEN_API CodegenProbe* hand_process() { return &g_process; }
+
+// --- scoped_singleton ---
+CODEGEN_API CodegenProbe* scoped_tu() { return &scoped_singleton<CodegenProbe, scope::tu>::get(); }
+CODEGEN_API CodegenProbe* scoped_dso() { return &scoped_singleton<CodegenProbe, scope::dso>::get(); }
+CODEGEN_API CodegenProbe* scoped_thread() {
+    return &scoped_singleton<CodegenProbe, scope::thread>::get();
+}
+CODEGEN_API CodegenProbe* scoped_process() {
+    return &scoped_singleton<CodegenProbe, scope::process>::get();
+}
@@ -0,0 +1,11 @@
+// Second TU of libscoped_singleton_codegen.so: scope::tu must differ from
+// the first TU's instance, scope::dso must not
+#include "scoped_singleton_probe.hpp"
+#include "scoped_singleton.hpp"
+
+CODEGEN_API CodegenProbe* scoped_tu_other() {
+    return &scoped_singleton<CodegenProbe, scope::tu>::get();
+}
+CODEGEN_API CodegenProbe* scoped_dso_other() {
+    return &scoped_singleton<CodegenProbe, scope::dso>::get();
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <atomic>
+
+// T used by scoped_singleton_check: non-trivial constructor, so the thread
+// scope goes through the same TLS init path as ThreadLogger
+struct CodegenProbe {
+    CodegenProbe();
+    int value;
+};
+
+// Each accessor returns the instance address; pairs must compile alike
+#define CODEGEN_API extern "C" __attribute__((noinline, used, visibility("default")))
+
+CODEGEN_API CodegenProbe* hand_tu();
+CODEGEN_API CodegenProbe* scoped_tu();
+CODEGEN_API CodegenProbe* hand_dso();
+CODEGEN_API CodegenProbe* scoped_dso();
+CODEGEN_API CodegenProbe* hand_thread();
+CODEGEN_API CodegenProbe* scoped_thread();
+CODEGEN_API CodegenProbe* hand_process();
+CODEGEN_API CodegenProbe* scoped_process();
+
+// Same library, second TU (scoped_singleton_codegen_tu2.cpp)
+CODEGEN_API CodegenProbe* scoped_tu_other();
+CODEGEN_API CodegenProbe* scoped_dso_other();
@@ -0,0 +1,168 @@
+#include "singleton_instrument.hpp"
+#include "startup_report.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace singleton_instrument {
+namespace {
+
+constexpr std::size_t kMaxSites = 64;
+constexpr std::size_t kMaxCtors = 64;
+
+struct CtorEntry {
+    const char* type;
+    char tag[32];  // Copied: the tag may live in a DSO that is unloaded later
+    std::uint64_t count;
+    std::uint64_t total_ns;
+    std::uint64_t max_ns;
+    std::uint64_t before_main;
+};
+
+// Zero-initialized, like the startup report's table: usable from any
+// accessor or constructor, in any DSO, before main()
+Site g_sites[kMaxSites + 1];  // Last one collects registrations past the limit
+std::atomic<std::size_t> g_site_count{0};
+
+// This thread's counters, one per site it has touched, flushed at thread
+// exit. A deque never moves its elements, so accessors can keep pointers.
+struct ThreadFlush {
+    std::deque<ThreadCount> counts;
+
+    ~ThreadFlush() {
+        for (ThreadCount& c : counts) {
+            if (c.pending) {
+                c.site->accesses.fetch_add(c.pending, std::memory_order_relaxed);
+                c.pending = 0;
+            }
+        }
+    }
+};
+
+thread_local ThreadFlush t_flush;
+
+std::mutex g_ctor_mutex;
+CtorEntry g_ctors[kMaxCtors];
+std::size_t g_ctor_count = 0;
+std::uint64_t g_ctor_overflow = 0;
+
+}  // namespace
+
+Site& site(const char* name) {
+    std::size_t idx = g_site_count.fetch_add(1, std::memory_order_relaxed);
+    Site& s = g_sites[idx < kMaxSites ? idx : kMaxSites];
+    if (idx >= kMaxSites) {
+        std::strncpy(s.name, "(table full)", sizeof(s.name) - 1);
+        return s;
+    }
+    std::strncpy(s.name, name, sizeof(s.name) - 1);
+    return s;
+}
+
+ThreadCount& register_thread(Site& site) {
+    t_flush.counts.push_back(ThreadCount{&site, 0});
+    return t_flush.counts.back();
+}
+
+void finish_first(Site& s, std::uint64_t ns) {
+    std::uint64_t unset = 0;
+    if (s.first_access_ns.compare_exchange_strong(unset, ns ? ns : 1,
+                                                  std::memory_order_relaxed)) {
+        s.first_before_main.store(!startup_report::main_entered(), std::memory_order_relaxed);
+        s.first_done.store(true, std::memory_order_release);
+        return;
+    }
+    // Overlapped the first call: blocked in its call_once / static init guard
+    s.init_waiters.fetch_add(1, std::memory_order_relaxed);
+    s.init_wait_ns.fetch_add(ns, std::memory_order_relaxed);
+}
+
+void note_ctor(const char* type, const char* tag, std::uint64_t ns, bool before_main) {
+    std::lock_guard<std::mutex> lock(g_ctor_mutex);
+    CtorEntry* e = nullptr;
+    for (std::size_t i = 0; i < g_ctor_count && !e; ++i) {
+        if (std::strcmp(g_ctors[i].type, type) == 0 &&
+            std::strncmp(g_ctors[i].tag, tag ? tag : "", sizeof(g_ctors[i].tag) - 1) == 0) {
+            e = &g_ctors[i];
+        }
+    }
+    if (!e) {
+        if (g_ctor_count == kMaxCtors) {
+            ++g_ctor_overflow;
+            return;
+        }
+        e = &g_ctors[g_ctor_count++];
+        e->type = type;
+        std::strncpy(e->tag, tag ? tag : "", sizeof(e->tag) - 1);
+    }
+    ++e->count;
+    e->total_ns += ns;
+    e->max_ns = ns > e->max_ns ? ns : e->max_ns;
+    e->before_main += before_main ? 1 : 0;
+}
+
+std::size_t sites(SiteStats* out, std::size_t max) {
+    std::size_t count = g_site_count.load(std::memory_order_acquire);
+    count = count < kMaxSites ? count : kMaxSites;
+    for (std::size_t i = 0; i < count && i < max; ++i) {
+        const Site& s = g_sites[i];
+        out[i] = SiteStats{s.name,
+                           s.accesses.load(std::memory_order_relaxed),
+                           s.first_access_ns.load(std::memory_order_relaxed),
+                           s.first_before_main.load(std::memory_order_relaxed),
+                           s.init_waiters.load(std::memory_order_relaxed),
+                           s.init_wait_ns.load(std::memory_order_relaxed)};
+    }
+    return count;
+}
+
+std::size_t ctors(CtorStats* out, std::size_t max) {
+    std::lock_guard<std::mutex> lock(g_ctor_mutex);
+    for (std::size_t i = 0; i < g_ctor_count && i < max; ++i) {
+        const CtorEntry& e = g_ctors[i];
+        out[i] = CtorStats{e.type, e.tag, e.count, e.total_ns, e.max_ns, e.before_main};
+    }
+    return g_ctor_count;
+}
+
+void print() {
+    SiteStats s[kMaxSites];
+    std::size_t n = sites(s, kMaxSites);
+    std::fprintf(stderr, "\n=== Singleton Instrumentation: accessors ===\n");
+    std::fprintf(stderr, "  %-40s %12s %12s %8s %12s\n", "site", "accesses", "first(us)",
+                 "waiters", "wait(us)");
+    for (std::size_t i = 0; i < n; ++i) {
+        std::fprintf(stderr, "  %-40s %12llu %12.3f %8u %12.3f%s\n", s[i].name,
+                     static_cast<unsigned long long>(s[i].accesses),
+                     static_cast<double>(s[i].first_access_ns) / 1000.0, s[i].init_waiters,
+                     static_cast<double>(s[i].init_wait_ns) / 1000.0,
+                     s[i].first_before_main ? "  (before main)" : "");
+    }
+    std::uint64_t lost = g_site_count.load() > kMaxSites ? g_site_count.load() - kMaxSites : 0;
+    if (lost) {
+        std::fprintf(stderr, "  (%llu site(s) merged into \"(table full)\", not shown)\n",
+                     static_cast<unsigned long long>(lost));
+    }
+
+    CtorStats c[kMaxCtors];
+    std::size_t m = ctors(c, kMaxCtors);
+    std::fprintf(stderr, "\n=== Singleton Instrumentation: constructors ===\n");
+    std::fprintf(stderr, "  %-14s %-16s %8s %12s %12s %12s\n", "type", "tag", "count",
+                 "total(us)", "max(us)", "before main");
+    for (std::size_t i = 0; i < m; ++i) {
+        std::fprintf(stderr, "  %-14s %-16s %8llu %12.3f %12.3f %12llu\n", c[i].type, c[i].tag,
+                     static_cast<unsigned long long>(c[i].count),
+                     static_cast<double>(c[i].total_ns) / 1000.0,
+                     static_cast<double>(c[i].max_ns) / 1000.0,
+                     static_cast<unsigned long long>(c[i].before_main));
+    }
+    std::lock_guard<std::mutex> lock(g_ctor_mutex);
+    if (g_ctor_overflow) {
+        std::fprintf(stderr, "  (%llu ctor(s) not recorded: table full)\n",
+                     static_cast<unsigned long long>(g_ctor_overflow));
+    }
+}
+
+}  // namespace singleton_instrument
@@ -0,0 +1,406 @@
+// libsingleton_startup_audit.so: exec-to-main() profile of the dynamic
+// loader and the singleton constructors it runs
+//
+// Usage: LD_AUDIT=<build>/lib/libsingleton_startup_audit.so ./bin/<demo>
+//        SINGLETON_STARTUP_FOLDED=<file>  also write folded stacks (flamegraph.pl)
+//
+// An rtld-audit module rather than an LD_PRELOAD library: preloaded code
+// first runs after every object is mapped and relocated, the audit hooks run
+// inside the loader.
+//   la_objopen     - each object as it is mapped (load time = gap since the
+//                    previous one); relocation counts from its dynamic section;
+//                    DT_INIT_ARRAY is pointed at timing thunks, so each
+//                    object's init-array run is timed; relocation is the gap
+//                    from the last object mapped to the first init
+//   la_symbind64   - calls to startup_report::record() (every CtorTimer) and
+//                    startup_report::mark_main() are routed through wrappers:
+//                    ctors nest under the init-array run they happen in, and
+//                    mark_main() (first thing in each demo's main()) prints
+//                    the summary
+//
+// The loader relocates all objects in one pass without a per-object hook,
+// so relocation time is a total; the per-object rows show relocation counts.
+//
+// Runs in the auditor's own link-map namespace with its own libc: no C++
+// runtime, no allocation.
+#include <elf.h>
+#include <link.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr int kMaxObjects = 64;
+constexpr int kMaxThunks = 512;
+constexpr int kMaxCtors = 128;
+
+std::uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+struct Object {
+    const char* name;
+    link_map* map;
+    std::uint64_t mapped_ns;  // la_objopen
+    std::uint64_t load_ns;    // Since the previous object was mapped
+    std::uint64_t relocs;     // DT_RELA + DT_JMPREL entries (+ DT_RELR words)
+    std::uint64_t relative;   // DT_RELACOUNT
+    std::uint64_t plt;
+    std::uint64_t bindings;   // la_symbind64 calls from this object
+    std::uint64_t init_ns;
+    int init_entries;
+};
+
+struct Ctor {
+    const char* type;
+    char tag[32];
+    std::uint64_t ns;
+    int object;  // Whose init-array run it happened in, -1 = none
+};
+
+using InitFn = void (*)(int, char**, char**);
+
+struct Thunk {
+    InitFn* slot;  // The original (relocated) DT_INIT_ARRAY entry
+    int object;
+};
+
+Object g_objects[kMaxObjects];
+int g_object_count = 0;
+Thunk g_thunks[kMaxThunks];
+InitFn g_init_table[kMaxThunks];  // What the loader now calls
+int g_thunk_count = 0;
+Ctor g_ctors[kMaxCtors];
+int g_ctor_count = 0;
+int g_current_init = -1;
+
+std::uint64_t g_start_ns;
+std::uint64_t g_init_start_ns;  // First init-array entry: relocation is done
+bool g_reported = false;
+
+using RecordFn = void (*)(const char*, const char*, const void*, std::uint64_t);
+using MarkMainFn = void (*)();
+RecordFn g_record;
+MarkMainFn g_mark_main;
+
+const char* base_name(const char* path) {
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+double ms(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+// ---------------------------------------------------------------------------
+// Init-array thunks: thunk<I> runs g_thunks[I] and charges it to its object
+// ---------------------------------------------------------------------------
+
+template <int I>
+void thunk(int argc, char** argv, char** envp) {
+    const Thunk& t = g_thunks[I];
+    int outer = g_current_init;
+    g_current_init = t.object;
+    std::uint64_t t0 = now_ns();
+    if (g_init_start_ns == 0) {
+        g_init_start_ns = t0;
+    }
+    InitFn fn = *t.slot;
+    // 0 / -1 are terminators some toolchains leave in place
+    if (fn && reinterpret_cast<std::intptr_t>(fn) != -1) {
+        fn(argc, argv, envp);
+    }
+    std::uint64_t t1 = now_ns();
+    g_objects[t.object].init_ns += t1 - t0;
+    g_current_init = outer;
+}
+
+template <int... I>
+constexpr auto make_thunks(std::integer_sequence<int, I...>) {
+    struct Table {
+        InitFn fn[sizeof...(I)];
+    };
+    return Table{{&thunk<I>...}};
+}
+
+constexpr auto kThunks = make_thunks(std::make_integer_sequence<int, kMaxThunks>{});
+
+// Point the object's DT_INIT_ARRAY at a table of thunks. Done at
+// la_objopen, before relocation: the loader reads d_ptr when it runs the
+// inits (and libc does, for the main program), while the original slots
+// still get relocated in place and are read by the thunks when they run.
+void wrap_init_array(int object) {
+    link_map* map = g_objects[object].map;
+    ElfW(Dyn)* array = nullptr;
+    std::size_t size = 0;
+    for (ElfW(Dyn)* d = map->l_ld; d->d_tag != DT_NULL; ++d) {
+        if (d->d_tag == DT_INIT_ARRAY) {
+            array = d;
+        } else if (d->d_tag == DT_INIT_ARRAYSZ) {
+            size = d->d_un.d_val;
+        }
+    }
+    int count = static_cast<int>(size / sizeof(void*));
+    if (!array || count == 0 || g_thunk_count + count > kMaxThunks) {
+        return;
+    }
+    auto* slots = reinterpret_cast<InitFn*>(map->l_addr + array->d_un.d_ptr);
+    int first = g_thunk_count;
+    for (int i = 0; i < count; ++i) {
+        g_thunks[g_thunk_count] = Thunk{&slots[i], object};
+        g_init_table[g_thunk_count] = kThunks.fn[g_thunk_count];
+        ++g_thunk_count;
+    }
+    array->d_un.d_ptr = reinterpret_cast<std::uintptr_t>(&g_init_table[first]) - map->l_addr;
+    g_objects[object].init_entries = count;
+}
+
+// ---------------------------------------------------------------------------
+// Wrappers for the startup_report entry points (installed by la_symbind64)
+// ---------------------------------------------------------------------------
+
+void report();
+
+void record_wrapper(const char* type, const char* tag, const void* obj, std::uint64_t ns) {
+    if (!g_reported && g_ctor_count < kMaxCtors) {
+        Ctor& c = g_ctors[g_ctor_count++];
+        c.type = type;
+        std::snprintf(c.tag, sizeof(c.tag), "%s", tag ? tag : "");
+        c.ns = ns;
+        c.object = g_current_init;
+    }
+    g_record(type, tag, obj, ns);
+}
+
+void mark_main_wrapper() {
+    report();
+    g_mark_main();
+}
+
+// ---------------------------------------------------------------------------
+// Summary
+// ---------------------------------------------------------------------------
+
+std::uint64_t init_total_ns() {
+    std::uint64_t total = 0;
+    for (int i = 0; i < g_object_count; ++i) {
+        total += g_objects[i].init_ns;
+    }
+    return total;
+}
+
+std::uint64_t mapped_ns() {
+    return g_object_count ? g_objects[g_object_count - 1].mapped_ns : g_start_ns;
+}
+
+// Last object mapped -> the first init-array entry runs
+std::uint64_t relocate_ns() {
+    return g_init_start_ns > mapped_ns() ? g_init_start_ns - mapped_ns() : 0;
+}
+
+// DT_INIT functions, libc's own start-up, the gaps between inits
+std::uint64_t other_ns(std::uint64_t main_ns) {
+    std::uint64_t from = g_init_start_ns ? g_init_start_ns : mapped_ns();
+    std::uint64_t init = init_total_ns();
+    return main_ns > from + init ? main_ns - from - init : 0;
+}
+
+// Folded stacks: one "frame;frame;frame value" line per leaf, value in us
+void write_folded(const char* path, std::uint64_t main_ns) {
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) {
+        return;
+    }
+    auto us = [](std::uint64_t ns) { return static_cast<unsigned long long>(ns / 1000); };
+    for (int i = 0; i < g_object_count; ++i) {
+        std::fprintf(f, "startup;load;%s %llu\n", g_objects[i].name, us(g_objects[i].load_ns));
+    }
+    std::fprintf(f, "startup;relocate %llu\n", us(relocate_ns()));
+    for (int i = 0; i < g_object_count; ++i) {
+        if (g_objects[i].init_entries == 0) {
+            continue;
+        }
+        std::uint64_t ctor_ns = 0;
+        for (int c = 0; c < g_ctor_count; ++c) {
+            if (g_ctors[c].object == i) {
+                std::fprintf(f, "startup;init;%s;%s%s%s %llu\n", g_objects[i].name,
+                             g_ctors[c].type, g_ctors[c].tag[0] ? "/" : "", g_ctors[c].tag,
+                             us(g_ctors[c].ns));
+                ctor_ns += g_ctors[c].ns;
+            }
+        }
+        std::uint64_t self = g_objects[i].init_ns > ctor_ns ? g_objects[i].init_ns - ctor_ns : 0;
+        std::fprintf(f, "startup;init;%s %llu\n", g_objects[i].name, us(self));
+    }
+    std::fprintf(f, "startup;other %llu\n", us(other_ns(main_ns)));
+    std::fclose(f);
+}
+
+void report() {
+    if (g_reported || g_start_ns == 0) {
+        return;
+    }
+    g_reported = true;
+    std::uint64_t main_ns = now_ns();
+    std::uint64_t relocs = 0;
+    for (int i = 0; i < g_object_count; ++i) {
+        relocs += g_objects[i].relocs;
+    }
+
+    std::fprintf(stderr, "\n=== Startup Profile (LD_AUDIT) ===\n");
+    std::fprintf(stderr, "audit start -> main()          %9.3f ms\n", ms(main_ns - g_start_ns));
+    std::fprintf(stderr, "  load     (%2d objects)        %9.3f ms\n", g_object_count,
+                 ms(mapped_ns() - g_start_ns));
+    for (int i = 0; i < g_object_count; ++i) {
+        std::fprintf(stderr, "    %-28s%9.3f ms\n", g_objects[i].name, ms(g_objects[i].load_ns));
+    }
+    std::fprintf(stderr, "  relocate (%6llu relocs)     %9.3f ms\n",
+                 static_cast<unsigned long long>(relocs), ms(relocate_ns()));
+    for (int i = 0; i < g_object_count; ++i) {
+        const Object& o = g_objects[i];
+        std::fprintf(stderr, "    %-28s%6llu relocs (%llu relative, %llu PLT), %llu bound\n", o.name,
+                     static_cast<unsigned long long>(o.relocs),
+                     static_cast<unsigned long long>(o.relative),
+                     static_cast<unsigned long long>(o.plt),
+                     static_cast<unsigned long long>(o.bindings));
+    }
+    std::fprintf(stderr, "  init     (init arrays)       %9.3f ms\n", ms(init_total_ns()));
+    for (int i = 0; i < g_object_count; ++i) {
+        const Object& o = g_objects[i];
+        if (o.init_entries == 0) {
+            continue;
+        }
+        std::fprintf(stderr, "    %-28s%9.3f ms  (%d entr%s)\n", o.name, ms(o.init_ns),
+                     o.init_entries, o.init_entries == 1 ? "y" : "ies");
+        for (int c = 0; c < g_ctor_count; ++c) {
+            if (g_ctors[c].object == i) {
+                std::fprintf(stderr, "      %-14s %-16s  %9.3f ms\n", g_ctors[c].type,
+                             g_ctors[c].tag, ms(g_ctors[c].ns));
+            }
+        }
+    }
+    for (int c = 0; c < g_ctor_count; ++c) {
+        if (g_ctors[c].object < 0) {
+            std::fprintf(stderr, "    (outside init) %-14s %-16s%9.3f ms\n", g_ctors[c].type,
+                         g_ctors[c].tag, ms(g_ctors[c].ns));
+        }
+    }
+    std::fprintf(stderr, "  other    (DT_INIT, libc start) %8.3f ms\n", ms(other_ns(main_ns)));
+
+    if (const char* path = std::getenv("SINGLETON_STARTUP_FOLDED")) {
+        write_folded(path, main_ns);
+        std::fprintf(stderr, "folded stacks -> %s (flamegraph.pl %s > startup.svg)\n", path, path);
+    }
+}
+
+void count_relocs(Object& o) {
+    std::uint64_t rela = 0;
+    std::uint64_t relaent = sizeof(ElfW(Rela));
+    std::uint64_t pltsz = 0;
+    std::uint64_t relr = 0;
+    std::uintptr_t rela_at = 0;
+    std::uintptr_t jmprel_at = 0;
+    for (ElfW(Dyn)* d = o.map->l_ld; d->d_tag != DT_NULL; ++d) {
+        switch (d->d_tag) {
+        case DT_RELA:
+            rela_at = d->d_un.d_ptr;
+            break;
+        case DT_JMPREL:
+            jmprel_at = d->d_un.d_ptr;
+            break;
+        case DT_RELASZ:
+            rela = d->d_un.d_val;
+            break;
+        case DT_RELAENT:
+            relaent = d->d_un.d_val;
+            break;
+        case DT_PLTRELSZ:
+            pltsz = d->d_un.d_val;
+            break;
+        case DT_RELACOUNT:
+            o.relative = d->d_un.d_val;
+            break;
+#ifdef DT_RELRSZ
+        case DT_RELRSZ:
+            relr = d->d_un.d_val / sizeof(ElfW(Addr));
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+    // Some linkers make DT_RELASZ cover the DT_JMPREL entries too
+    bool overlap = jmprel_at >= rela_at && jmprel_at < rela_at + rela;
+    o.plt = pltsz / relaent;
+    o.relocs = rela / relaent + (overlap ? 0 : o.plt) + relr;
+}
+
+int object_of(uintptr_t cookie) {
+    int idx = static_cast<int>(cookie);
+    return idx >= 0 && idx < g_object_count ? idx : -1;
+}
+
+}  // namespace
+
+extern "C" {
+
+unsigned int la_version(unsigned int version) {
+    g_start_ns = now_ns();
+    return version < LAV_CURRENT ? version : LAV_CURRENT;
+}
+
+unsigned int la_objopen(link_map* map, Lmid_t lmid, uintptr_t* cookie) {
+    std::uint64_t t = now_ns();
+    if (lmid != LM_ID_BASE || g_object_count == kMaxObjects) {
+        return 0;
+    }
+    int idx = g_object_count++;
+    Object& o = g_objects[idx];
+    o.map = map;
+    o.name = map->l_name && map->l_name[0] ? base_name(map->l_name) : "(main program)";
+    o.mapped_ns = t;
+    o.load_ns = t - (idx ? g_objects[idx - 1].mapped_ns : g_start_ns);
+    count_relocs(o);
+    // ld.so and the vDSO are not initialized through DT_INIT_ARRAY
+    if (std::strncmp(o.name, "ld-linux", 8) != 0 && std::strncmp(o.name, "linux-vdso", 10) != 0) {
+        wrap_init_array(idx);
+    }
+    *cookie = static_cast<uintptr_t>(idx);
+    return LA_FLG_BINDTO | LA_FLG_BINDFROM;
+}
+
+uintptr_t la_symbind64(Elf64_Sym* sym, unsigned int, uintptr_t* refcook, uintptr_t*,
+                       unsigned int*, const char* symname) {
+    int from = object_of(*refcook);
+    if (from >= 0) {
+        ++g_objects[from].bindings;
+    }
+    if (std::strcmp(symname, "_ZN14startup_report6recordEPKcS1_PKvm") == 0) {
+        g_record = reinterpret_cast<RecordFn>(sym->st_value);
+        return reinterpret_cast<uintptr_t>(&record_wrapper);
+    }
+    if (std::strcmp(symname, "_ZN14startup_report9mark_mainEv") == 0) {
+        g_mark_main = reinterpret_cast<MarkMainFn>(sym->st_value);
+        return reinterpret_cast<uintptr_t>(&mark_main_wrapper);
+    }
+    return sym->st_value;
+}
+
+// Programs that never call mark_main(): report when the main program closes
+unsigned int la_objclose(uintptr_t* cookie) {
+    if (object_of(*cookie) == 0) {
+        report();
+    }
+    return 0;
+}
+
+}  // extern "C"
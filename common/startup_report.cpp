@@ -0,0 +1,88 @@
+#include "startup_report.hpp"
+#include "singleton_instrument.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace startup_report {
+namespace {
+
+struct Entry {
+    const char* type;
+    const char* tag;
+    const void* obj;
+    std::uint64_t ns;
+    bool before_main;
+};
+
+constexpr int kMaxEntries = 128;
+
+// Constant-initialized: usable from any constructor, in any DSO, at any time
+Entry g_entries[kMaxEntries];
+std::atomic<int> g_count{0};
+std::atomic<int> g_overflow{0};
+std::atomic<bool> g_main_entered{false};
+
+}  // namespace
+
+void record(const char* type, const char* tag, const void* obj, std::uint64_t ns) {
+    bool before_main = !g_main_entered.load(std::memory_order_relaxed);
+    singleton_instrument::note_ctor(type, tag, ns, before_main);
+    int idx = g_count.fetch_add(1, std::memory_order_relaxed);
+    if (idx >= kMaxEntries) {
+        g_overflow.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    g_entries[idx] = Entry{type, tag, obj, ns, before_main};
+}
+
+void mark_main() {
+    g_main_entered.store(true, std::memory_order_relaxed);
+    // at_quick_exit too: fast_exit::finish() skips the atexit handlers
+    if (std::getenv("SINGLETON_STARTUP_REPORT")) {
+        std::atexit(print);
+        std::at_quick_exit(print);
+    }
+    if (std::getenv("SINGLETON_INSTRUMENT_REPORT")) {
+        std::atexit(singleton_instrument::print);
+        std::at_quick_exit(singleton_instrument::print);
+    }
+}
+
+bool main_entered() {
+    return g_main_entered.load(std::memory_order_relaxed);
+}
+
+void print() {
+    int count = g_count.load();
+    if (count > kMaxEntries) {
+        count = kMaxEntries;
+    }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        bool before = (pass == 0);
+        int n = 0;
+        std::uint64_t total = 0;
+        std::fprintf(stderr, "\n=== Startup Report: singleton ctors %s main() ===\n",
+                     before ? "BEFORE" : "AFTER");
+        for (int i = 0; i < count; ++i) {
+            const Entry& e = g_entries[i];
+            if (e.before_main != before) {
+                continue;
+            }
+            ++n;
+            total += e.ns;
+            std::fprintf(stderr, "  %-14s %-16s @%p  %8.3f us\n", e.type,
+                         e.tag ? e.tag : "", e.obj, static_cast<double>(e.ns) / 1000.0);
+        }
+        std::fprintf(stderr, "  -> %d ctor(s), %.3f us total\n", n,
+                     static_cast<double>(total) / 1000.0);
+    }
+
+    if (int lost = g_overflow.load()) {
+        std::fprintf(stderr, "  (%d ctor(s) not recorded: table full)\n", lost);
+    }
+}
+
+}  // namespace startup_report
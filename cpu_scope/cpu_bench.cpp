@@ -0,0 +1,236 @@
+// cpu_scope_bench: per-CPU (rseq / getcpu) vs thread_local vs process-wide
+//
+// Usage: cpu_scope_bench [ops_per_thread] [max_threads]
+//   counter  - add(1) on a shared statistic
+//   freelist - pop + push of an object cache entry
+// thread_local is the thread_scope pattern (inline thread_local, as
+// g_thread_logger in thread_logger.hpp; the counter is thread_stats.hpp):
+// cheapest access, but one instance per thread. Per-CPU keeps one per core.
+// thread_logger.hpp itself is not included: GCC's per-TU TLS init would
+// construct a ThreadLogger in every thread that touches any thread_local.
+#include "cpu_local.hpp"
+#include "thread_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Node {
+    Node* next = nullptr;
+    char payload[56];
+};
+
+constexpr int kNodesPerThread = 64;
+
+// --- counter variants ---
+
+alignas(64) std::atomic<std::int64_t> g_atomic{0};
+
+// --- freelist variants ---
+
+struct GlobalFreelist {
+    std::mutex mutex;
+    Node* top = nullptr;
+
+    Node* pop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Node* n = top;
+        if (n) {
+            top = n->next;
+        }
+        return n;
+    }
+    void push(Node* n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        n->next = top;
+        top = n;
+    }
+};
+
+struct ThreadFreelist {
+    Node* top = nullptr;
+};
+inline thread_local ThreadFreelist t_freelist;
+
+template <typename Fn>
+double run(unsigned threads, std::uint64_t ops, Fn fn, std::uint64_t* aborts) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<std::uint64_t> abort_sum{0};
+    std::vector<double> ns(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            std::uint64_t before = cpu_scope::t_rseq_aborts;
+            auto t0 = std::chrono::steady_clock::now();
+            fn(ops);
+            auto dt = std::chrono::steady_clock::now() - t0;
+            ns[t] = std::chrono::duration<double, std::nano>(dt).count() / static_cast<double>(ops);
+            abort_sum.fetch_add(cpu_scope::t_rseq_aborts - before);
+        });
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) {
+        th.join();
+    }
+    if (aborts) {
+        *aborts += abort_sum.load();
+    }
+    return *std::max_element(ns.begin(), ns.end());
+}
+
+template <typename Fn>
+void row(const char* name, const std::vector<unsigned>& counts, std::uint64_t ops, Fn fn,
+         const char* memory) {
+    std::uint64_t aborts = 0;
+    std::cout << std::left << std::setw(22) << name << std::right;
+    for (unsigned t : counts) {
+        std::cout << std::setw(10) << run(t, ops, fn, &aborts);
+    }
+    std::cout << std::setw(10) << aborts << "   " << memory << "\n";
+}
+
+void header(const char* title, const std::vector<unsigned>& counts) {
+    std::cout << "\n" << title << " (ns/op, slowest thread)\n";
+    std::cout << std::left << std::setw(22) << "variant" << std::right;
+    for (unsigned t : counts) {
+        std::cout << std::setw(9) << t << "T";
+    }
+    std::cout << std::setw(10) << "aborts" << "   memory\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000ULL;
+    int cpus = cpu_scope::possible_cpus();
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                    : static_cast<unsigned>(std::max(4, 4 * cpus));
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        counts.push_back(t);
+    }
+    if (counts.back() != max_threads) {
+        counts.push_back(max_threads);
+    }
+
+    std::cout << "=== CPU Scope Benchmark ===\n";
+    std::cout << "cpus=" << cpus << " ops/thread=" << ops << " rseq="
+              << (cpu_scope::g_rseq_available ? "yes" : "no (fallback rows only)") << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    cpu_scope::PerCpuCounter rseq_counter;
+    cpu_scope::PerCpuCounter getcpu_counter(false);
+    std::string per_cpu_mem = std::to_string(64 * cpus) + " B (64 B x cpus)";
+    std::string per_thread_mem = std::to_string(sizeof(thread_stats::Block)) + " B x threads";
+
+    header("counter add", counts);
+    row("atomic fetch_add", counts, ops, [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            g_atomic.fetch_add(1, std::memory_order_relaxed);
+        }
+    }, "64 B");
+    row("thread_local", counts, ops, [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            thread_stats::add(0);
+        }
+    }, per_thread_mem.c_str());
+    if (rseq_counter.uses_rseq()) {
+        row("per-cpu rseq", counts, ops, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                rseq_counter.add(1);
+            }
+        }, per_cpu_mem.c_str());
+    }
+    row("per-cpu getcpu+atomic", counts, ops, [&](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            getcpu_counter.add(1);
+        }
+    }, per_cpu_mem.c_str());
+
+    // Each thread brings kNodesPerThread nodes; an op is one pop + one push
+    GlobalFreelist global;
+    cpu_scope::PerCpuFreelist<Node> rseq_list;
+    cpu_scope::PerCpuFreelist<Node> locked_list(false);
+    std::vector<std::unique_ptr<Node[]>> arenas;
+    std::mutex arenas_mutex;
+    auto make_nodes = [&] {
+        std::lock_guard<std::mutex> lock(arenas_mutex);
+        arenas.emplace_back(new Node[kNodesPerThread]);
+        return arenas.back().get();
+    };
+
+    header("freelist pop+push", counts);
+    row("mutex global", counts, ops / 4, [&](std::uint64_t n) {
+        Node* nodes = make_nodes();
+        for (int i = 0; i < kNodesPerThread; ++i) {
+            global.push(&nodes[i]);
+        }
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Node* x = global.pop();
+            if (x) {
+                global.push(x);
+            }
+        }
+    }, "one list");
+    row("thread_local", counts, ops / 4, [&](std::uint64_t n) {
+        Node* nodes = make_nodes();
+        ThreadFreelist& fl = t_freelist;
+        for (int i = 0; i < kNodesPerThread; ++i) {
+            nodes[i].next = fl.top;
+            fl.top = &nodes[i];
+        }
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Node* x = fl.top;
+            fl.top = x->next;
+            asm volatile("" : : "r"(x) : "memory");
+            x->next = fl.top;
+            fl.top = x;
+        }
+    }, "list x threads (cached objects stranded per thread)");
+    auto per_cpu_loop = [](cpu_scope::PerCpuFreelist<Node>& list, Node* nodes, std::uint64_t n) {
+        for (int i = 0; i < kNodesPerThread; ++i) {
+            list.push(&nodes[i]);
+        }
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Node* x = list.pop();
+            if (x) {
+                list.push(x);
+            }
+        }
+    };
+    if (rseq_list.uses_rseq()) {
+        row("per-cpu rseq", counts, ops / 4, [&](std::uint64_t n) {
+            per_cpu_loop(rseq_list, make_nodes(), n);
+        }, "list x cpus");
+    }
+    row("per-cpu getcpu+spinlock", counts, ops / 4, [&](std::uint64_t n) {
+        per_cpu_loop(locked_list, make_nodes(), n);
+    }, "list x cpus");
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "thread_local: fastest access, but instances (and cached objects) grow with threads\n";
+    std::cout << "per-cpu rseq: no lock prefix; the kernel restarts a sequence interrupted by\n";
+    std::cout << "preemption or migration (aborts column), so threads > cpus stays correct\n";
+    std::cout << "getcpu fallback: same layout, but an atomic or a lock guards each slot\n";
+    std::cout << "threads > cpus time-share a core, so every row grows with the thread count there\n";
+    std::cout << "counter total check: rseq " << rseq_counter.total() << ", getcpu "
+              << getcpu_counter.total() << " (each = sum of ops over all rows' threads)\n";
+    return 0;
+}
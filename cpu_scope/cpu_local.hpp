@@ -0,0 +1,182 @@
+#pragma once
+#include "rseq_ops.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Per-CPU scope: one instance per possible CPU instead of one per thread
+// (thread_scope) or one per process. Memory scales with cores, not with
+// threads, and no two cores write the same cache line.
+namespace cpu_scope {
+
+// One T per possible CPU id, each on its own cache line(s)
+template <typename T>
+class CpuLocal {
+public:
+    CpuLocal() : count_(cpu_id_limit()), slots_(new Slot[static_cast<std::size_t>(count_)]) {}
+
+    CpuLocal(const CpuLocal&) = delete;
+    CpuLocal& operator=(const CpuLocal&) = delete;
+
+    // Indexed by CPU id, 0 .. highest possible id (one slot per id: two CPUs
+    // on one slot would lose the rseq path's plain stores)
+    int size() const { return count_; }
+
+    T& on_cpu(int cpu) {
+        assert(cpu >= 0 && cpu < count_);
+        return slots_[static_cast<std::size_t>(cpu)].value;
+    }
+    const T& on_cpu(int cpu) const {
+        assert(cpu >= 0 && cpu < count_);
+        return slots_[static_cast<std::size_t>(cpu)].value;
+    }
+
+    // The slot of the CPU we are on. Only safe to modify inside an rseq
+    // sequence or with the slot's own synchronization: the thread can be
+    // migrated between the lookup and the write.
+    T& current() { return on_cpu(current_cpu()); }
+
+private:
+    struct alignas(64) Slot {
+        T value{};
+    };
+
+    int count_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// Counter sharded per CPU: add() is a plain add on the local core's line,
+// total() sums all CPUs
+class PerCpuCounter {
+public:
+    // allow_rseq = false forces the getcpu fallback (for comparison)
+    explicit PerCpuCounter(bool allow_rseq = true) : use_rseq_(allow_rseq && g_rseq_available) {}
+
+    bool uses_rseq() const { return use_rseq_; }
+
+    void add(std::int64_t n = 1) {
+#if CPU_SCOPE_HAVE_RSEQ
+        if (use_rseq_) {
+            for (;;) {
+                int cpu = rseq_cpu();
+                if (rseq_add(&cells_.on_cpu(cpu).value, n, cpu)) {
+                    return;
+                }
+                ++t_rseq_aborts;
+            }
+        }
+#endif
+        // Fallback: another thread may be on this CPU's slot after a
+        // migration, so it takes a (mostly uncontended, core-local) atomic add
+        int cpu = sched_getcpu();
+        auto* cell = reinterpret_cast<std::atomic<std::intptr_t>*>(
+            &cells_.on_cpu(cpu < 0 ? 0 : cpu).value);
+        cell->fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Exact once writers are quiescent; a close lower bound while they run
+    std::int64_t total() const {
+        std::int64_t sum = 0;
+        for (int cpu = 0; cpu < cells_.size(); ++cpu) {
+            sum += __atomic_load_n(&cells_.on_cpu(cpu).value, __ATOMIC_RELAXED);
+        }
+        return sum;
+    }
+
+    std::int64_t on_cpu(int cpu) const {
+        return __atomic_load_n(&cells_.on_cpu(cpu).value, __ATOMIC_RELAXED);
+    }
+    int cpus() const { return cells_.size(); }
+
+private:
+    struct Cell {
+        std::intptr_t value;
+    };
+    bool use_rseq_;
+    CpuLocal<Cell> cells_;
+};
+
+// Intrusive free list sharded per CPU (pools, object caches). `Node` needs
+// a `Node* next` member. Push and pop touch only the current CPU's list;
+// an object freed on another CPU simply joins that CPU's list.
+template <typename Node>
+class PerCpuFreelist {
+public:
+    // allow_rseq = false forces the getcpu + spinlock fallback
+    explicit PerCpuFreelist(bool allow_rseq = true) : use_rseq_(allow_rseq && g_rseq_available) {}
+
+    bool uses_rseq() const { return use_rseq_; }
+
+    void push(Node* node) {
+#if CPU_SCOPE_HAVE_RSEQ
+        if (use_rseq_) {
+            for (;;) {
+                int cpu = rseq_cpu();
+                Head& h = heads_.on_cpu(cpu);
+                node->next = reinterpret_cast<Node*>(h.top);
+                int r = rseq_cmpeq_store(&h.top, reinterpret_cast<std::intptr_t>(node->next),
+                                         reinterpret_cast<std::intptr_t>(node), cpu);
+                if (r == 0) {
+                    return;
+                }
+                if (r < 0) {
+                    ++t_rseq_aborts;
+                }
+            }
+        }
+#endif
+        Head& h = locked_head();
+        node->next = reinterpret_cast<Node*>(h.top);
+        h.top = reinterpret_cast<std::intptr_t>(node);
+        h.lock.clear(std::memory_order_release);
+    }
+
+    // nullptr if the current CPU's list is empty (callers then allocate)
+    Node* pop() {
+#if CPU_SCOPE_HAVE_RSEQ
+        if (use_rseq_) {
+            for (;;) {
+                int cpu = rseq_cpu();
+                std::intptr_t out = 0;
+                int r = rseq_pop(&heads_.on_cpu(cpu).top,
+                                 static_cast<std::ptrdiff_t>(offsetof(Node, next)), &out, cpu);
+                if (r >= 0) {
+                    return r == 0 ? reinterpret_cast<Node*>(out) : nullptr;
+                }
+                ++t_rseq_aborts;
+            }
+        }
+#endif
+        Head& h = locked_head();
+        auto* node = reinterpret_cast<Node*>(h.top);
+        if (node) {
+            h.top = reinterpret_cast<std::intptr_t>(node->next);
+        }
+        h.lock.clear(std::memory_order_release);
+        return node;
+    }
+
+private:
+    struct Head {
+        std::intptr_t top = 0;  // Node*, as an integer for the rseq ops
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;  // getcpu fallback only
+    };
+
+    // Fallback: the slot of the CPU we think we are on, spin-locked
+    Head& locked_head() {
+        int cpu = sched_getcpu();
+        Head& h = heads_.on_cpu(cpu < 0 ? 0 : cpu);
+        while (h.lock.test_and_set(std::memory_order_acquire)) {
+            sched_yield();
+        }
+        return h;
+    }
+
+    bool use_rseq_;
+    CpuLocal<Head> heads_;
+};
+
+}  // namespace cpu_scope
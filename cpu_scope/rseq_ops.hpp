@@ -0,0 +1,183 @@
+#pragma once
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Restartable sequences: a short instruction range the kernel restarts
+// (jumps to an abort handler) if the thread is preempted, migrated or
+// signalled inside it. A sequence that checks "still on CPU n" and ends in
+// a single committing store updates per-CPU data with no lock prefix.
+//
+// glibc (2.35+) registers an rseq area for every thread; we only use it.
+// Without it (old kernel or glibc, glibc.pthread.rseq=0, non-x86-64) every
+// caller takes the getcpu() fallback instead.
+#if defined(__x86_64__) && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define CPU_SCOPE_HAVE_RSEQ 1
+#else
+#define CPU_SCOPE_HAVE_RSEQ 0
+#endif
+
+namespace cpu_scope {
+
+inline int possible_cpus() {
+    long n = sysconf(_SC_NPROCESSORS_CONF);
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+// Highest possible CPU id + 1, from /sys/devices/system/cpu/possible
+// ("0-3,8-11"). Not possible_cpus(): ids can be sparse, and the kernel
+// reports ids (rseq cpu_id, sched_getcpu) that per-CPU tables index directly
+inline int cpu_id_limit() {
+    int limit = 0;
+    if (std::FILE* f = std::fopen("/sys/devices/system/cpu/possible", "r")) {
+        char buf[256] = {};
+        std::size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+        std::fclose(f);
+        buf[n] = '\0';
+        for (char* p = buf; *p >= '0' && *p <= '9';) {
+            long first = std::strtol(p, &p, 10);
+            long last = *p == '-' ? std::strtol(p + 1, &p, 10) : first;
+            limit = std::max(limit, static_cast<int>(std::max(first, last)) + 1);
+            if (*p != ',') {
+                break;
+            }
+            ++p;
+        }
+    }
+    return std::max(limit, possible_cpus());
+}
+
+// Aborted sequences on this thread (each one was retried)
+inline thread_local std::uint64_t t_rseq_aborts = 0;
+
+#if CPU_SCOPE_HAVE_RSEQ
+
+static_assert(offsetof(struct rseq, cpu_id) == 4 && offsetof(struct rseq, rseq_cs) == 8,
+              "offsets used by the asm below");
+
+inline struct rseq* rseq_area() {
+    return reinterpret_cast<struct rseq*>(static_cast<char*>(__builtin_thread_pointer()) +
+                                          __rseq_offset);
+}
+
+inline bool detect_rseq() {
+    return __rseq_size > 0 && static_cast<std::int32_t>(rseq_area()->cpu_id) >= 0;
+}
+
+inline const bool g_rseq_available = detect_rseq();
+
+// CPU the kernel last scheduled us on: a plain load from the rseq area
+inline int rseq_cpu() {
+    return static_cast<int>(*static_cast<volatile std::uint32_t*>(&rseq_area()->cpu_id));
+}
+
+// Shared framing: descriptor in __rseq_cs, then "1:" start, "2:" end of the
+// committed range, abort handler "4:" preceded by the signature
+#define CPU_SCOPE_RSEQ_BEGIN                                       \
+    ".pushsection __rseq_cs, \"aw\"\n\t"                            \
+    ".balign 32\n\t"                                                \
+    "3:\n\t"                                                        \
+    ".long 0x0, 0x0\n\t"                                            \
+    ".quad 1f, (2f - 1f), 4f\n\t"                                   \
+    ".popsection\n\t"                                               \
+    "leaq 3b(%%rip), %%rax\n\t"                                     \
+    "movq %%rax, 8(%[rs])\n\t"                                      \
+    "1:\n\t"                                                        \
+    "cmpl %[cpu], 4(%[rs])\n\t"                                     \
+    "jnz 4f\n\t"
+
+#define CPU_SCOPE_RSEQ_END                                         \
+    "2:\n\t"                                                        \
+    ".pushsection __rseq_failure, \"ax\"\n\t"                       \
+    ".byte 0x0f, 0xb9, 0x3d\n\t"                                    \
+    ".long 0x53053053\n\t"   /* RSEQ_SIG, encoded as ud1 */          \
+    "4:\n\t"                                                        \
+    "jmp %l[abort]\n\t"                                             \
+    ".popsection\n\t"
+
+// *v += count, committed only if still on `cpu`; false = aborted
+inline bool rseq_add(std::intptr_t* v, std::intptr_t count, int cpu) {
+    __asm__ __volatile__ goto(
+        CPU_SCOPE_RSEQ_BEGIN
+        "addq %[count], (%[v])\n\t"
+        CPU_SCOPE_RSEQ_END
+        :
+        : [rs] "r"(rseq_area()), [cpu] "r"(cpu), [v] "r"(v), [count] "er"(count)
+        : "memory", "cc", "rax"
+        : abort);
+    return true;
+abort:
+    return false;
+}
+
+// if (*v == expect) *v = newv, on `cpu`: 0 = stored, 1 = *v differed, -1 = aborted
+inline int rseq_cmpeq_store(std::intptr_t* v, std::intptr_t expect, std::intptr_t newv, int cpu) {
+    __asm__ __volatile__ goto(
+        CPU_SCOPE_RSEQ_BEGIN
+        "cmpq %[expect], (%[v])\n\t"
+        "jnz %l[differ]\n\t"
+        "movq %[newv], (%[v])\n\t"
+        CPU_SCOPE_RSEQ_END
+        :
+        : [rs] "r"(rseq_area()), [cpu] "r"(cpu), [v] "r"(v), [expect] "r"(expect),
+          [newv] "r"(newv)
+        : "memory", "cc", "rax"
+        : abort, differ);
+    return 0;
+differ:
+    return 1;
+abort:
+    return -1;
+}
+
+// Pop from an intrusive list on `cpu`: head = *v; if null -> 1; else
+// *out = head, *v = *(head + next_offset). 0 = popped, -1 = aborted.
+inline int rseq_pop(std::intptr_t* v, std::ptrdiff_t next_offset, std::intptr_t* out, int cpu) {
+    __asm__ __volatile__ goto(
+        CPU_SCOPE_RSEQ_BEGIN
+        "movq (%[v]), %%rcx\n\t"
+        "testq %%rcx, %%rcx\n\t"
+        "jz %l[empty]\n\t"
+        "movq %%rcx, (%[out])\n\t"
+        "movq (%%rcx, %[off]), %%rcx\n\t"
+        "movq %%rcx, (%[v])\n\t"
+        CPU_SCOPE_RSEQ_END
+        :
+        : [rs] "r"(rseq_area()), [cpu] "r"(cpu), [v] "r"(v), [off] "r"(next_offset),
+          [out] "r"(out)
+        : "memory", "cc", "rax", "rcx"
+        : abort, empty);
+    return 0;
+empty:
+    return 1;
+abort:
+    return -1;
+}
+
+#undef CPU_SCOPE_RSEQ_BEGIN
+#undef CPU_SCOPE_RSEQ_END
+
+#else
+
+inline const bool g_rseq_available = false;
+
+#endif
+
+// Where the calling thread runs now; it may move right after this returns
+inline int current_cpu() {
+#if CPU_SCOPE_HAVE_RSEQ
+    if (g_rseq_available) {
+        return rseq_cpu();
+    }
+#endif
+    int cpu = sched_getcpu();
+    return cpu >= 0 ? cpu : 0;
+}
+
+}  // namespace cpu_scope
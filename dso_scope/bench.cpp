@@ -0,0 +1,182 @@
+// dso_scope_bench: cost of symbol interposition on get_logger() across link modes
+//
+// For each libdso_bench_<mode>.so:
+//   - relocation counts (.rela.dyn / .rela.plt, RELATIVE vs symbolic)
+//   - dynamic-linker time of dlopen(RTLD_NOW), measured in fresh child processes
+//   - per-call latency of bench_get_logger() from inside the plugin
+//
+// Usage: dso_scope_bench [iterations] [load_samples]
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef DSO_BENCH_LIB_DIR
+#define DSO_BENCH_LIB_DIR "."
+#endif
+
+#if defined(__x86_64__)
+constexpr std::uint32_t kRelativeType = R_X86_64_RELATIVE;
+#elif defined(__aarch64__)
+constexpr std::uint32_t kRelativeType = R_AARCH64_RELATIVE;
+#else
+constexpr std::uint32_t kRelativeType = 0;
+#endif
+
+using LoopFn = std::uintptr_t (*)(std::uint64_t);
+
+struct RelocCounts {
+    std::size_t relative = 0;  // Fixed up without a symbol lookup
+    std::size_t symbolic = 0;  // Needs a symbol lookup (.rela.dyn)
+    std::size_t plt = 0;       // JUMP_SLOT entries (.rela.plt)
+};
+
+static RelocCounts count_relocations(const std::string& path) {
+    RelocCounts rc;
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (image.size() < sizeof(Elf64_Ehdr)) {
+        return rc;
+    }
+
+    auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(image.data());
+    auto* shdrs = reinterpret_cast<const Elf64_Shdr*>(image.data() + ehdr->e_shoff);
+    const char* shstr = image.data() + shdrs[ehdr->e_shstrndx].sh_offset;
+    for (int i = 0; i < ehdr->e_shnum; ++i) {
+        if (shdrs[i].sh_type != SHT_RELA) {
+            continue;
+        }
+        auto* rela = reinterpret_cast<const Elf64_Rela*>(image.data() + shdrs[i].sh_offset);
+        std::size_t n = shdrs[i].sh_size / sizeof(Elf64_Rela);
+        bool is_plt = std::strcmp(shstr + shdrs[i].sh_name, ".rela.plt") == 0;
+        for (std::size_t r = 0; r < n; ++r) {
+            if (is_plt) {
+                ++rc.plt;
+            } else if (ELF64_R_TYPE(rela[r].r_info) == kRelativeType) {
+                ++rc.relative;
+            } else {
+                ++rc.symbolic;
+            }
+        }
+    }
+    return rc;
+}
+
+// dlopen in a fresh child so every sample pays the full load + relocation cost
+static double median_load_us(const std::string& path, int samples) {
+    std::vector<double> us;
+    for (int s = 0; s < samples; ++s) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            int devnull = open("/dev/null", O_WRONLY);
+            dup2(devnull, STDOUT_FILENO);  // Silence "Logger ctor" lines
+            auto start = std::chrono::steady_clock::now();
+            void* h = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+            double t = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            if (!h) {
+                t = -1;
+            }
+            ssize_t ignored = write(fds[1], &t, sizeof(t));
+            (void)ignored;
+            _exit(0);
+        }
+        close(fds[1]);
+        double t = -1;
+        if (read(fds[0], &t, sizeof(t)) == sizeof(t) && t >= 0) {
+            us.push_back(t);
+        }
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+    }
+    if (us.empty()) {
+        return -1;
+    }
+    std::sort(us.begin(), us.end());
+    return us[us.size() / 2];
+}
+
+static double ns_per_call(LoopFn loop, std::uint64_t iters) {
+    loop(iters / 10);  // Warm up: bind the PLT slot, fault in pages
+    auto start = std::chrono::steady_clock::now();
+    std::uintptr_t sum = loop(iters);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    asm volatile("" : : "r"(sum));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000ULL;
+    int samples = argc > 2 ? std::atoi(argv[2]) : 21;
+
+    const char* modes[] = {
+        "hidden", "default", "noplt", "bsymbolic", "bsymbolic_functions", "protected",
+    };
+
+    std::cout << "=== DSO Scope Link-Mode Benchmark ===\n";
+    std::cout << "iterations=" << iters << " load_samples=" << samples << "\n\n";
+    std::cout << std::left << std::setw(21) << "mode" << std::right
+              << std::setw(10) << "RELATIVE" << std::setw(10) << "symbolic"
+              << std::setw(8) << "PLT" << std::setw(12) << "load(us)"
+              << std::setw(12) << "ns/call" << "\n";
+
+    // Warm the page cache and ld.so so the first mode is not penalized
+    median_load_us(std::string(DSO_BENCH_LIB_DIR) + "/libdso_bench_hidden.so", 3);
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const char* mode : modes) {
+        std::string path = std::string(DSO_BENCH_LIB_DIR) + "/libdso_bench_" + mode + ".so";
+        RelocCounts rc = count_relocations(path);
+        double load = median_load_us(path, samples);
+
+        // Keep "Logger ctor" lines out of the table
+        std::cout.flush();
+        int saved_stdout = dup(STDOUT_FILENO);
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        void* h = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        std::cout.flush();
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        close(devnull);
+        if (!h) {
+            std::cerr << "dlopen failed: " << dlerror() << "\n";
+            return 1;
+        }
+        auto loop = reinterpret_cast<LoopFn>(dlsym(h, "bench_plugin_loop"));
+        double ns = loop ? ns_per_call(loop, iters) : -1;
+
+        std::cout << std::left << std::setw(21) << mode << std::right
+                  << std::setw(10) << rc.relative << std::setw(10) << rc.symbolic
+                  << std::setw(8) << rc.plt << std::setw(12) << load
+                  << std::setw(12) << ns << "\n";
+    }
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "default: call via PLT + g_logger via GOT (interposable)\n";
+    std::cout << "noplt:   call *GOT directly, no PLT stub\n";
+    std::cout << "hidden/protected/bsymbolic*: bound inside the DSO at link time\n";
+    std::cout << "load(us): median dlopen(RTLD_NOW) time in a fresh child process\n";
+    std::cout << "Note: exported inline g_logger is STB_GNU_UNIQUE, so default-visibility\n";
+    std::cout << "      modes loaded later bind to the first one's instance even with RTLD_LOCAL\n";
+
+    return 0;
+}
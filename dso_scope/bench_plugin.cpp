@@ -0,0 +1,19 @@
+// Built once per link mode by the dso_scope_bench matrix (see CMakeLists.txt)
+#include "logger.hpp"
+#include <cstdint>
+
+// Out-of-line accessor. With default visibility it is interposable, so calls
+// from inside this DSO go through the PLT and g_logger is reached via the GOT.
+// hidden/protected/-Bsymbolic let the call (and data access) bind locally.
+__attribute__((noinline)) Logger& bench_get_logger() {
+    return get_logger();
+}
+
+extern "C" __attribute__((visibility("default"))) std::uintptr_t bench_plugin_loop(std::uint64_t n) {
+    std::uintptr_t sum = 0;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        sum += reinterpret_cast<std::uintptr_t>(&bench_get_logger());
+        asm volatile("" : "+r"(sum));
+    }
+    return sum;
+}
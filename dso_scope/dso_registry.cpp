@@ -0,0 +1,77 @@
+#include "dso_registry.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace dso_registry {
+namespace {
+
+struct Entry {
+    std::atomic<std::uint64_t> key{0};
+    const char* name = nullptr;
+    void* obj = nullptr;
+};
+
+constexpr std::size_t kCapacity = 256;  // Power of two, open addressing
+
+Entry g_table[kCapacity];
+std::mutex g_insert_mutex;
+std::atomic<std::size_t> g_size{0};
+
+// Lock-free probe: a published key always has its obj/name visible
+Entry* find(std::uint64_t key) {
+    for (std::size_t n = 0; n < kCapacity; ++n) {
+        Entry& e = g_table[(key + n) & (kCapacity - 1)];
+        std::uint64_t k = e.key.load(std::memory_order_acquire);
+        if (k == 0) {
+            return nullptr;
+        }
+        if (k == key) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+void* checked(Entry* e, const char* name) {
+    if (std::strcmp(e->name, name) != 0) {
+        std::fprintf(stderr, "[dso_registry] key collision: %s vs %s\n", e->name, name);
+        std::abort();
+    }
+    return e->obj;
+}
+
+}  // namespace
+
+void* acquire(std::uint64_t key, const char* name, CreateFn create) {
+    if (Entry* e = find(key)) {
+        return checked(e, name);
+    }
+
+    std::lock_guard<std::mutex> lock(g_insert_mutex);
+    if (Entry* e = find(key)) {
+        return checked(e, name);
+    }
+
+    for (std::size_t n = 0; n < kCapacity; ++n) {
+        Entry& e = g_table[(key + n) & (kCapacity - 1)];
+        if (e.key.load(std::memory_order_relaxed) == 0) {
+            e.obj = create();
+            e.name = name;
+            e.key.store(key, std::memory_order_release);
+            g_size.fetch_add(1, std::memory_order_relaxed);
+            return e.obj;
+        }
+    }
+
+    std::fprintf(stderr, "[dso_registry] table full (%zu entries)\n", kCapacity);
+    std::abort();
+}
+
+std::size_t size() {
+    return g_size.load(std::memory_order_relaxed);
+}
+
+}  // namespace dso_registry
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Cross-DSO singleton registry.
+//
+// libdso_registry.so owns one table keyed by a compile-time hash of the type
+// name. Every DSO that calls dso_registry::instance<T>() gets the same object,
+// even when it is built with -fvisibility=hidden. Each DSO caches the resolved
+// pointer in its own (hidden) Slot<T>::cached, so after the first hit an
+// access is one acquire load - no lock, no hash lookup, no PLT call.
+//
+// Instances are never destroyed, and the constructor code lives in whichever
+// DSO asked first: do not dlclose() that DSO while others still use T.
+#define DSO_REGISTRY_API __attribute__((visibility("default")))
+
+namespace dso_registry {
+
+using CreateFn = void* (*)();
+
+// Slow path: find the instance for key, creating it with create() if absent.
+// Aborts if two different names hash to the same key.
+DSO_REGISTRY_API void* acquire(std::uint64_t key, const char* name, CreateFn create);
+
+// Number of distinct instances in the registry
+DSO_REGISTRY_API std::size_t size();
+
+constexpr std::uint64_t fnv1a(const char* s) {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (; *s; ++s) {
+        h = (h ^ static_cast<unsigned char>(*s)) * 1099511628211ULL;
+    }
+    return h ? h : 1;  // 0 marks an empty registry slot
+}
+
+// Same spelling in every DSO built by the same compiler
+template <typename T>
+constexpr const char* type_name() {
+    return __PRETTY_FUNCTION__;
+}
+
+template <typename T>
+constexpr std::uint64_t type_key() {
+    return fnv1a(type_name<T>());
+}
+
+// Per-DSO cache of the resolved pointer (constant-initialized, no guard)
+template <typename T>
+struct Slot {
+    static inline std::atomic<T*> cached{nullptr};
+};
+
+template <typename T>
+__attribute__((noinline)) T& resolve() {
+    constexpr std::uint64_t key = type_key<T>();
+    void* obj = acquire(key, type_name<T>(), []() -> void* { return new T(); });
+    Slot<T>::cached.store(static_cast<T*>(obj), std::memory_order_release);
+    return *static_cast<T*>(obj);
+}
+
+template <typename T>
+inline T& instance() {
+    T* p = Slot<T>::cached.load(std::memory_order_acquire);
+    if (__builtin_expect(p != nullptr, 1)) {
+        return *p;
+    }
+    return resolve<T>();
+}
+
+}  // namespace dso_registry
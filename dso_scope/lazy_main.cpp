@@ -0,0 +1,176 @@
+// dso_scope_lazy_demo: plugins are dlopen()ed on the first call to their entry
+//
+// Usage: dso_scope_lazy_demo [--now] [--quiet [--only-a]]  run the demo (--quiet: just call
+//                                                          both entries, --only-a: plugin_a only)
+//        dso_scope_lazy_demo --compare [runs]               startup time / RSS vs eager dso_scope_demo
+#include "lazy_plugin.hpp"
+#include "startup_report.hpp"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef DSO_PLUGIN_DIR
+#define DSO_PLUGIN_DIR "."
+#endif
+
+static LazyPlugin g_plugin_a(DSO_PLUGIN_DIR "/libdso_plugin_a.so");
+static LazyPlugin g_plugin_b(DSO_PLUGIN_DIR "/libdso_plugin_b.so");
+
+// Same names as the eagerly linked entries, so call sites do not change
+static void plugin_a_entry() {
+    static LazyEntry<void (*)()> entry(g_plugin_a, "plugin_a_entry");
+    entry.get()();
+}
+
+static void plugin_b_entry() {
+    static LazyEntry<void (*)()> entry(g_plugin_b, "plugin_b_entry");
+    entry.get()();
+}
+
+static long rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::strtol(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+struct RunStats {
+    double wall_us;
+    long maxrss_kb;
+};
+
+// fork + exec with stdout/stderr silenced; wall time and ru_maxrss of the child
+static RunStats run_silent(const std::vector<std::string>& argv) {
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        std::vector<char*> args;
+        for (const auto& a : argv) {
+            args.push_back(const_cast<char*>(a.c_str()));
+        }
+        args.push_back(nullptr);
+        execv(args[0], args.data());
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage ru {};
+    wait4(pid, &status, 0, &ru);
+    double us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    return RunStats{us, ru.ru_maxrss};
+}
+
+static int compare(const char* self, int runs) {
+    std::string dir(self);
+    dir = dir.substr(0, dir.rfind('/') + 1);
+
+    // Both sides run the same --quiet call pattern, so only the loading differs
+    struct Mode {
+        const char* name;
+        std::vector<std::string> argv;
+    };
+    const std::string eager = dir + "dso_scope_demo";
+    const std::string lazy = dir + "dso_scope_lazy_demo";
+    const Mode modes[] = {
+        {"both called     eager (dso_scope_demo)", {eager, "--quiet"}},
+        {"both called     lazy  RTLD_LAZY", {lazy, "--quiet"}},
+        {"both called     lazy  RTLD_NOW", {lazy, "--quiet", "--now"}},
+        {"plugin_b unused eager (dso_scope_demo)", {eager, "--quiet", "--only-a"}},
+        {"plugin_b unused lazy  RTLD_LAZY", {lazy, "--quiet", "--only-a"}},
+        {"plugin_b unused lazy  RTLD_NOW", {lazy, "--quiet", "--only-a", "--now"}},
+    };
+
+    std::cout << "=== Eager vs On-Demand Plugin Loading (" << runs << " runs) ===\n\n";
+    for (const auto& mode : modes) {
+        std::vector<double> wall;
+        long rss = 0;
+        for (int i = 0; i < runs; ++i) {
+            RunStats s = run_silent(mode.argv);
+            wall.push_back(s.wall_us);
+            rss = std::max(rss, s.maxrss_kb);
+        }
+        std::sort(wall.begin(), wall.end());
+        std::cout << mode.name << ": median exec-to-exit " << wall[wall.size() / 2]
+                  << " us, max RSS " << rss << " KB\n";
+    }
+    std::cout << "\n(plugin_b unused: eager still maps and relocates it, lazy never does)\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    bool quiet = false;
+    bool only_a = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--compare") == 0) {
+            int runs = i + 1 < argc ? std::atoi(argv[i + 1]) : 20;
+            if (runs <= 0) {
+                std::cerr << "usage: " << argv[0] << " --compare [runs >= 1]\n";
+                return 2;
+            }
+            return compare(argv[0], runs);
+        }
+        if (std::strcmp(argv[i], "--now") == 0) {
+            g_plugin_a.set_flags(RTLD_NOW);
+            g_plugin_b.set_flags(RTLD_NOW);
+        }
+        if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        }
+        if (std::strcmp(argv[i], "--only-a") == 0) {
+            only_a = true;
+        }
+    }
+
+    if (quiet) {
+        plugin_a_entry();
+        if (!only_a) {
+            plugin_b_entry();
+        }
+        return 0;
+    }
+
+    std::cout << "=== DSO Scope On-Demand Loading Demo ===\n\n";
+    std::cout << "[main] RSS before any plugin: " << rss_kb() << " KB\n";
+    std::cout << "[main] plugin_a loaded=" << g_plugin_a.loaded()
+              << " plugin_b loaded=" << g_plugin_b.loaded() << "\n\n";
+
+    plugin_a_entry();  // First call: dlopen + dlsym, then cached
+    plugin_a_entry();  // Cached entry point
+
+    std::cout << "\n[main] RSS after plugin_a: " << rss_kb() << " KB\n";
+    std::cout << "[main] plugin_a loaded=" << g_plugin_a.loaded()
+              << " plugin_b loaded=" << g_plugin_b.loaded() << "\n\n";
+
+    plugin_b_entry();  // Only now is plugin_b mapped and relocated
+
+    std::cout << "\n[main] RSS after plugin_b: " << rss_kb() << " KB\n";
+    std::cout << "[main] plugin_a loaded=" << g_plugin_a.loaded()
+              << " plugin_b loaded=" << g_plugin_b.loaded() << "\n";
+
+    std::cout << "\n=== Expected Result ===\n";
+    std::cout << "Each plugin is mapped and relocated on its first call, not at startup\n";
+    std::cout << "(plugin_b loaded=0 until plugin_b_entry() runs; --only-a never loads it)\n";
+    std::cout << "Run with --compare to measure startup time / RSS against eager linking\n";
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <dlfcn.h>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+// On-demand plugin loading: the .so is dlopen()ed on the first call to one
+// of its entries, and each resolved entry point is cached in an atomic so
+// later calls are one acquire load + an indirect call.
+class LazyPlugin {
+public:
+    LazyPlugin(std::string path, int flags = RTLD_LAZY)
+        : path_(std::move(path)), flags_(flags) {}
+
+    // RTLD_LAZY: bind PLT slots on first use; RTLD_NOW: bind everything at load
+    void set_flags(int flags) { flags_ = flags; }
+
+    bool loaded() const { return handle_.load(std::memory_order_acquire) != nullptr; }
+
+    void* symbol(const char* name) {
+        std::call_once(once_, [this] {
+            void* h = dlopen(path_.c_str(), flags_ | RTLD_LOCAL);
+            if (!h) {
+                const char* err = dlerror();
+                throw std::runtime_error(
+                    std::string("dlopen failed: ") + (err ? err : "unknown error"));
+            }
+            handle_.store(h, std::memory_order_release);
+        });
+
+        void* sym = dlsym(handle_.load(std::memory_order_acquire), name);
+        if (!sym) {
+            const char* err = dlerror();
+            throw std::runtime_error(
+                std::string("dlsym failed: ") + (err ? err : "unknown error"));
+        }
+        return sym;
+    }
+
+private:
+    std::string path_;
+    int flags_;
+    std::once_flag once_;
+    std::atomic<void*> handle_{nullptr};
+};
+
+template <typename Fn>
+class LazyEntry {
+public:
+    LazyEntry(LazyPlugin& plugin, const char* name) : plugin_(plugin), name_(name) {}
+
+    Fn get() {
+        Fn fn = cached_.load(std::memory_order_acquire);
+        if (__builtin_expect(fn != nullptr, 1)) {
+            return fn;
+        }
+        fn = reinterpret_cast<Fn>(plugin_.symbol(name_));
+        cached_.store(fn, std::memory_order_release);
+        return fn;
+    }
+
+private:
+    LazyPlugin& plugin_;
+    const char* name_;
+    std::atomic<Fn> cached_{nullptr};
+};
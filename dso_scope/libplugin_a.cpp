@@ -3,4 +3,6 @@
 // Export this function so main can call it
 extern "C" __attribute__((visibility("default"))) void plugin_a_entry() {
     std::cout << "[plugin_a] logger @" << &get_logger() << "\n";
+    Logger& shared = get_shared_logger();  // May create it: resolve before printing
+    std::cout << "[plugin_a] shared @" << &shared << "\n";
 }
@@ -1,12 +1,37 @@
 #pragma once
 #include <iostream>
+#include "singleton_instrument.hpp"
+#include "startup_report.hpp"
+#include "dso_registry.hpp"
 
 struct Logger {
-    Logger() { std::cout << "Logger ctor @" << this << "\n"; }
+    Logger() {
+        startup_report::CtorTimer timer("Logger", this);
+        std::cout << "Logger ctor @" << this << "\n";
+    }
     void log(const char* msg) { std::cout << "[" << msg << "] @" << this << "\n"; }
 };
 
+#if SINGLETON_LAZY_INIT
+// Lazy mode: still one instance per DSO, but constructed on first call
+inline Logger& get_logger() {
+    SINGLETON_ACCESS("get_logger (per DSO)");
+    static Logger instance;
+    return instance;
+}
+#else
 // Even with inline, each DSO gets its own copy
 inline Logger g_logger;
 
-inline Logger& get_logger() { return g_logger; }
+inline Logger& get_logger() {
+    SINGLETON_ACCESS("get_logger (per DSO)");
+    return g_logger;
+}
+#endif
+
+// One instance for the whole process, shared through libdso_registry.so.
+// Plugins keep -fvisibility=hidden; only the registry entry point is exported.
+inline Logger& get_shared_logger() {
+    SINGLETON_ACCESS("get_shared_logger");
+    return dso_registry::instance<Logger>();
+}
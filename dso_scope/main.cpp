@@ -1,13 +1,33 @@
 #include "logger.hpp"
+#include <cstring>
 #include <iostream>
 
 extern "C" void plugin_a_entry();
 extern "C" void plugin_b_entry();
 
-int main() {
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    // Same call pattern as dso_scope_lazy_demo --quiet [--only-a], for --compare
+    bool quiet = false;
+    bool only_a = false;
+    for (int i = 1; i < argc; ++i) {
+        quiet = quiet || std::strcmp(argv[i], "--quiet") == 0;
+        only_a = only_a || std::strcmp(argv[i], "--only-a") == 0;
+    }
+    if (quiet) {
+        plugin_a_entry();
+        if (!only_a) {
+            plugin_b_entry();
+        }
+        return 0;
+    }
+
     std::cout << "=== DSO Scope Singleton Demo ===\n\n";
 
-    std::cout << "[main] logger @" << &get_logger() << "\n\n";
+    std::cout << "[main] logger @" << &get_logger() << "\n";
+    Logger& shared = get_shared_logger();  // First call creates it in the registry
+    std::cout << "[main] shared @" << &shared << "\n\n";
 
     plugin_a_entry();
     plugin_b_entry();
@@ -15,6 +35,8 @@ int main() {
     std::cout << "\n=== Expected Result ===\n";
     std::cout << "main, plugin_a, plugin_b all have DIFFERENT addresses\n";
     std::cout << "This demonstrates per-DSO scope for inline variables\n";
+    std::cout << "shared: main, plugin_a, plugin_b all have the SAME address\n";
+    std::cout << "(registry holds " << dso_registry::size() << " instance(s))\n";
 
     return 0;
 }
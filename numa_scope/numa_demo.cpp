@@ -0,0 +1,65 @@
+// numa_scope_demo: one singleton per NUMA node
+//
+// Usage: numa_scope_demo [threads_per_node]
+// Pins threads_per_node threads (default 2) to CPUs of every node; each
+// thread asks NumaSingleton<NodeConfig>::local() for its copy and prints
+// the address and the node its pages are on.
+#include "numa_singleton.hpp"
+#include "startup_report.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Read-mostly state every thread consults, e.g. routing or config tables
+struct NodeConfig {
+    explicit NodeConfig(int node) : node(node) {
+        startup_report::CtorTimer timer("NodeConfig", this);
+        for (std::size_t i = 0; i < kEntries; ++i) {
+            table[i] = i * 2654435761u;  // First touch, from a thread on `node`
+        }
+        std::cout << "NodeConfig ctor @" << this << " for node " << node << "\n";
+    }
+
+    static constexpr std::size_t kEntries = 1024;
+    int node;
+    std::uint64_t table[kEntries];
+};
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+    int per_node = argc > 1 ? std::atoi(argv[1]) : 2;
+
+    std::cout << "=== NUMA Scope Demo ===\n\n";
+    std::vector<int> nodes = numa_scope::online_nodes();
+    for (int node : nodes) {
+        std::vector<int> cpus = numa_scope::node_cpus(node);
+        std::cout << "node " << node << ": " << cpus.size() << " cpu(s)\n";
+    }
+    std::cout << "\n";
+
+    for (int node : nodes) {
+        std::vector<int> cpus = numa_scope::node_cpus(node);
+        for (int i = 0; i < per_node && !cpus.empty(); ++i) {
+            int cpu = cpus[static_cast<std::size_t>(i) % cpus.size()];
+            // One thread at a time keeps the output readable
+            std::thread t([cpu] {
+                numa_scope::pin_to_cpu(cpu);
+                NodeConfig& cfg = numa_scope::NumaSingleton<NodeConfig>::local();
+                std::cout << "[cpu " << cpu << " node " << numa_scope::current_node() << "] NodeConfig @"
+                          << &cfg << " (node " << cfg.node << ", pages on node "
+                          << numa_scope::node_of_address(&cfg) << ")\n";
+            });
+            t.join();
+        }
+    }
+
+    std::cout << "\ninstances: " << numa_scope::NumaSingleton<NodeConfig>::instances() << " for "
+              << nodes.size() << " node(s)\n";
+
+    std::cout << "\n=== Expected Result ===\n";
+    std::cout << "Threads on the same node share an address; each node has its own copy\n";
+    std::cout << "\"pages on node\" matches the node (mbind(MPOL_BIND) + first touch)\n";
+    return 0;
+}
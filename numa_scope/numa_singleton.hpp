@@ -0,0 +1,83 @@
+#pragma once
+#include "numa_topology.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace numa_scope {
+
+// One T per NUMA node: every thread gets the copy on the node it runs on.
+// Each copy lives in pages bound to its node, so read-mostly shared state
+// is never fetched across the socket interconnect.
+//
+// T is constructed with its node number when it has a T(int) constructor,
+// otherwise default-constructed, the first time a thread of that node asks
+// for it. Instances live until the process exits (never destroyed, like a
+// leaked Meyers singleton: no exit-order problems).
+template <typename T>
+class NumaSingleton {
+public:
+    // Threads migrate between nodes rarely; the node is looked up again
+    // after this many accesses
+    static constexpr std::uint32_t kRecheckEvery = 1024;
+
+    // Copy for the calling thread's node: a TLS load and a counter on the
+    // fast path
+    static T& local() {
+        Cache& c = cache_;
+        if (__builtin_expect(c.left == 0, 0)) {
+            c.instance = &on_node(current_node());
+            c.left = kRecheckEvery;
+        }
+        --c.left;
+        return *c.instance;
+    }
+
+    // Copy for an explicit node (created on demand; pages still bound there)
+    static T& on_node(int node) {
+        if (node < 0 || node >= kMaxNodes) {
+            node = 0;
+        }
+        T* p = slots_[node].load(std::memory_order_acquire);
+        return p ? *p : create(node);
+    }
+
+    // Copies created so far
+    static int instances() { return created_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cache {
+        T* instance = nullptr;
+        std::uint32_t left = 0;
+    };
+
+    static T& create(int node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (T* p = slots_[node].load(std::memory_order_relaxed)) {
+            return *p;
+        }
+        void* mem = alloc_on_node(sizeof(T), node);
+        if (!mem) {
+            throw std::bad_alloc();
+        }
+        T* p;
+        if constexpr (std::is_constructible_v<T, int>) {
+            p = new (mem) T(node);
+        } else {
+            p = new (mem) T();
+        }
+        created_.fetch_add(1, std::memory_order_relaxed);
+        slots_[node].store(p, std::memory_order_release);
+        return *p;
+    }
+
+    static inline std::atomic<T*> slots_[kMaxNodes] = {};
+    static inline std::atomic<int> created_{0};
+    static inline std::mutex mutex_;
+    static inline thread_local Cache cache_;
+};
+
+}  // namespace numa_scope
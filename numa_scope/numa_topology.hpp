@@ -0,0 +1,117 @@
+#pragma once
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// NUMA topology and placement through sysfs and raw syscalls, so nothing
+// here needs libnuma (or its -dev package) installed.
+namespace numa_scope {
+
+constexpr int kMaxNodes = 64;
+
+// "0-3,8,10-11" -> {0,1,2,3,8,10,11}
+inline std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> out;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t end = text.find(',', pos);
+        std::string part = text.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        std::size_t dash = part.find('-');
+        if (!part.empty() && part[0] >= '0' && part[0] <= '9') {
+            int lo = std::stoi(part);
+            int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+            for (int i = lo; i <= hi; ++i) {
+                out.push_back(i);
+            }
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+        pos = end + 1;
+    }
+    return out;
+}
+
+inline std::vector<int> read_list(const std::string& path) {
+    std::ifstream in(path);
+    std::string text;
+    std::getline(in, text);
+    return parse_list(text);
+}
+
+// Online nodes; {0} on kernels without NUMA support
+inline std::vector<int> online_nodes() {
+    std::vector<int> nodes = read_list("/sys/devices/system/node/online");
+    if (nodes.empty()) {
+        nodes.push_back(0);
+    }
+    return nodes;
+}
+
+inline std::vector<int> node_cpus(int node) {
+    return read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+}
+
+// Node of the CPU we are running on right now (vDSO getcpu, no syscall)
+inline int current_node() {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (getcpu(&cpu, &node) != 0) {
+        return 0;
+    }
+    return static_cast<int>(node);
+}
+
+inline bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Node holding the page at `addr`, or -1 (not faulted in / no NUMA)
+inline int node_of_address(const void* addr) {
+    void* page = const_cast<void*>(addr);
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) != 0) {
+        return -1;
+    }
+    return status;
+}
+
+inline std::size_t page_round(std::size_t bytes) {
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) / page * page;
+}
+
+// Anonymous pages bound to `node` with mbind(MPOL_BIND). If mbind is not
+// available the pages still land where they are first touched, so callers
+// should initialize them from a thread running on `node`.
+inline void* alloc_on_node(std::size_t bytes, int node) {
+    bytes = page_round(bytes);
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        return nullptr;
+    }
+    if (node >= 0 && node < kMaxNodes) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, p, bytes, MPOL_BIND, &mask, static_cast<unsigned long>(kMaxNodes) + 1, 0);
+    }
+    return p;
+}
+
+inline void free_on_node(void* p, std::size_t bytes) {
+    if (p) {
+        munmap(p, page_round(bytes));
+    }
+}
+
+}  // namespace numa_scope
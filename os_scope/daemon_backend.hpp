@@ -0,0 +1,38 @@
+#pragma once
+#include "daemon_protocol.hpp"
+#include "daemon_server.hpp"
+
+#include <memory>
+
+// Shared by the serving backends (daemon_epoll.cpp, daemon_uring.cpp);
+// defined in daemon_server.cpp
+namespace os_daemon {
+
+// Bound, listening, non-blocking socket on the abstract address, or -1
+int bind_listener(const char* name = kSocketName);
+
+// SIGINT/SIGTERM blocked and delivered through the returned fd
+int make_signal_fd();
+
+bool peer_allowed(const ServerOptions& options, const ucred& peer);
+
+Response handle_request(const ServerOptions& options, const ucred& peer, const Request& req,
+                        const ServerStats& stats);
+
+// timer_fd is readable: drain it and run options.on_tick
+void on_timer(const ServerOptions& options, int timer_fd, ServerStats& stats);
+
+class EventLoop {
+public:
+    virtual ~EventLoop() = default;
+    virtual const char* name() const = 0;
+    // timer_fd is -1 when there is no tick
+    virtual void run(int listen_fd, int signal_fd, int timer_fd) = 0;
+};
+
+std::unique_ptr<EventLoop> make_epoll_loop(const ServerOptions& options, ServerStats& stats);
+
+// nullptr if io_uring (or a feature this backend needs) is unavailable
+std::unique_ptr<EventLoop> make_uring_loop(const ServerOptions& options, ServerStats& stats);
+
+}  // namespace os_daemon
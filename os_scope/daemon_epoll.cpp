@@ -0,0 +1,219 @@
+#include "daemon_backend.hpp"
+
+#include <sys/epoll.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Readiness backend: epoll_wait, then read(2)/write(2) per ready connection
+namespace os_daemon {
+
+namespace {
+
+constexpr int kMaxEvents = 256;
+constexpr std::size_t kReadSize = 16 * 1024;  // Up to 1024 requests per read(2)
+// Stop reading a connection while this many response bytes wait for the
+// client: one that pipelines without reading cannot grow the daemon
+constexpr std::size_t kMaxOutPending = 256 * 1024;
+
+struct Conn {
+    int fd = -1;
+    ucred peer{};
+    std::size_t in_used = 0;  // Bytes of a partial request carried to the next read
+    char in[kReadSize];
+    std::vector<char> out;    // Responses not yet accepted by the kernel
+    std::size_t out_pos = 0;
+    bool want_out = false;    // EPOLLOUT registered
+    bool paused = false;      // EPOLLIN dropped until out is flushed
+};
+
+class EpollServer : public EventLoop {
+public:
+    EpollServer(const ServerOptions& options, ServerStats& stats)
+        : options_(options), stats_(stats) {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    }
+
+    ~EpollServer() override {
+        for (auto& c : conns_) {
+            if (c) {
+                close(c->fd);
+            }
+        }
+        if (epoll_fd_ >= 0) {
+            close(epoll_fd_);
+        }
+    }
+
+    const char* name() const override { return "epoll"; }
+
+    void run(int listen_fd, int signal_fd, int timer_fd) override {
+        listen_fd_ = listen_fd;
+        signal_fd_ = signal_fd;
+        add(listen_fd_, EPOLLIN);
+        add(signal_fd_, EPOLLIN);
+        if (timer_fd >= 0) {
+            add(timer_fd, EPOLLIN);
+        }
+
+        epoll_event events[kMaxEvents];
+        for (;;) {
+            int n = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+            ++stats_.syscalls;
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "epoll_wait: " << std::strerror(errno) << "\n";
+                return;
+            }
+            ++stats_.wakeups;
+            stats_.events += static_cast<std::uint64_t>(n);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == signal_fd_) {
+                    return;
+                }
+                if (fd == listen_fd_) {
+                    accept_all();
+                    continue;
+                }
+                if (fd == timer_fd) {
+                    on_timer(options_, timer_fd, stats_);
+                    continue;
+                }
+                Conn* c = conns_[static_cast<std::size_t>(fd)].get();
+                if ((events[i].events & EPOLLIN) && !on_readable(*c)) {
+                    drop(c);
+                    continue;
+                }
+                if ((events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && !flush(*c)) {
+                    drop(c);
+                }
+            }
+        }
+    }
+
+private:
+    void add(int fd, std::uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+        ++stats_.syscalls;
+    }
+
+    void set_interest(Conn& c, bool want_out, bool paused) {
+        if (c.want_out == want_out && c.paused == paused) {
+            return;
+        }
+        epoll_event ev{};
+        ev.events = (paused ? 0u : EPOLLIN) | (want_out ? EPOLLOUT : 0u);
+        ev.data.fd = c.fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c.fd, &ev);
+        ++stats_.syscalls;
+        c.want_out = want_out;
+        c.paused = paused;
+    }
+
+    void accept_all() {
+        for (;;) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            ++stats_.syscalls;
+            if (fd < 0) {
+                return;  // EAGAIN, or a transient error; epoll reports again
+            }
+            auto c = std::make_unique<Conn>();
+            c->fd = fd;
+            socklen_t len = sizeof(c->peer);
+            getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &c->peer, &len);
+            ++stats_.syscalls;
+            if (!peer_allowed(options_, c->peer)) {
+                ++stats_.rejected;
+                close(fd);
+                ++stats_.syscalls;
+                continue;
+            }
+            ++stats_.accepted;
+            if (conns_.size() <= static_cast<std::size_t>(fd)) {
+                conns_.resize(static_cast<std::size_t>(fd) + 1);
+            }
+            conns_[static_cast<std::size_t>(fd)] = std::move(c);
+            add(fd, EPOLLIN);
+        }
+    }
+
+    // One read(2) handles every request the client has pipelined so far, and
+    // all their responses leave in one write(2)
+    bool on_readable(Conn& c) {
+        ssize_t n = read(c.fd, c.in + c.in_used, sizeof(c.in) - c.in_used);
+        ++stats_.syscalls;
+        if (n <= 0) {
+            return n < 0 && (errno == EAGAIN || errno == EINTR);
+        }
+        ++stats_.reads;
+        std::size_t avail = c.in_used + static_cast<std::size_t>(n);
+        std::size_t count = avail / sizeof(Request);
+        if (c.out_pos > 0) {
+            // Drop what the kernel already took so out holds only pending bytes
+            c.out.erase(c.out.begin(), c.out.begin() + static_cast<std::ptrdiff_t>(c.out_pos));
+            c.out_pos = 0;
+        }
+        std::size_t base = c.out.size();
+        c.out.resize(base + count * sizeof(Response));
+        for (std::size_t i = 0; i < count; ++i) {
+            Request req;
+            std::memcpy(&req, c.in + i * sizeof(Request), sizeof(req));
+            ++stats_.requests;
+            Response resp = handle_request(options_, c.peer, req, stats_);
+            std::memcpy(c.out.data() + base + i * sizeof(Response), &resp, sizeof(resp));
+        }
+        c.in_used = avail - count * sizeof(Request);
+        std::memmove(c.in, c.in + count * sizeof(Request), c.in_used);
+        return flush(c);
+    }
+
+    bool flush(Conn& c) {
+        while (c.out_pos < c.out.size()) {
+            ssize_t n = write(c.fd, c.out.data() + c.out_pos, c.out.size() - c.out_pos);
+            ++stats_.syscalls;
+            if (n < 0) {
+                if (errno == EAGAIN) {
+                    set_interest(c, true, c.out.size() - c.out_pos >= kMaxOutPending);
+                    return true;
+                }
+                return errno == EINTR;
+            }
+            c.out_pos += static_cast<std::size_t>(n);
+        }
+        c.out.clear();
+        c.out_pos = 0;
+        set_interest(c, false, false);
+        return true;
+    }
+
+    void drop(Conn* c) {
+        int fd = c->fd;
+        close(fd);  // Also removes it from the epoll set
+        ++stats_.syscalls;
+        conns_[static_cast<std::size_t>(fd)].reset();
+    }
+
+    const ServerOptions& options_;
+    ServerStats& stats_;
+    int listen_fd_ = -1;
+    int signal_fd_ = -1;
+    int epoll_fd_ = -1;
+    std::vector<std::unique_ptr<Conn>> conns_;  // Indexed by fd
+};
+
+}  // namespace
+
+std::unique_ptr<EventLoop> make_epoll_loop(const ServerOptions& options, ServerStats& stats) {
+    return std::make_unique<EpollServer>(options, stats);
+}
+
+}  // namespace os_daemon
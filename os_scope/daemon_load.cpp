@@ -0,0 +1,220 @@
+// os_scope_load: load generator for singleton_daemon --serve
+//
+// Usage: os_scope_load [max_clients] [seconds_per_step] [pipeline]
+// Runs 1, 2, 4, ... max_clients concurrent clients (one connection and one
+// thread each). Every client is closed-loop: it writes `pipeline` requests,
+// waits for all responses, and records each request's round-trip time.
+#include "daemon_protocol.hpp"
+#include "status_page.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool write_all(int fd, const void* buf, std::size_t n) {
+    auto* p = static_cast<const char*>(buf);
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        if (w <= 0) {
+            return false;
+        }
+        p += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* buf, std::size_t n) {
+    auto* p = static_cast<char*>(buf);
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return false;
+        }
+        p += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+struct StepResult {
+    unsigned clients;
+    std::uint64_t requests;
+    double seconds;
+    double p50_us;
+    double p99_us;
+    unsigned failed;  // Clients that lost their connection
+};
+
+// Server-side counter over the control connection
+std::uint64_t query_stat(int fd, os_daemon::StatId id) {
+    os_daemon::Request req{os_daemon::kStats, 0, id};
+    os_daemon::Response resp{};
+    if (!write_all(fd, &req, sizeof(req)) || !read_all(fd, &resp, sizeof(resp))) {
+        return 0;
+    }
+    return resp.value;
+}
+
+// Latencies are in nanoseconds
+double percentile(std::vector<std::uint32_t>& v, double p) {
+    if (v.empty()) {
+        return 0.0;
+    }
+    auto k = static_cast<std::size_t>(p * static_cast<double>(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+    return v[k] / 1000.0;
+}
+
+StepResult run_step(unsigned clients, double seconds, unsigned pipeline) {
+    std::vector<int> fds;
+    for (unsigned i = 0; i < clients; ++i) {
+        int fd = os_daemon::connect_daemon();
+        if (fd < 0) {
+            std::cerr << "connect @" << os_daemon::kSocketName << ": " << std::strerror(errno)
+                      << " (is `os_scope_demo --serve` running?)\n";
+            std::exit(1);
+        }
+        fds.push_back(fd);
+    }
+
+    std::vector<std::vector<std::uint32_t>> samples(clients);
+    std::atomic<unsigned> failed{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> pool;
+    for (unsigned c = 0; c < clients; ++c) {
+        pool.emplace_back([&, c] {
+            std::vector<os_daemon::Request> reqs(pipeline);
+            std::vector<os_daemon::Response> resps(pipeline);
+            std::uint32_t seq = 0;
+            samples[c].reserve(1 << 20);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (auto& r : reqs) {
+                    r = os_daemon::Request{os_daemon::kIncr, seq++, 1};
+                }
+                auto start = Clock::now();
+                if (!write_all(fds[c], reqs.data(), pipeline * sizeof(os_daemon::Request)) ||
+                    !read_all(fds[c], resps.data(), pipeline * sizeof(os_daemon::Response))) {
+                    failed.fetch_add(1);
+                    return;
+                }
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+                auto sample = static_cast<std::uint32_t>(std::min<long long>(ns.count(), UINT32_MAX));
+                samples[c].insert(samples[c].end(), pipeline, sample);
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto& t : pool) {
+        t.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    for (int fd : fds) {
+        close(fd);
+    }
+
+    std::vector<std::uint32_t> all;
+    for (auto& s : samples) {
+        all.insert(all.end(), s.begin(), s.end());
+    }
+    StepResult r{clients, all.size(), elapsed, 0.0, 0.0, failed.load()};
+    r.p50_us = percentile(all, 0.50);
+    r.p99_us = percentile(all, 0.99);
+    return r;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    unsigned max_clients = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 64;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    unsigned pipeline = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 1;
+    if (max_clients == 0 || pipeline == 0) {
+        std::cerr << "usage: " << argv[0] << " [max_clients] [seconds_per_step] [pipeline]\n";
+        return 2;
+    }
+
+    // Liveness from the status page: no connect attempt needed to know
+    os_daemon::LivenessResult live = os_daemon::check_liveness();
+    if (live.state != os_daemon::Liveness::kAlive) {
+        std::cerr << "singleton is not running (start `os_scope_demo --serve`)\n";
+        return 1;
+    }
+
+    // Handshake: also shows what the daemon learned via SO_PEERCRED
+    int fd = os_daemon::connect_daemon();
+    if (fd < 0) {
+        std::cerr << "connect @" << os_daemon::kSocketName << ": " << std::strerror(errno)
+                  << " (is `os_scope_demo --serve` running?)\n";
+        return 1;
+    }
+    os_daemon::Request who{os_daemon::kWhoami, 0, 0};
+    os_daemon::Response resp{};
+    if (!write_all(fd, &who, sizeof(who)) || !read_all(fd, &resp, sizeof(resp))) {
+        std::cerr << "daemon closed the connection (SO_PEERCRED uid check?)\n";
+        return 1;
+    }
+
+    std::cout << "=== OS Scope Daemon Load ===\n";
+    std::cout << "singleton pid=" << live.snapshot.pid << " generation=" << live.snapshot.generation
+              << " endpoint=" << live.snapshot.endpoint << "\n";
+    std::cout << "daemon sees us as uid=" << (resp.value >> 32)
+              << " pid=" << (resp.value & 0xffffffffu) << " (we are pid " << getpid() << ")\n";
+    std::cout << "seconds/step=" << seconds << " pipeline=" << pipeline << "\n\n";
+
+    std::cout << std::setw(8) << "clients" << std::setw(14) << "req/s" << std::setw(12) << "p50(us)"
+              << std::setw(12) << "p99(us)" << std::setw(10) << "sys/req" << "\n";
+    std::cout << std::fixed;
+    for (unsigned c = 1;; c = std::min(c * 2, max_clients)) {
+        // The daemon's own syscall count; includes the accept/close of this step
+        std::uint64_t sys0 = query_stat(fd, os_daemon::kStatSyscalls);
+        std::uint64_t req0 = query_stat(fd, os_daemon::kStatRequests);
+        StepResult r = run_step(c, seconds, pipeline);
+        std::uint64_t sys1 = query_stat(fd, os_daemon::kStatSyscalls);
+        std::uint64_t req1 = query_stat(fd, os_daemon::kStatRequests);
+        double sys_per_req = req1 > req0 ? static_cast<double>(sys1 - sys0) / (req1 - req0) : 0.0;
+        std::cout << std::setw(8) << r.clients << std::setprecision(0) << std::setw(14)
+                  << static_cast<double>(r.requests) / r.seconds << std::setprecision(1)
+                  << std::setw(12) << r.p50_us << std::setw(12) << r.p99_us
+                  << std::setprecision(3) << std::setw(10) << sys_per_req;
+        if (r.failed) {
+            std::cout << "  (" << r.failed << " clients disconnected)";
+        }
+        std::cout << "\n" << std::flush;
+        if (c == max_clients) {
+            break;
+        }
+    }
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "latency: write of the pipelined batch -> last response read (closed loop)\n";
+    std::cout << "pipeline > 1 lets the daemon answer many requests per read(2)/write(2)\n";
+    std::cout << "sys/req: syscalls the daemon made per request (compare --backend=epoll|uring)\n";
+    close(fd);
+    return 0;
+}
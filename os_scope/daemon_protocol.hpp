@@ -0,0 +1,75 @@
+#pragma once
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Wire protocol of the os_scope singleton daemon (singleton_daemon --serve).
+//
+// The lock holder listens on an abstract Unix socket: the name lives in the
+// kernel's socket namespace, not the filesystem, so there is no stale socket
+// file to unlink after a crash. Requests and responses are fixed 16-byte
+// frames; a client may pipeline any number of them on one connection and
+// gets responses back in order.
+namespace os_daemon {
+
+constexpr char kSocketName[] = "os_scope_singleton";  // Abstract: sun_path[0] == '\0'
+
+// The holder hands a dup of its listening socket to standbys here (SCM_RIGHTS)
+constexpr char kHandoffName[] = "os_scope_singleton.handoff";
+
+enum Op : std::uint32_t {
+    kPing = 1,    // value = 0
+    kIncr = 2,    // Machine-wide counter += arg; value = new counter
+    kWhoami = 3,  // value = (peer uid << 32) | peer pid, as seen via SO_PEERCRED
+    kStats = 4,   // value = server counter `arg` (StatId)
+    kAdd = 5,     // arg = (key << 32) | delta: table[key] += delta; value = new value
+    kGet = 6,     // value = table[arg], 0 if absent
+};
+
+enum StatId : std::uint64_t { kStatRequests = 0, kStatSyscalls = 1, kStatSnapshots = 2 };
+
+enum Status : std::uint32_t { kOk = 0, kBadOp = 1, kFull = 2 };
+
+struct Request {
+    std::uint32_t op;
+    std::uint32_t seq;  // Echoed back in the response
+    std::uint64_t arg;
+};
+
+struct Response {
+    std::uint32_t status;
+    std::uint32_t seq;
+    std::uint64_t value;
+};
+
+static_assert(sizeof(Request) == 16 && sizeof(Response) == 16, "wire format");
+
+// Abstract address: no trailing NUL, length counts only the bytes used
+inline socklen_t socket_address(sockaddr_un& addr, const char* name = kSocketName) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::size_t n = std::strlen(name);
+    std::memcpy(addr.sun_path + 1, name, n);
+    return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + n);
+}
+
+// Blocking connection to the daemon, or -1 (errno set) if none is serving
+inline int connect_daemon(const char* name = kSocketName) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_un addr;
+    socklen_t len = socket_address(addr, name);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), len) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+}  // namespace os_daemon
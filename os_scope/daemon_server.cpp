@@ -0,0 +1,260 @@
+#include "daemon_server.hpp"
+#include "daemon_backend.hpp"
+#include "daemon_state.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace os_daemon {
+
+namespace {
+
+constexpr int kBindRetryMs = 2000;
+
+}  // namespace
+
+int bind_listener(const char* name) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_un addr;
+    socklen_t len = socket_address(addr, name);
+    if (fd < 0) {
+        std::cerr << "[" << getpid() << "] socket: " << std::strerror(errno) << "\n";
+        return -1;
+    }
+    // We hold the lock, so a bound address belongs to a holder that just
+    // died: the kernel releases its lock fd before its other fds, and an
+    // io_uring instance drops its file references asynchronously
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kBindRetryMs);
+    int rc;
+    while ((rc = bind(fd, reinterpret_cast<sockaddr*>(&addr), len)) < 0 && errno == EADDRINUSE &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    if (rc < 0 || listen(fd, SOMAXCONN) < 0) {
+        std::cerr << "[" << getpid() << "] cannot serve @" << name << ": "
+                  << std::strerror(errno) << "\n";
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int make_signal_fd() {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    return signalfd(-1, &mask, SFD_CLOEXEC);
+}
+
+bool peer_allowed(const ServerOptions& options, const ucred& peer) {
+    return !options.same_uid_only || peer.uid == 0 || peer.uid == geteuid();
+}
+
+Response handle_request(const ServerOptions& options, const ucred& peer, const Request& req,
+                        const ServerStats& stats) {
+    Response resp{kOk, req.seq, 0};
+    DaemonState* state = options.state;
+    switch (req.op) {
+    case kPing:
+        break;
+    case kIncr:
+        resp.value = state ? state->incr(req.arg) : 0;
+        break;
+    case kAdd:
+        if (!state || !state->add(static_cast<std::uint32_t>(req.arg >> 32),
+                                  static_cast<std::uint32_t>(req.arg), resp.value)) {
+            resp.status = kFull;
+        }
+        break;
+    case kGet:
+        resp.value = state ? state->get(static_cast<std::uint32_t>(req.arg)) : 0;
+        break;
+    case kWhoami:
+        resp.value = (static_cast<std::uint64_t>(peer.uid) << 32) |
+                     static_cast<std::uint32_t>(peer.pid);
+        break;
+    case kStats:
+        if (req.arg == kStatSnapshots) {
+            resp.value = state ? state->snapshots() : 0;
+        } else {
+            resp.value = req.arg == kStatSyscalls ? stats.syscalls : stats.requests;
+        }
+        break;
+    default:
+        resp.status = kBadOp;
+        break;
+    }
+    return resp;
+}
+
+void on_timer(const ServerOptions& options, int timer_fd, ServerStats& stats) {
+    std::uint64_t expirations;
+    if (read(timer_fd, &expirations, sizeof(expirations)) > 0 && options.on_tick) {
+        options.on_tick();
+    }
+    ++stats.syscalls;
+}
+
+Server::Server(const ServerOptions& options) : options_(options) {}
+
+Server::~Server() {
+    if (handoff_.joinable()) {
+        // Wake the blocking accept() with a connection of our own
+        stopping_.store(true);
+        int fd = connect_daemon(kHandoffName);
+        if (fd >= 0) {
+            close(fd);
+        }
+        handoff_.join();
+    }
+    loop_.reset();
+    if (signal_fd_ >= 0) {
+        close(signal_fd_);
+    }
+    if (timer_fd_ >= 0) {
+        close(timer_fd_);
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+    }
+}
+
+void Server::prepare() {
+    if (options_.backend != Backend::kEpoll) {
+        loop_ = make_uring_loop(options_, stats_);
+        if (!loop_ && options_.backend == Backend::kUring) {
+            std::cerr << "[" << getpid() << "] io_uring unavailable, falling back to epoll\n";
+        }
+    }
+    if (!loop_) {
+        loop_ = make_epoll_loop(options_, stats_);
+    }
+    stats_.backend = loop_->name();
+}
+
+bool Server::adopt_listener() {
+    int fd = connect_daemon(kHandoffName);
+    if (fd < 0) {
+        return false;
+    }
+    char byte;
+    iovec iov{&byte, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+    close(fd);
+    cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    if (n != 1 || !cm || cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS) {
+        return false;
+    }
+    std::memcpy(&listen_fd_, CMSG_DATA(cm), sizeof(int));
+    return true;
+}
+
+bool Server::listen() {
+    if (listen_fd_ < 0) {
+        listen_fd_ = bind_listener();
+    }
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    // SIGINT/SIGTERM arrive as an fd so shutdown is just another event
+    signal_fd_ = make_signal_fd();
+    if (options_.tick_ms != 0) {
+        timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        itimerspec its{};
+        its.it_interval.tv_sec = options_.tick_ms / 1000;
+        its.it_interval.tv_nsec = static_cast<long>(options_.tick_ms % 1000) * 1000000L;
+        its.it_value = its.it_interval;
+        timerfd_settime(timer_fd_, 0, &its, nullptr);
+    }
+
+    // Off the takeover path: the handoff address of a holder that just died
+    // may take a moment to free up (see bind_listener)
+    sigset_t all;
+    sigset_t old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    handoff_ = std::thread([this] { serve_handoff(); });
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+    return true;
+}
+
+void Server::serve_handoff() {
+    int fd = bind_listener(kHandoffName);
+    if (fd < 0) {
+        return;
+    }
+    int flags = fcntl(fd, F_GETFL);
+    fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+    for (;;) {
+        int conn = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (stopping_.load()) {
+            if (conn >= 0) {
+                close(conn);
+            }
+            break;
+        }
+        if (conn < 0) {
+            continue;
+        }
+        ucred peer{};
+        socklen_t len = sizeof(peer);
+        getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &peer, &len);
+        if (peer_allowed(options_, peer)) {
+            char byte = 'L';
+            iovec iov{&byte, 1};
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+            msghdr msg{};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+            cm->cmsg_level = SOL_SOCKET;
+            cm->cmsg_type = SCM_RIGHTS;
+            cm->cmsg_len = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(cm), &listen_fd_, sizeof(int));
+            sendmsg(conn, &msg, MSG_NOSIGNAL);
+        }
+        close(conn);
+    }
+    close(fd);
+}
+
+void Server::run() {
+    std::cout << "[" << getpid() << "] Serving on abstract socket @" << kSocketName << " ("
+              << loop_->name() << "). Ctrl-C to stop.\n" << std::flush;
+    loop_->run(listen_fd_, signal_fd_, timer_fd_);
+}
+
+void print_stats(const ServerStats& s) {
+    auto per = [](std::uint64_t a, std::uint64_t b) {
+        return b ? static_cast<double>(a) / static_cast<double>(b) : 0.0;
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "=== Server Stats (" << s.backend << ") ===\n";
+    std::cout << "connections      : " << s.accepted << " accepted, " << s.rejected
+              << " rejected (SO_PEERCRED)\n";
+    std::cout << "requests         : " << s.requests << "\n";
+    std::cout << "requests/read    : " << per(s.requests, s.reads) << "\n";
+    std::cout << "events/wakeup    : " << per(s.events, s.wakeups) << "\n";
+    std::cout << "syscalls/request : " << per(s.syscalls, s.requests) << "\n";
+}
+
+}  // namespace os_daemon
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+// Serving loop run by the flock holder (singleton_daemon --serve).
+namespace os_daemon {
+
+class DaemonState;
+
+enum class Backend {
+    kAuto,   // io_uring if the kernel supports what we need, else epoll
+    kEpoll,
+    kUring,  // Still falls back to epoll (with a message) when unavailable
+};
+
+struct ServerOptions {
+    bool same_uid_only = true;  // Reject peers whose SO_PEERCRED uid differs (root always allowed)
+    Backend backend = Backend::kAuto;
+    DaemonState* state = nullptr;  // Counter and table behind kIncr/kAdd/kGet (daemon_state.hpp)
+    unsigned tick_ms = 0;          // Call on_tick about this often from the serving loop (0 = never)
+    std::function<void()> on_tick;
+};
+
+struct ServerStats {
+    const char* backend = "";
+    std::uint64_t accepted = 0;
+    std::uint64_t rejected = 0;   // Failed the SO_PEERCRED check
+    std::uint64_t requests = 0;
+    std::uint64_t reads = 0;      // Reads (epoll) or recv completions (io_uring) carrying data
+    std::uint64_t wakeups = 0;    // epoll_wait / io_uring_enter returns
+    std::uint64_t events = 0;     // Ready fds (epoll) or CQEs (io_uring) handled
+    std::uint64_t syscalls = 0;   // Every syscall made by the serving loop
+};
+
+class EventLoop;
+
+// Split in two so a standby can do the expensive part before it owns the
+// lock and only bind + listen after taking over
+class Server {
+public:
+    explicit Server(const ServerOptions& options);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // No lock needed: pick the backend and set it up (io_uring ring, recv
+    // buffers faulted in)
+    void prepare();
+
+    // Standby only: take a dup of the holder's listening socket over
+    // SCM_RIGHTS. Takeover then needs no bind, and clients connecting in
+    // between queue in the shared backlog instead of being refused.
+    bool adopt_listener();
+
+    // Lock holder only: bind the abstract address (unless adopted), route
+    // SIGINT/SIGTERM to a signalfd, arm the tick timerfd and start offering
+    // the socket to standbys; false if the address cannot be bound
+    bool listen();
+
+    // Serve until SIGINT/SIGTERM
+    void run();
+
+    const ServerStats& stats() const { return stats_; }
+
+private:
+    void serve_handoff();
+
+    ServerOptions options_;
+    ServerStats stats_;
+    std::unique_ptr<EventLoop> loop_;
+    int listen_fd_ = -1;
+    int signal_fd_ = -1;
+    int timer_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread handoff_;
+};
+
+void print_stats(const ServerStats& stats);
+
+}  // namespace os_daemon
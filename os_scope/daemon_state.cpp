@@ -0,0 +1,369 @@
+#include "daemon_state.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace os_daemon {
+
+namespace {
+
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint64_t kBucketsPerSegment = kSegmentSize / sizeof(Bucket);
+constexpr std::uint64_t kMinBuckets = 16 * kBucketsPerSegment;
+
+constexpr std::uint64_t align_up(std::uint64_t n, std::uint64_t a) {
+    return (n + a - 1) / a * a;
+}
+
+struct Layout {
+    std::uint64_t checksums_offset;
+    std::uint64_t table_offset;
+    std::uint64_t segments;
+    std::uint64_t total_size;
+};
+
+// Header page | checksum array | table; fully determined by `buckets`
+Layout layout_for(std::uint64_t buckets) {
+    Layout l;
+    l.segments = buckets / kBucketsPerSegment;
+    l.checksums_offset = kSegmentSize;
+    l.table_offset = align_up(l.checksums_offset + l.segments * sizeof(std::uint64_t), kSegmentSize);
+    l.total_size = l.table_offset + buckets * sizeof(Bucket);
+    return l;
+}
+
+// Word-at-a-time hash; sizes are multiples of 8
+std::uint64_t checksum(const void* data, std::size_t n, std::uint64_t seed = 0) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = seed ^ (0x9E3779B97F4A7C15ULL * (n + 1));
+    for (std::size_t i = 0; i < n; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h ^= w * 0xC2B2AE3D27D4EB4FULL;
+        h = ((h << 31) | (h >> 33)) * 0x9E3779B185EBCA87ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+std::uint64_t header_checksum(const SnapshotHeader& hdr, const std::uint64_t* sums) {
+    SnapshotHeader copy = hdr;
+    copy.header_checksum = 0;
+    std::uint64_t h = checksum(&copy, sizeof(copy));
+    return checksum(sums, hdr.segments * sizeof(std::uint64_t), h);
+}
+
+bool read_all(int fd, char* out, std::size_t n) {
+    std::size_t done = 0;
+    while (done < n) {
+        ssize_t r = pread(fd, out + done, n - done, static_cast<off_t>(done));
+        if (r <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+bool write_all(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w <= 0) {
+            return false;
+        }
+        p += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+}  // namespace
+
+DaemonState::~DaemonState() {
+    reap(true);
+    if (base_) {
+        munmap(base_, size_);
+    }
+}
+
+bool DaemonState::open(std::size_t state_bytes, RestoreMode mode) {
+    auto t0 = std::chrono::steady_clock::now();
+    if (restore(mode)) {
+        info_.restored = true;
+        info_.generation = hdr_->generation;
+        info_.entries = hdr_->entries;
+    } else {
+        init_empty(state_bytes);
+        if (!base_) {
+            return false;
+        }
+    }
+    snapshot_mutations_ = hdr_->mutations;
+    info_.open_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+bool DaemonState::map_region(std::size_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    base_ = static_cast<char*>(addr);
+    size_ = size;
+    return true;
+}
+
+bool DaemonState::restore(RestoreMode mode) {
+    int fd = ::open(snapshot_file_, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        info_.reason = "no snapshot";
+        return false;
+    }
+    struct stat st{};
+    SnapshotHeader hdr{};
+    bool ok = fstat(fd, &st) == 0 && pread(fd, &hdr, sizeof(hdr), 0) == sizeof(hdr);
+    Layout l = layout_for(hdr.buckets);
+    if (!ok || std::memcmp(hdr.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        hdr.version != kVersion || hdr.header_size != sizeof(SnapshotHeader)) {
+        info_.reason = "bad header";
+        ok = false;
+    } else if (hdr.buckets < kMinBuckets || (hdr.buckets & (hdr.buckets - 1)) != 0 ||
+               hdr.segments != l.segments || hdr.checksums_offset != l.checksums_offset ||
+               hdr.table_offset != l.table_offset || hdr.total_size != l.total_size ||
+               static_cast<std::uint64_t>(st.st_size) != l.total_size ||
+               hdr.entries > hdr.buckets) {
+        info_.reason = "inconsistent layout";
+        ok = false;
+    }
+    if (ok) {
+        if (mode == RestoreMode::kMmap) {
+            // Private: our writes are copy-on-write, the file stays a snapshot
+            void* addr = mmap(nullptr, l.total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ok = addr != MAP_FAILED;
+            if (ok) {
+                base_ = static_cast<char*>(addr);
+                size_ = l.total_size;
+            }
+        } else {
+            ok = map_region(l.total_size) && read_all(fd, base_, l.total_size);
+        }
+        if (!ok) {
+            info_.reason = "cannot map";
+        }
+    }
+    ::close(fd);
+    if (!ok) {
+        if (base_) {
+            munmap(base_, size_);
+            base_ = nullptr;
+        }
+        return false;
+    }
+
+    hdr_ = reinterpret_cast<SnapshotHeader*>(base_);
+    auto* sums = reinterpret_cast<std::uint64_t*>(base_ + hdr_->checksums_offset);
+    if (header_checksum(*hdr_, sums) != hdr_->header_checksum) {
+        info_.reason = "header checksum mismatch";
+        munmap(base_, size_);
+        base_ = nullptr;
+        hdr_ = nullptr;
+        return false;
+    }
+    validated_.assign(hdr_->segments, 0);
+    if (mode == RestoreMode::kRead) {
+        for (std::uint64_t s = 0; s < hdr_->segments; ++s) {
+            validate_segment(s);
+        }
+    }
+    return true;
+}
+
+void DaemonState::init_empty(std::size_t state_bytes) {
+    std::uint64_t buckets = kMinBuckets;
+    while (buckets * 2 * sizeof(Bucket) <= state_bytes) {
+        buckets *= 2;
+    }
+    Layout l = layout_for(buckets);
+    if (!map_region(l.total_size)) {
+        return;
+    }
+    // Anonymous memory is already zero: the table is empty without touching it
+    hdr_ = reinterpret_cast<SnapshotHeader*>(base_);
+    std::memcpy(hdr_->magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    hdr_->version = kVersion;
+    hdr_->header_size = sizeof(SnapshotHeader);
+    hdr_->total_size = l.total_size;
+    hdr_->checksums_offset = l.checksums_offset;
+    hdr_->table_offset = l.table_offset;
+    hdr_->buckets = buckets;
+    hdr_->segments = l.segments;
+    validated_.assign(l.segments, 1);
+}
+
+void DaemonState::validate_segment(std::uint64_t seg) {
+    char* p = base_ + hdr_->table_offset + seg * kSegmentSize;
+    auto* sums = reinterpret_cast<const std::uint64_t*>(base_ + hdr_->checksums_offset);
+    if (checksum(p, kSegmentSize) != sums[seg]) {
+        // Lose this segment's entries rather than serve garbage. Tombstones,
+        // not empty buckets: probe chains that run through the segment must
+        // still reach the keys stored after it.
+        auto* b = reinterpret_cast<Bucket*>(p);
+        for (std::uint64_t i = 0; i < kBucketsPerSegment; ++i) {
+            if (b[i].used == kBucketUsed && hdr_->entries > 0) {
+                --hdr_->entries;
+            }
+            b[i] = Bucket{0, kBucketTombstone, 0};
+        }
+        ++segments_corrupt_;
+    }
+    validated_[seg] = 1;
+    ++segments_validated_;
+}
+
+Bucket* DaemonState::bucket(std::uint64_t index) {
+    std::uint64_t seg = index / kBucketsPerSegment;
+    if (__builtin_expect(!validated_[seg], 0)) {
+        validate_segment(seg);
+    }
+    return reinterpret_cast<Bucket*>(base_ + hdr_->table_offset) + index;
+}
+
+std::uint64_t DaemonState::incr(std::uint64_t delta) {
+    ++hdr_->mutations;
+    return hdr_->counter += delta;
+}
+
+bool DaemonState::add(std::uint32_t key, std::uint64_t delta, std::uint64_t& value) {
+    std::uint64_t mask = hdr_->buckets - 1;
+    std::uint64_t i = home_bucket(key, hdr_->buckets);
+    Bucket* reuse = nullptr;  // First tombstone on the chain
+    Bucket* b = nullptr;
+    for (std::uint64_t n = 0; n < hdr_->buckets; ++n, i = (i + 1) & mask) {
+        b = bucket(i);
+        if (b->used == kBucketUsed && b->key == key) {
+            b->value += delta;
+            value = b->value;
+            ++hdr_->mutations;
+            return true;
+        }
+        if (b->used == kBucketTombstone && !reuse) {
+            reuse = b;
+        }
+        if (!b->used) {
+            break;
+        }
+    }
+    // Not found: the whole chain was searched, so reusing a tombstone on it
+    // cannot create a duplicate
+    if (reuse) {
+        b = reuse;
+    } else if (!b || b->used || hdr_->entries >= hdr_->buckets / 10 * 9) {
+        return false;  // Full, or keep probe chains short
+    }
+    b->key = key;
+    b->used = kBucketUsed;
+    b->value = delta;
+    value = delta;
+    ++hdr_->entries;
+    ++hdr_->mutations;
+    return true;
+}
+
+std::uint64_t DaemonState::get(std::uint32_t key) {
+    std::uint64_t mask = hdr_->buckets - 1;
+    std::uint64_t i = home_bucket(key, hdr_->buckets);
+    for (std::uint64_t n = 0; n < hdr_->buckets; ++n, i = (i + 1) & mask) {
+        const Bucket* b = bucket(i);
+        if (!b->used) {
+            return 0;
+        }
+        if (b->used == kBucketUsed && b->key == key) {
+            return b->value;
+        }
+    }
+    return 0;
+}
+
+void DaemonState::reap(bool wait) {
+    if (child_ < 0) {
+        return;
+    }
+    int status = 0;
+    pid_t r = waitpid(child_, &status, wait ? 0 : WNOHANG);
+    if (r == child_ || (r < 0 && errno == ECHILD)) {
+        if (r == child_ && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            ++snapshots_;
+        }
+        child_ = -1;
+    }
+}
+
+void DaemonState::snapshot_async() {
+    reap(false);
+    if (child_ >= 0 || hdr_->mutations == snapshot_mutations_) {
+        return;
+    }
+    ++hdr_->generation;
+    pid_t pid = fork();
+    if (pid == 0) {
+        // The child's copy-on-write view is frozen at the fork. Drop the
+        // inherited fds first: a dup of the lock fd would keep the flock held
+        // (and the listening socket open) after the daemon itself dies.
+        close_range(3, ~0U, 0);
+        _exit(write_snapshot() ? 0 : 1);
+    }
+    if (pid > 0) {
+        child_ = pid;
+        snapshot_mutations_ = hdr_->mutations;
+    }
+}
+
+bool DaemonState::snapshot_now() {
+    reap(true);
+    ++hdr_->generation;
+    bool ok = write_snapshot();
+    if (ok) {
+        ++snapshots_;
+        snapshot_mutations_ = hdr_->mutations;
+    }
+    return ok;
+}
+
+bool DaemonState::write_snapshot() {
+    auto* sums = reinterpret_cast<std::uint64_t*>(base_ + hdr_->checksums_offset);
+    const char* table = base_ + hdr_->table_offset;
+    for (std::uint64_t s = 0; s < hdr_->segments; ++s) {
+        // A segment never validated is byte-for-byte what was loaded, so its
+        // old checksum still applies (and still catches corruption)
+        if (validated_[s]) {
+            sums[s] = checksum(table + s * kSegmentSize, kSegmentSize);
+        }
+    }
+    hdr_->header_checksum = header_checksum(*hdr_, sums);
+
+    char tmp[128];
+    std::snprintf(tmp, sizeof(tmp), "%s.tmp.%d", snapshot_file_, static_cast<int>(getpid()));
+    int fd = ::open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write_all(fd, base_, size_) && fdatasync(fd) == 0;
+    ::close(fd);
+    // rename() swaps the snapshot atomically; a mapping of the old file
+    // keeps the old inode alive
+    if (!ok || rename(tmp, snapshot_file_) != 0) {
+        unlink(tmp);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace os_daemon
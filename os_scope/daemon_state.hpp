@@ -0,0 +1,129 @@
+#pragma once
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// State of the machine singleton, kept in a snapshot-able, position-
+// independent region: header | per-segment checksums | hash table. Only
+// offsets are stored, so the same bytes work at any address (in memory and
+// in the snapshot file).
+//
+// Warm restart maps the last snapshot MAP_PRIVATE and serves from it
+// directly: validation at startup covers the header and the checksum array,
+// and each 4 KiB table segment is checked the first time a request touches
+// it. Restart cost follows the working set, not the state size. Writes
+// after the restore are copy-on-write and never reach the old file.
+namespace os_daemon {
+
+constexpr const char* kSnapshotFile = "/tmp/os_scope_state.snap";
+constexpr char kSnapshotMagic[8] = {'O', 'S', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr std::size_t kSegmentSize = 4096;
+
+enum class RestoreMode {
+    kMmap,  // Map the snapshot, validate segments lazily (default)
+    kRead,  // read(2) the whole file and validate everything up front
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t total_size;
+    std::uint64_t generation;       // Snapshots written from this lineage
+    std::uint64_t counter;          // kIncr counter
+    std::uint64_t entries;          // Used buckets
+    std::uint64_t mutations;        // Bumped per change; unchanged = skip snapshot
+    std::uint64_t checksums_offset;
+    std::uint64_t table_offset;
+    std::uint64_t buckets;          // Power of two
+    std::uint64_t segments;
+    std::uint64_t header_checksum;  // Header (this field 0) + checksum array
+};
+
+// used: 0 = empty (ends a probe chain), kBucketUsed, or kBucketTombstone
+// (lost to a corrupt segment; probing continues past it, add() reuses it)
+constexpr std::uint32_t kBucketUsed = 1;
+constexpr std::uint32_t kBucketTombstone = 2;
+
+struct Bucket {
+    std::uint32_t key;
+    std::uint32_t used;
+    std::uint64_t value;
+};
+
+static_assert(kSegmentSize % sizeof(Bucket) == 0, "whole buckets per segment");
+
+// First bucket of `key`'s linear probe chain; `buckets` is a power of two
+inline std::uint64_t home_bucket(std::uint32_t key, std::uint64_t buckets) {
+    // Spread neighbouring keys over different segments
+    return (((static_cast<std::uint64_t>(key) + 1) * 0x9E3779B97F4A7C15ULL) >> 20) & (buckets - 1);
+}
+
+struct RestoreInfo {
+    bool restored = false;
+    const char* reason = "";  // Why a snapshot was not used
+    std::uint64_t generation = 0;
+    std::uint64_t entries = 0;
+    double open_us = 0.0;     // File open/map/validate (not the lazily checked segments)
+};
+
+class DaemonState {
+public:
+    // `snapshot_file` is read by open() and written by the snapshots
+    explicit DaemonState(const char* snapshot_file = kSnapshotFile)
+        : snapshot_file_(snapshot_file) {}
+    ~DaemonState();
+
+    DaemonState(const DaemonState&) = delete;
+    DaemonState& operator=(const DaemonState&) = delete;
+
+    // Restore from the snapshot file, else start empty with room for about
+    // `state_bytes` of table; false only if memory cannot be mapped
+    bool open(std::size_t state_bytes, RestoreMode mode);
+
+    std::uint64_t incr(std::uint64_t delta);
+    // false if the table is full
+    bool add(std::uint32_t key, std::uint64_t delta, std::uint64_t& value);
+    std::uint64_t get(std::uint32_t key);
+
+    // Point-in-time copy written by a fork()ed child; called from the
+    // serving thread between batches. Reaps the previous child first and
+    // does nothing if the state has not changed or a child is still running.
+    void snapshot_async();
+
+    // Synchronous snapshot (shutdown); waits for a running child first
+    bool snapshot_now();
+
+    const RestoreInfo& restore_info() const { return info_; }
+    std::uint64_t snapshots() const { return snapshots_; }
+    std::uint64_t segments_validated() const { return segments_validated_; }
+    std::uint64_t segments_corrupt() const { return segments_corrupt_; }
+    std::size_t size() const { return size_; }
+
+private:
+    bool restore(RestoreMode mode);
+    void init_empty(std::size_t state_bytes);
+    bool map_region(std::size_t size);
+    Bucket* bucket(std::uint64_t index);
+    void validate_segment(std::uint64_t seg);
+    void reap(bool wait);
+    // Fill checksums + header checksum and write to snapshot_file_ (atomically
+    // via rename). Safe in a child of a multi-threaded process: no allocation.
+    bool write_snapshot();
+
+    const char* snapshot_file_;
+    char* base_ = nullptr;
+    std::size_t size_ = 0;
+    SnapshotHeader* hdr_ = nullptr;
+    std::vector<std::uint8_t> validated_;  // Per segment; not part of the snapshot
+    std::uint64_t snapshot_mutations_ = 0;
+    pid_t child_ = -1;
+    RestoreInfo info_;
+    std::uint64_t snapshots_ = 0;
+    std::uint64_t segments_validated_ = 0;
+    std::uint64_t segments_corrupt_ = 0;
+};
+
+}  // namespace os_daemon
@@ -0,0 +1,125 @@
+// daemon_state_test: a corrupt snapshot segment in the middle of a probe
+// chain loses only its own entries - keys stored after it on the same chain
+// stay reachable, and add() updates them instead of inserting duplicates
+//
+// Usage: daemon_state_test   (ctest: daemon_state_test)
+//
+// Uses its own snapshot file, not kSnapshotFile, so a running daemon's
+// snapshot is left alone.
+#include "daemon_state.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what, unsigned long long got, unsigned long long want) {
+    std::printf("%-44s %8llu (expected %llu)%s\n", what, got, want, ok ? "" : "  FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+std::uint64_t value_of(std::uint32_t key) {
+    return static_cast<std::uint64_t>(key) * 7 + 1;
+}
+
+}  // namespace
+
+int main() {
+    const std::string path = "/tmp/os_scope_state_test." + std::to_string(getpid()) + ".snap";
+    unlink(path.c_str());
+
+    // One probe chain that starts in segment kSeg - 1, fills segment kSeg and
+    // ends in segment kSeg + 1: every key shares the same home bucket
+    constexpr std::uint64_t kPerSeg = os_daemon::kSegmentSize / sizeof(os_daemon::Bucket);
+    constexpr std::uint64_t kSeg = 8;
+    constexpr std::uint64_t kBuckets = 16 * kPerSeg;  // An empty state's table
+    constexpr std::uint64_t kHome = kSeg * kPerSeg - 16;
+    constexpr std::uint64_t kChain = kPerSeg + 32;
+    std::vector<std::uint32_t> chain;
+    for (std::uint32_t key = 1; chain.size() < kChain; ++key) {
+        if (os_daemon::home_bucket(key, kBuckets) == kHome) {
+            chain.push_back(key);
+        }
+    }
+    {
+        os_daemon::DaemonState state(path.c_str());
+        if (!state.open(0, os_daemon::RestoreMode::kMmap)) {
+            std::printf("cannot map state\n");
+            return 1;
+        }
+        std::uint64_t value = 0;
+        for (std::uint32_t key : chain) {
+            state.add(key, value_of(key), value);
+        }
+        if (!state.snapshot_now()) {
+            std::printf("cannot write %s\n", path.c_str());
+            return 1;
+        }
+    }
+
+    // Corrupt segment kSeg; remember the keys it held
+    os_daemon::SnapshotHeader hdr{};
+    std::set<std::uint32_t> lost;
+    int fd = open(path.c_str(), O_RDWR);
+    pread(fd, &hdr, sizeof(hdr), 0);
+    const off_t seg_off = static_cast<off_t>(hdr.table_offset + kSeg * os_daemon::kSegmentSize);
+    std::vector<os_daemon::Bucket> buckets(kPerSeg);
+    pread(fd, buckets.data(), os_daemon::kSegmentSize, seg_off);
+    for (const auto& b : buckets) {
+        if (b.used == os_daemon::kBucketUsed) {
+            lost.insert(b.key);
+        }
+    }
+    const char garbage[8] = {'c', 'o', 'r', 'r', 'u', 'p', 't', '!'};
+    pwrite(fd, garbage, sizeof(garbage), seg_off + 64);
+    close(fd);
+
+    os_daemon::DaemonState state(path.c_str());
+    state.open(0, os_daemon::RestoreMode::kRead);
+    std::uint64_t reachable = 0;
+    std::uint64_t wrong = 0;
+    for (std::uint32_t key : chain) {
+        std::uint64_t got = state.get(key);
+        if (lost.count(key)) {
+            wrong += got != 0 ? 1 : 0;
+        } else if (got == value_of(key)) {
+            ++reachable;
+        } else {
+            ++wrong;
+        }
+    }
+    // Adding to every surviving key must find it, not insert a second copy
+    std::uint64_t duplicates = 0;
+    for (std::uint32_t key : chain) {
+        std::uint64_t value = 0;
+        if (!lost.count(key) && (!state.add(key, 1, value) || value != value_of(key) + 1)) {
+            ++duplicates;
+        }
+    }
+    // Lost keys come back into the tombstones
+    std::uint64_t readded = 0;
+    for (std::uint32_t key : lost) {
+        std::uint64_t value = 0;
+        readded += state.add(key, value_of(key), value) && state.get(key) == value_of(key) ? 1 : 0;
+    }
+    unlink(path.c_str());
+
+    std::printf("=== DaemonState corrupt segment ===\n");
+    const bool restored = state.restore_info().restored;
+    expect(restored, "snapshot restored", restored ? 1 : 0, 1);
+    expect(state.segments_corrupt() == 1, "segments_corrupt()", state.segments_corrupt(), 1);
+    expect(lost.size() == kPerSeg, "keys in the corrupted segment", lost.size(), kPerSeg);
+    expect(reachable == kChain - kPerSeg, "keys before and after it reachable", reachable,
+           kChain - kPerSeg);
+    expect(wrong == 0, "wrong values", wrong, 0);
+    expect(duplicates == 0, "add() to a surviving key duplicated it", duplicates, 0);
+    expect(readded == lost.size(), "lost keys added again", readded, lost.size());
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,491 @@
+#include "daemon_backend.hpp"
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Completion backend on raw io_uring (no liburing dependency).
+//
+// - One multishot accept and, per connection, one multishot recv: the kernel
+//   keeps posting completions without new submissions.
+// - recv data lands in a provided-buffer ring registered with the kernel
+//   (IORING_REGISTER_PBUF_RING), so no buffer is pinned per idle connection.
+// - All SQEs queued while handling a batch of CQEs go out in the same
+//   io_uring_enter that waits for the next batch: one syscall per loop.
+namespace os_daemon {
+
+namespace {
+
+constexpr unsigned kRingEntries = 1024;
+constexpr unsigned kBufCount = 1024;        // Power of two
+constexpr unsigned kBufSize = 16 * 1024;    // Up to 1024 requests per recv completion
+constexpr std::uint16_t kBufGroup = 0;
+
+enum Kind : std::uint64_t { kAcceptOp = 1, kRecvOp = 2, kSendOp = 3, kSignalOp = 4, kTimerOp = 5 };
+
+std::uint64_t tag(Kind kind, int fd) {
+    return (static_cast<std::uint64_t>(kind) << 32) | static_cast<std::uint32_t>(fd);
+}
+
+int sys_setup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+int sys_enter(int fd, unsigned submit, unsigned wait, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait, flags, nullptr, 0));
+}
+int sys_register(int fd, unsigned op, void* arg, unsigned n) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, op, arg, n));
+}
+
+template <typename T>
+T* at(void* base, std::uint32_t off) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + off);
+}
+
+struct Conn {
+    int fd = -1;
+    ucred peer{};
+    char partial[sizeof(Request)];  // Request split across two completions
+    std::size_t partial_len = 0;
+    std::vector<char> pending;      // Responses waiting for the in-flight send
+    std::vector<char> sending;      // Buffer the kernel is sending from
+    std::size_t send_pos = 0;
+    bool send_inflight = false;
+    bool recv_armed = false;
+    bool closing = false;
+    bool dirty = false;             // Has pending data to submit this loop
+};
+
+class UringServer : public EventLoop {
+public:
+    UringServer(const ServerOptions& options, ServerStats& stats)
+        : options_(options), stats_(stats) {}
+
+    ~UringServer() override {
+        for (auto& c : conns_) {
+            if (c) {
+                close(c->fd);
+            }
+        }
+        if (ring_fd_ >= 0) {
+            close(ring_fd_);
+        }
+        if (sq_ptr_) {
+            munmap(sq_ptr_, sq_len_);
+        }
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+            munmap(cq_ptr_, cq_len_);
+        }
+        if (sqes_) {
+            munmap(sqes_, sqes_len_);
+        }
+        if (bufs_) {
+            munmap(bufs_, buf_ring_len_);
+        }
+    }
+
+    bool setup() {
+        io_uring_params p{};
+        p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        p.cq_entries = kRingEntries * 8;
+        ring_fd_ = sys_setup(kRingEntries, &p);
+        if (ring_fd_ < 0 && errno == EINVAL) {
+            p = io_uring_params{};  // Kernels before 6.1: no DEFER_TASKRUN
+            p.flags = IORING_SETUP_CQSIZE;
+            p.cq_entries = kRingEntries * 8;
+            ring_fd_ = sys_setup(kRingEntries, &p);
+        }
+        if (ring_fd_ < 0 || !(p.features & IORING_FEAT_SINGLE_MMAP)) {
+            return false;
+        }
+
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(std::uint32_t);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        sq_len_ = cq_len_ = sq_len_ > cq_len_ ? sq_len_ : cq_len_;
+        sq_ptr_ = mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) {
+            sq_ptr_ = nullptr;
+            return false;
+        }
+        cq_ptr_ = sq_ptr_;
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        sq_head_ = at<unsigned>(sq_ptr_, p.sq_off.head);
+        sq_tail_ = at<unsigned>(sq_ptr_, p.sq_off.tail);
+        sq_mask_ = *at<unsigned>(sq_ptr_, p.sq_off.ring_mask);
+        sq_entries_ = p.sq_entries;
+        sq_array_ = at<unsigned>(sq_ptr_, p.sq_off.array);
+        cq_head_ = at<unsigned>(cq_ptr_, p.cq_off.head);
+        cq_tail_ = at<unsigned>(cq_ptr_, p.cq_off.tail);
+        cq_mask_ = *at<unsigned>(cq_ptr_, p.cq_off.ring_mask);
+        cqes_ = at<io_uring_cqe>(cq_ptr_, p.cq_off.cqes);
+        sq_local_tail_ = *sq_tail_;
+
+        return setup_buffers();
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+    void run(int listen_fd, int signal_fd, int timer_fd) override {
+        listen_fd_ = listen_fd;
+        signal_fd_ = signal_fd;
+        timer_fd_ = timer_fd;
+        arm_accept();
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = signal_fd_;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data = tag(kSignalOp, signal_fd_);
+        if (timer_fd_ >= 0) {
+            arm_timer();
+        }
+
+        for (;;) {
+            publish_buffers();
+            unsigned submit = flush_sq();
+            int r = sys_enter(ring_fd_, submit, 1, IORING_ENTER_GETEVENTS);
+            ++stats_.syscalls;
+            if (r < 0 && errno != EINTR && errno != EBUSY) {
+                std::cerr << "io_uring_enter: " << std::strerror(errno) << "\n";
+                return;
+            }
+            ++stats_.wakeups;
+
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                ++stats_.events;
+                if (!on_completion(cqe)) {
+                    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+                    return;
+                }
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            // Responses produced by any completion of this batch leave together
+            for (Conn* c : dirty_) {
+                c->dirty = false;
+                start_send(*c);
+            }
+            dirty_.clear();
+        }
+    }
+
+private:
+    bool setup_buffers() {
+        buf_ring_len_ = kBufCount * sizeof(io_uring_buf);
+        void* ring = mmap(nullptr, buf_ring_len_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED) {
+            return false;
+        }
+        // Indexed as a plain array: in C++ the header's flexible `bufs` member
+        // lands at offset 8, not 0. The ring tail overlays bufs[0].resv.
+        bufs_ = static_cast<io_uring_buf*>(ring);
+        buf_tail_ = &bufs_[0].resv;
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<std::uintptr_t>(bufs_);
+        reg.ring_entries = kBufCount;
+        reg.bgid = kBufGroup;
+        if (sys_register(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            return false;  // Before 5.19
+        }
+        // Faulted in now, not on the first burst of traffic (or takeover)
+        std::size_t bytes = static_cast<std::size_t>(kBufCount) * kBufSize;
+        buffers_.reset(new char[bytes]);
+        std::memset(buffers_.get(), 0, bytes);
+        for (unsigned i = 0; i < kBufCount; ++i) {
+            recycle(static_cast<std::uint16_t>(i));
+        }
+        publish_buffers();
+        return true;
+    }
+
+    void recycle(std::uint16_t bid) {
+        io_uring_buf& b = bufs_[buf_local_tail_ & (kBufCount - 1)];
+        b.addr = reinterpret_cast<std::uintptr_t>(buffers_.get() + static_cast<std::size_t>(bid) * kBufSize);
+        b.len = kBufSize;
+        b.bid = bid;
+        ++buf_local_tail_;
+    }
+
+    void publish_buffers() {
+        __atomic_store_n(buf_tail_, buf_local_tail_, __ATOMIC_RELEASE);
+    }
+
+    io_uring_sqe* get_sqe() {
+        if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            // SQ full: hand what we have to the kernel without waiting
+            sys_enter(ring_fd_, flush_sq(), 0, 0);
+            ++stats_.syscalls;
+        }
+        unsigned idx = sq_local_tail_ & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[idx] = idx;
+        ++sq_local_tail_;
+        ++queued_;
+        return sqe;
+    }
+
+    unsigned flush_sq() {
+        __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+        unsigned n = queued_;
+        queued_ = 0;
+        return n;
+    }
+
+    void arm_accept() {
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listen_fd_;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->user_data = tag(kAcceptOp, listen_fd_);
+    }
+
+    void arm_timer() {
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = timer_fd_;
+        sqe->poll32_events = POLLIN;
+        sqe->len = IORING_POLL_ADD_MULTI;
+        sqe->user_data = tag(kTimerOp, timer_fd_);
+    }
+
+    void arm_recv(Conn& c) {
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = c.fd;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufGroup;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->user_data = tag(kRecvOp, c.fd);
+        c.recv_armed = true;
+    }
+
+    void start_send(Conn& c) {
+        if (c.send_inflight || c.closing || c.pending.empty()) {
+            return;
+        }
+        c.sending.swap(c.pending);
+        c.pending.clear();
+        c.send_pos = 0;
+        submit_send(c);
+    }
+
+    void submit_send(Conn& c) {
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = c.fd;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(c.sending.data() + c.send_pos);
+        sqe->len = static_cast<std::uint32_t>(c.sending.size() - c.send_pos);
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = tag(kSendOp, c.fd);
+        c.send_inflight = true;
+    }
+
+    // false = stop serving
+    bool on_completion(const io_uring_cqe& cqe) {
+        auto kind = static_cast<Kind>(cqe.user_data >> 32);
+        int fd = static_cast<int>(cqe.user_data & 0xffffffffu);
+        switch (kind) {
+        case kSignalOp:
+            return false;
+        case kTimerOp:
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                arm_timer();
+            }
+            on_timer(options_, timer_fd_, stats_);
+            return true;
+        case kAcceptOp:
+            on_accept(cqe);
+            return true;
+        case kRecvOp:
+            on_recv(*conns_[static_cast<std::size_t>(fd)], cqe);
+            return true;
+        case kSendOp:
+            on_send(*conns_[static_cast<std::size_t>(fd)], cqe);
+            return true;
+        }
+        return true;
+    }
+
+    void on_accept(const io_uring_cqe& cqe) {
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            arm_accept();  // Multishot ended (e.g. an error); re-arm
+        }
+        if (cqe.res < 0) {
+            return;
+        }
+        auto c = std::make_unique<Conn>();
+        c->fd = cqe.res;
+        socklen_t len = sizeof(c->peer);
+        getsockopt(c->fd, SOL_SOCKET, SO_PEERCRED, &c->peer, &len);
+        ++stats_.syscalls;
+        if (!peer_allowed(options_, c->peer)) {
+            ++stats_.rejected;
+            close(c->fd);
+            ++stats_.syscalls;
+            return;
+        }
+        ++stats_.accepted;
+        auto idx = static_cast<std::size_t>(c->fd);
+        if (conns_.size() <= idx) {
+            conns_.resize(idx + 1);
+        }
+        arm_recv(*c);
+        conns_[idx] = std::move(c);
+    }
+
+    void on_recv(Conn& c, const io_uring_cqe& cqe) {
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+        if (!more) {
+            c.recv_armed = false;
+        }
+        if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+            auto bid = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            ++stats_.reads;
+            consume(c, buffers_.get() + static_cast<std::size_t>(bid) * kBufSize,
+                    static_cast<std::size_t>(cqe.res));
+            recycle(bid);
+        } else if (cqe.res != -ENOBUFS) {
+            c.closing = true;  // EOF or error
+        }
+        if (!c.recv_armed && !c.closing) {
+            arm_recv(c);  // Out of buffers or the kernel stopped the multishot
+        }
+        maybe_close(c);
+    }
+
+    void on_send(Conn& c, const io_uring_cqe& cqe) {
+        c.send_inflight = false;
+        if (cqe.res < 0) {
+            c.closing = true;
+        } else {
+            c.send_pos += static_cast<std::size_t>(cqe.res);
+            if (c.send_pos < c.sending.size() && !c.closing) {
+                submit_send(c);
+                return;
+            }
+            c.sending.clear();
+            mark_dirty(c);
+        }
+        maybe_close(c);
+    }
+
+    void consume(Conn& c, const char* data, std::size_t n) {
+        if (c.partial_len > 0) {
+            std::size_t take = std::min(sizeof(Request) - c.partial_len, n);
+            std::memcpy(c.partial + c.partial_len, data, take);
+            c.partial_len += take;
+            data += take;
+            n -= take;
+            if (c.partial_len < sizeof(Request)) {
+                return;
+            }
+            respond(c, c.partial);
+            c.partial_len = 0;
+        }
+        std::size_t count = n / sizeof(Request);
+        for (std::size_t i = 0; i < count; ++i) {
+            respond(c, data + i * sizeof(Request));
+        }
+        c.partial_len = n - count * sizeof(Request);
+        std::memcpy(c.partial, data + count * sizeof(Request), c.partial_len);
+        mark_dirty(c);
+    }
+
+    void respond(Conn& c, const char* raw) {
+        Request req;
+        std::memcpy(&req, raw, sizeof(req));
+        ++stats_.requests;
+        Response resp = handle_request(options_, c.peer, req, stats_);
+        std::size_t base = c.pending.size();
+        c.pending.resize(base + sizeof(resp));
+        std::memcpy(c.pending.data() + base, &resp, sizeof(resp));
+    }
+
+    void mark_dirty(Conn& c) {
+        if (!c.dirty && !c.pending.empty()) {
+            c.dirty = true;
+            dirty_.push_back(&c);
+        }
+    }
+
+    // A connection is freed only once the kernel holds no request for it
+    void maybe_close(Conn& c) {
+        if (!c.closing || c.recv_armed || c.send_inflight) {
+            return;
+        }
+        if (c.dirty) {
+            dirty_.erase(std::find(dirty_.begin(), dirty_.end(), &c));
+        }
+        int fd = c.fd;
+        close(fd);
+        ++stats_.syscalls;
+        conns_[static_cast<std::size_t>(fd)].reset();
+    }
+
+    const ServerOptions& options_;
+    ServerStats& stats_;
+    int listen_fd_ = -1;
+    int signal_fd_ = -1;
+    int timer_fd_ = -1;
+    int ring_fd_ = -1;
+
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    std::size_t sq_len_ = 0;
+    std::size_t cq_len_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqes_len_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sq_local_tail_ = 0;
+    unsigned queued_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    io_uring_buf* bufs_ = nullptr;
+    std::uint16_t* buf_tail_ = nullptr;
+    std::size_t buf_ring_len_ = 0;
+    std::uint16_t buf_local_tail_ = 0;
+    std::unique_ptr<char[]> buffers_;
+
+    std::vector<std::unique_ptr<Conn>> conns_;  // Indexed by fd
+    std::vector<Conn*> dirty_;
+};
+
+}  // namespace
+
+std::unique_ptr<EventLoop> make_uring_loop(const ServerOptions& options, ServerStats& stats) {
+    auto loop = std::make_unique<UringServer>(options, stats);
+    if (!loop->setup()) {
+        return nullptr;
+    }
+    return loop;
+}
+
+}  // namespace os_daemon
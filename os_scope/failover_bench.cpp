@@ -0,0 +1,171 @@
+// os_scope_failover: takeover latency of the machine singleton
+//
+// Usage: os_scope_failover [rounds]
+// Each round SIGKILLs a serving primary and measures, from the kill, until a
+// client gets a response from the next holder:
+//   standby - the next holder was already running `--serve --standby`
+//   cold    - the next holder is started right after the kill
+// The standby's own "lock acquired -> published" time is read from the
+// status page.
+#include "daemon_protocol.hpp"
+#include "status_page.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// stdout of the child goes to `out_fd` (-1 = /dev/null)
+pid_t spawn(std::vector<const char*> args, int out_fd = -1) {
+    args.insert(args.begin(), OS_SCOPE_DEMO);
+    args.push_back(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_RDWR);
+        dup2(out_fd >= 0 ? out_fd : null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        dup2(null_fd, STDIN_FILENO);
+        execv(OS_SCOPE_DEMO, const_cast<char* const*>(args.data()));
+        _exit(127);
+    }
+    return pid;
+}
+
+void stop(pid_t pid, int sig) {
+    kill(pid, sig);
+    waitpid(pid, nullptr, 0);
+}
+
+bool ping() {
+    int fd = os_daemon::connect_daemon();
+    if (fd < 0) {
+        return false;
+    }
+    os_daemon::Request req{os_daemon::kPing, 1, 0};
+    os_daemon::Response resp{};
+    bool ok = write(fd, &req, sizeof(req)) == sizeof(req) &&
+              read(fd, &resp, sizeof(resp)) == sizeof(resp);
+    close(fd);
+    return ok;
+}
+
+// Until `pid` is the published holder and answers a request
+void wait_serving(pid_t pid) {
+    for (;;) {
+        os_daemon::LivenessResult r = os_daemon::check_liveness();
+        if (r.state == os_daemon::Liveness::kAlive &&
+            r.snapshot.pid == static_cast<std::uint32_t>(pid) && ping()) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// Until the standby prints that it is blocked on the lock
+void wait_standby(int pipe_fd) {
+    std::string seen;
+    char buf[256];
+    while (seen.find("waiting for the lock") == std::string::npos) {
+        ssize_t n = read(pipe_fd, buf, sizeof(buf));
+        if (n <= 0) {
+            std::cerr << "standby exited early\n";
+            std::exit(1);
+        }
+        seen.append(buf, static_cast<std::size_t>(n));
+    }
+    // flock() itself starts right after the message
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+struct Round {
+    double standby_ms;
+    double standby_internal_us;
+    double cold_ms;
+};
+
+Round run_round() {
+    Round r{};
+
+    // --- standby ---
+    pid_t primary = spawn({"--serve"});
+    wait_serving(primary);
+    int pipe_fds[2];
+    if (pipe(pipe_fds) < 0) {
+        std::perror("pipe");
+        std::exit(1);
+    }
+    pid_t standby = spawn({"--serve", "--standby"}, pipe_fds[1]);
+    close(pipe_fds[1]);
+    wait_standby(pipe_fds[0]);
+
+    std::uint64_t t0 = os_daemon::monotonic_ns();
+    kill(primary, SIGKILL);
+    wait_serving(standby);
+    r.standby_ms = static_cast<double>(os_daemon::monotonic_ns() - t0) / 1e6;
+    r.standby_internal_us =
+        static_cast<double>(os_daemon::check_liveness().snapshot.takeover_ns) / 1e3;
+    waitpid(primary, nullptr, 0);
+
+    // --- cold: the old standby is now the primary ---
+    t0 = os_daemon::monotonic_ns();
+    kill(standby, SIGKILL);
+    waitpid(standby, nullptr, 0);  // The lock is free once it is reaped
+    pid_t cold = spawn({"--serve"});
+    wait_serving(cold);
+    r.cold_ms = static_cast<double>(os_daemon::monotonic_ns() - t0) / 1e6;
+    close(pipe_fds[0]);
+    stop(cold, SIGINT);
+    return r;
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+    if (rounds <= 0 || os_daemon::check_liveness().state == os_daemon::Liveness::kAlive) {
+        std::cerr << "usage: " << argv[0] << " [rounds]  (with no singleton running)\n";
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "=== OS Scope Failover ===\n";
+    std::cout << "kill -9 primary -> first response from the next holder\n\n";
+    std::cout << std::setw(6) << "round" << std::setw(14) << "standby(ms)" << std::setw(16)
+              << "  internal(us)" << std::setw(12) << "cold(ms)" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::vector<double> standby;
+    std::vector<double> internal;
+    std::vector<double> cold;
+    for (int i = 0; i < rounds; ++i) {
+        Round r = run_round();
+        standby.push_back(r.standby_ms);
+        internal.push_back(r.standby_internal_us);
+        cold.push_back(r.cold_ms);
+        std::cout << std::setw(6) << i + 1 << std::setw(14) << r.standby_ms << std::setw(16)
+                  << r.standby_internal_us << std::setw(12) << r.cold_ms << "\n";
+    }
+    std::cout << std::setw(6) << "p50" << std::setw(14) << median(standby) << std::setw(16)
+              << median(internal) << std::setw(12) << median(cold) << "\n";
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "standby: blocked in flock(LOCK_EX), backend ready, holding the listening socket\n";
+    std::cout << "internal: the standby's own lock-acquired -> status-page-published time\n";
+    std::cout << "cold: exec + dynamic loading + backend setup after the lock is free\n";
+    return 0;
+}
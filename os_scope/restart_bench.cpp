@@ -0,0 +1,211 @@
+// os_scope_restart: warm restart from the state snapshot vs state size
+//
+// Usage: os_scope_restart [keys] [state_mb...]
+// For each state size: start a fresh daemon, add `keys` entries, wait until
+// a periodic snapshot has them, SIGKILL the daemon and start it again with
+// --restore=mmap and with --restore=read. Each restart is timed from spawn
+// to the first response (ready) and until every key has been read back and
+// checked (warm); anon is the restarted daemon's RssAnon after that (file
+// pages mapped from the page cache are not counted).
+#include "daemon_protocol.hpp"
+#include "daemon_state.hpp"
+#include "status_page.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kBatch = 256;  // Requests pipelined per write
+
+pid_t spawn(std::vector<std::string> args) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(OS_SCOPE_DEMO));
+        for (auto& a : args) {
+            argv.push_back(&a[0]);
+        }
+        argv.push_back(nullptr);
+        int null_fd = open("/dev/null", O_RDWR);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        dup2(null_fd, STDIN_FILENO);
+        execv(OS_SCOPE_DEMO, argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+void kill_wait(pid_t pid, int sig) {
+    kill(pid, sig);
+    waitpid(pid, nullptr, 0);
+}
+
+bool roundtrip(int fd, const std::vector<os_daemon::Request>& reqs,
+               std::vector<os_daemon::Response>& resps) {
+    std::size_t out = reqs.size() * sizeof(os_daemon::Request);
+    if (write(fd, reqs.data(), out) != static_cast<ssize_t>(out)) {
+        return false;
+    }
+    resps.resize(reqs.size());
+    auto* p = reinterpret_cast<char*>(resps.data());
+    std::size_t want = resps.size() * sizeof(os_daemon::Response);
+    while (want > 0) {
+        ssize_t n = read(fd, p, want);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        want -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Connected once the daemon answers a ping
+int wait_ready(pid_t pid) {
+    for (;;) {
+        if (waitpid(pid, nullptr, WNOHANG) == pid) {
+            std::cerr << "os_scope_demo exited before serving\n";
+            std::exit(1);
+        }
+        int fd = os_daemon::connect_daemon();
+        if (fd >= 0) {
+            std::vector<os_daemon::Response> resps;
+            if (roundtrip(fd, {{os_daemon::kPing, 0, 0}}, resps)) {
+                return fd;
+            }
+            close(fd);
+        }
+        std::this_thread::yield();
+    }
+}
+
+std::uint64_t expected(std::uint32_t key) { return key * 7ULL + 1; }
+
+// kAdd (fill) or kGet (check) for keys [0, keys); false on a mismatch
+bool run_keys(int fd, std::uint32_t keys, bool fill) {
+    std::vector<os_daemon::Request> reqs;
+    std::vector<os_daemon::Response> resps;
+    for (std::uint32_t first = 0; first < keys; first += kBatch) {
+        reqs.clear();
+        for (std::uint32_t k = first; k < keys && k < first + kBatch; ++k) {
+            std::uint64_t arg = fill ? (static_cast<std::uint64_t>(k) << 32) | expected(k) : k;
+            reqs.push_back({fill ? os_daemon::kAdd : os_daemon::kGet, k, arg});
+        }
+        if (!roundtrip(fd, reqs, resps)) {
+            return false;
+        }
+        for (const auto& r : resps) {
+            if (r.status != os_daemon::kOk || r.value != expected(r.seq)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Until the snapshot file on disk holds at least `mutations` changes
+void wait_snapshot(std::uint64_t mutations) {
+    for (;;) {
+        os_daemon::SnapshotHeader hdr{};
+        int fd = open(os_daemon::kSnapshotFile, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            bool ok = pread(fd, &hdr, sizeof(hdr), 0) == sizeof(hdr);
+            close(fd);
+            if (ok && hdr.mutations >= mutations) {
+                return;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+double anon_mb(pid_t pid) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 8, "RssAnon:") == 0) {
+            return std::strtod(line.c_str() + 8, nullptr) / 1024.0;
+        }
+    }
+    return 0.0;
+}
+
+void restart(const char* mode, std::size_t state_mb, std::uint32_t keys) {
+    std::uint64_t t0 = os_daemon::monotonic_ns();
+    pid_t pid = spawn({"--serve", std::string("--restore=") + mode, "--snapshot-ms=0"});
+    int fd = wait_ready(pid);
+    double ready_ms = static_cast<double>(os_daemon::monotonic_ns() - t0) / 1e6;
+    bool ok = run_keys(fd, keys, false);
+    double warm_ms = static_cast<double>(os_daemon::monotonic_ns() - t0) / 1e6;
+    double anon = anon_mb(pid);
+    close(fd);
+    // SIGKILL: a clean stop would rewrite the snapshot the next row reads
+    kill_wait(pid, SIGKILL);
+    std::cout << std::setw(10) << state_mb << std::setw(8) << mode << std::setw(12) << ready_ms
+              << std::setw(12) << warm_ms << std::setw(11) << anon
+              << (ok ? "" : "   KEYS MISSING") << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::uint32_t keys = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 2000;
+    std::vector<std::size_t> sizes;
+    for (int i = 2; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {16, 64, 256};
+    }
+    if (keys == 0 || os_daemon::check_liveness().state == os_daemon::Liveness::kAlive) {
+        std::cerr << "usage: " << argv[0] << " [keys] [state_mb...]  (with no singleton running)\n";
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "=== OS Scope Warm Restart ===\n";
+    std::cout << "keys=" << keys << " (working set), snapshot: " << os_daemon::kSnapshotFile << "\n\n";
+    std::cout << std::setw(10) << "state(MiB)" << std::setw(8) << "restore" << std::setw(12)
+              << "ready(ms)" << std::setw(12) << "warm(ms)" << std::setw(11) << "anon(MiB)" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (std::size_t mb : sizes) {
+        unlink(os_daemon::kSnapshotFile);
+        pid_t pid = spawn({"--serve", "--state-mb=" + std::to_string(mb), "--snapshot-ms=50"});
+        int fd = wait_ready(pid);
+        if (!run_keys(fd, keys, true)) {
+            std::cerr << "fill failed (table full?)\n";
+            kill_wait(pid, SIGKILL);
+            return 1;
+        }
+        close(fd);
+        wait_snapshot(keys);
+        kill_wait(pid, SIGKILL);
+
+        restart("mmap", mb, keys);
+        restart("read", mb, keys);
+    }
+    unlink(os_daemon::kSnapshotFile);
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "ready: spawn -> first response; includes restoring the snapshot\n";
+    std::cout << "warm: spawn -> every key read back; mmap checks each touched 4 KiB segment then\n";
+    std::cout << "mmap: header + checksum array up front, cost follows the keys touched\n";
+    std::cout << "read: whole file copied and every segment checked before serving\n";
+    return 0;
+}
@@ -1,3 +1,31 @@
+// os_scope_demo: machine-wide singleton via flock()
+//
+// Usage: os_scope_demo [--serve] [--standby] [--any-uid] [--backend=auto|epoll|uring]
+//                      [--state-mb=N] [--restore=mmap|read] [--snapshot-ms=N]
+//        os_scope_demo --status
+//        os_scope_demo --status-cost
+//   (default)  hold the lock until Enter
+//   --serve    hold the lock and serve clients on an abstract Unix socket
+//              until SIGINT/SIGTERM (see daemon_protocol.hpp, os_scope_load)
+//   --standby  if the lock is held, prepare (io_uring ring, buffers, a dup
+//              of the listening socket) and block in flock(LOCK_EX) until
+//              the holder goes away
+//   --any-uid  with --serve: accept clients of any uid (SO_PEERCRED)
+//   --backend  with --serve: event loop (auto = io_uring, else epoll)
+//   --state-mb with --serve: table size when starting without a snapshot (16)
+//   --restore  with --serve: how the snapshot is loaded (daemon_state.hpp)
+//   --snapshot-ms  with --serve: snapshot period, 0 = only at shutdown (1000)
+//   --status   check liveness through the status page (no lock taken)
+//   --status-cost  time check_liveness() against open + flock(LOCK_SH); the
+//              flock probes make a starting instance fail while this runs
+//
+// While holding the lock, the instance publishes /dev/shm/os_scope_status
+// (status_page.hpp).
+#include "daemon_protocol.hpp"
+#include "daemon_server.hpp"
+#include "daemon_state.hpp"
+#include "status_page.hpp"
+
 #include <iostream>
 #include <sys/file.h>
 #include <unistd.h>
@@ -5,10 +33,121 @@
 #include <cstdlib>
 #include <cerrno>
 #include <cstring>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <atomic>
+
+constexpr const char* LOCK_FILE = os_daemon::kLockFile;
+
+// What a health check would do without the status page
+static bool probe_with_flock() {
+    int fd = open(LOCK_FILE, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool held = flock(fd, LOCK_SH | LOCK_NB) < 0 && errno == EWOULDBLOCK;
+    close(fd);
+    return held;
+}
+
+static int print_status() {
+    os_daemon::LivenessResult r = os_daemon::check_liveness();
+    const os_daemon::StatusSnapshot& s = r.snapshot;
+    std::cout << "=== OS Scope: Singleton Status ===\n";
+    std::cout << "state      : "
+              << (r.state == os_daemon::Liveness::kAlive ? "alive" : "not running") << "\n";
+    std::cout << "decided by : " << (r.used_flock ? "flock fallback" : "status page (memory read)")
+              << "\n";
+    if (s.generation != 0) {
+        double age_ms = static_cast<double>(s.heartbeat_age_ns) / 1e6;
+        std::cout << "pid        : " << s.pid << (s.pid == 0 ? " (stopped cleanly)" : "") << "\n";
+        std::cout << "generation : " << s.generation << "\n";
+        std::cout << "heartbeat  : " << age_ms << " ms ago" << (r.heartbeat_fresh || s.pid == 0 ? "" : " (stale)")
+                  << "\n";
+        std::cout << "endpoint   : " << (s.endpoint[0] ? s.endpoint : "(not serving)") << "\n";
+        if (s.takeover_ns != 0) {
+            std::cout << "takeover   : " << static_cast<double>(s.takeover_ns) / 1e3
+                      << " us (this holder was a standby)\n";
+        }
+    }
+    return r.state == os_daemon::Liveness::kAlive ? 0 : 1;
+}
+
+// Cost of one check, both ways. Not part of --status: while the flock
+// probes run, an instance starting up sees the lock taken and exits
+static int print_status_cost() {
+    constexpr int kIters = 100000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIters; ++i) {
+        os_daemon::check_liveness();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIters; ++i) {
+        probe_with_flock();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    auto ns = [](auto d) { return std::chrono::duration<double, std::nano>(d).count() / kIters; };
+    std::cout << "=== OS Scope: Liveness Check Cost ===\n";
+    std::cout << "check_liveness() : " << ns(t1 - t0) << " ns/check\n";
+    std::cout << "open + flock     : " << ns(t2 - t1) << " ns/check\n";
+    return 0;
+}
+
+static void print_restore(const os_daemon::DaemonState& state) {
+    const os_daemon::RestoreInfo& info = state.restore_info();
+    if (info.restored) {
+        std::cout << "[" << getpid() << "] State restored from " << os_daemon::kSnapshotFile
+                  << " (generation " << info.generation << ", " << info.entries << " entries, "
+                  << (state.size() >> 20) << " MiB) in " << info.open_us << " us\n";
+    } else {
+        std::cout << "[" << getpid() << "] Starting with empty state (" << info.reason << ", "
+                  << (state.size() >> 20) << " MiB)\n";
+    }
+}
 
-constexpr const char* LOCK_FILE = "/tmp/os_scope_singleton.lock";
+int main(int argc, char** argv) {
+    bool serve = false;
+    bool standby = false;
+    std::size_t state_mb = 16;
+    unsigned snapshot_ms = 1000;
+    os_daemon::RestoreMode restore = os_daemon::RestoreMode::kMmap;
+    os_daemon::DaemonState state;
+    os_daemon::ServerOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--status") == 0) {
+            return print_status();
+        } else if (std::strcmp(argv[i], "--status-cost") == 0) {
+            return print_status_cost();
+        } else if (std::strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        } else if (std::strcmp(argv[i], "--standby") == 0) {
+            standby = true;
+        } else if (std::strcmp(argv[i], "--any-uid") == 0) {
+            options.same_uid_only = false;
+        } else if (std::strcmp(argv[i], "--backend=auto") == 0) {
+            options.backend = os_daemon::Backend::kAuto;
+        } else if (std::strcmp(argv[i], "--backend=epoll") == 0) {
+            options.backend = os_daemon::Backend::kEpoll;
+        } else if (std::strcmp(argv[i], "--backend=uring") == 0) {
+            options.backend = os_daemon::Backend::kUring;
+        } else if (std::strncmp(argv[i], "--state-mb=", 11) == 0) {
+            state_mb = std::strtoull(argv[i] + 11, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--restore=mmap") == 0) {
+            restore = os_daemon::RestoreMode::kMmap;
+        } else if (std::strcmp(argv[i], "--restore=read") == 0) {
+            restore = os_daemon::RestoreMode::kRead;
+        } else if (std::strncmp(argv[i], "--snapshot-ms=", 14) == 0) {
+            snapshot_ms = static_cast<unsigned>(std::strtoul(argv[i] + 14, nullptr, 10));
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--serve] [--standby] [--any-uid]"
+                      << " [--backend=auto|epoll|uring] [--state-mb=N] [--restore=mmap|read]"
+                      << " [--snapshot-ms=N] | --status | --status-cost\n";
+            return 2;
+        }
+    }
 
-int main() {
     std::cout << "=== OS Scope: Machine-Level Singleton Demo ===\n\n";
 
     // 1. Open or create lock file
@@ -20,18 +159,94 @@ int main() {
 
     std::cout << "[" << getpid() << "] Attempting to acquire exclusive lock...\n";
 
+    // The serving loop's tick beats the status page, so the heartbeat stops
+    // when the loop does. Snapshots are taken between batches of the same
+    // loop, so the forked writer sees a consistent table.
+    os_daemon::StatusPublisher status;
+    std::uint64_t next_snapshot_ns = 0;
+    options.state = &state;
+    options.tick_ms = snapshot_ms != 0 && snapshot_ms < os_daemon::kHeartbeatMs
+                          ? snapshot_ms
+                          : static_cast<unsigned>(os_daemon::kHeartbeatMs);
+    options.on_tick = [&state, &status, &next_snapshot_ns, snapshot_ms] {
+        status.beat();
+        std::uint64_t now = os_daemon::monotonic_ns();
+        if (snapshot_ms != 0 && now >= next_snapshot_ns) {
+            next_snapshot_ns = now + snapshot_ms * 1000000ULL;
+            state.snapshot_async();
+        }
+    };
+    os_daemon::Server server(options);
+    std::uint64_t lock_ns = 0;  // Non-zero: we took over from a previous holder
+
     // 2. Try to acquire exclusive lock (non-blocking)
     if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
-        if (errno == EWOULDBLOCK) {
-            std::cerr << "[" << getpid() << "] Another instance is already running!\n";
+        if (errno == EWOULDBLOCK && standby) {
+            // Hot standby: do everything that does not need the lock now,
+            // then sleep in the kernel until the holder's fd is closed
+            auto t0 = std::chrono::steady_clock::now();
+            bool adopted = false;
+            if (serve) {
+                server.prepare();
+                adopted = server.adopt_listener();
+            }
+            auto warm_us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - t0).count();
+            std::cout << "[" << getpid() << "] Standby: warmed up in " << warm_us << " us"
+                      << (adopted ? ", holding the listening socket" : "")
+                      << ", waiting for the lock...\n" << std::flush;
+            int rc;
+            while ((rc = flock(fd, LOCK_EX)) < 0 && errno == EINTR) {
+            }
+            lock_ns = os_daemon::monotonic_ns();
+            if (rc < 0) {
+                std::cerr << "[" << getpid() << "] flock failed: " << std::strerror(errno) << "\n";
+                close(fd);
+                return 1;
+            }
         } else {
-            std::cerr << "[" << getpid() << "] flock failed: " << std::strerror(errno) << "\n";
+            if (errno == EWOULDBLOCK) {
+                std::cerr << "[" << getpid() << "] Another instance is already running!\n";
+            } else {
+                std::cerr << "[" << getpid() << "] flock failed: " << std::strerror(errno) << "\n";
+            }
+            close(fd);
+            return 1;
         }
+    } else if (serve) {
+        server.prepare();
+    }
+
+    // 3. Lock acquired - we are the singleton. Only the lock holder ever
+    // reads or writes the snapshot, and only the lock holder binds the
+    // socket, so "connect succeeded" implies "talking to the singleton".
+    if (serve && !state.open(state_mb << 20, restore)) {
+        std::cerr << "[" << getpid() << "] cannot map " << state_mb << " MiB of state\n";
+        close(fd);
+        return 1;
+    }
+    if (serve && !server.listen()) {
         close(fd);
         return 1;
     }
 
-    // 3. Lock acquired - we are the singleton
+    // Health checks read this page instead of probing the lock
+    std::string endpoint = serve ? std::string("@") + os_daemon::kSocketName : std::string();
+    bool published = status.start(endpoint.c_str(), lock_ns);
+
+    if (lock_ns != 0) {
+        const os_daemon::StatusSnapshot& prev = status.previous();
+        std::cout << "[" << getpid() << "] Took over in "
+                  << static_cast<double>(status.takeover_ns()) / 1e3
+                  << " us (lock acquired -> listening + status page)\n";
+        if (prev.generation != 0) {
+            std::cout << "[" << getpid() << "] Previous holder: pid " << prev.pid << ", generation "
+                      << prev.generation << ", last heartbeat "
+                      << static_cast<double>(prev.heartbeat_age_ns) / 1e6 << " ms before takeover"
+                      << (prev.pid == 0 ? " (stopped cleanly)" : "") << "\n";
+        }
+    }
+
     std::cout << "[" << getpid() << "] Lock acquired! This is the singleton instance.\n";
     std::cout << "[" << getpid() << "] Lock file: " << LOCK_FILE << "\n\n";
 
@@ -40,10 +255,38 @@ int main() {
     std::cout << "Only ONE process on this machine can hold LOCK_EX at a time.\n";
     std::cout << "The lock is automatically released when fd is closed or process exits.\n\n";
 
-    std::cout << "Press Enter to release lock and exit...\n";
-    std::cin.get();
+    if (published) {
+        std::cout << "[" << getpid() << "] Status page " << os_daemon::kStatusName
+                  << " published (generation " << status.generation() << ")\n";
+    }
+
+    if (serve) {
+        print_restore(state);
+        server.run();
+        os_daemon::print_stats(server.stats());
+        bool saved = state.snapshot_now();
+        std::cout << "segments checked : " << state.segments_validated() << " ("
+                  << state.segments_corrupt() << " corrupt, dropped)\n";
+        std::cout << "snapshots        : " << state.snapshots()
+                  << (saved ? " (final one written at shutdown)" : " (final snapshot FAILED)") << "\n";
+    } else {
+        // No serving loop here: a timer thread keeps the heartbeat fresh so
+        // --status stays a memory read while we wait for Enter
+        std::atomic<bool> waiting{true};
+        std::thread beat([&status, &waiting] {
+            while (waiting.load(std::memory_order_relaxed)) {
+                status.beat();
+                std::this_thread::sleep_for(std::chrono::milliseconds(os_daemon::kHeartbeatMs));
+            }
+        });
+        std::cout << "Press Enter to release lock and exit...\n";
+        std::cin.get();
+        waiting.store(false, std::memory_order_relaxed);
+        beat.join();
+    }
 
     // 4. Lock is automatically released when fd is closed
+    status.stop();
     close(fd);
     std::cout << "[" << getpid() << "] Lock released. Daemon exiting.\n";
 
@@ -0,0 +1,173 @@
+#include "status_page.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+namespace os_daemon {
+
+namespace {
+
+constexpr std::size_t kPageSize = 4096;
+static_assert(sizeof(StatusPage) <= kPageSize, "one page");
+
+// The reader's mapping is kept for the life of the process; holders reuse
+// the same object, so it stays valid across daemon restarts
+const StatusPage* map_for_read() {
+    static std::atomic<const StatusPage*> mapped{nullptr};
+    const StatusPage* page = mapped.load(std::memory_order_acquire);
+    if (page) {
+        return page;
+    }
+    int fd = shm_open(kStatusName, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;  // No holder has ever started; retried next call
+    }
+    void* addr = mmap(nullptr, kPageSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    const StatusPage* expected = nullptr;
+    if (!mapped.compare_exchange_strong(expected, static_cast<const StatusPage*>(addr))) {
+        munmap(addr, kPageSize);  // Another thread won
+        return expected;
+    }
+    return static_cast<const StatusPage*>(addr);
+}
+
+bool read_snapshot(const StatusPage& page, StatusSnapshot& out) {
+    if (__atomic_load_n(&page.magic, __ATOMIC_ACQUIRE) != kStatusMagic) {
+        return false;  // Being created right now
+    }
+    for (unsigned attempt = 0;; ++attempt) {
+        if (attempt == 1000) {
+            return false;  // A holder died mid-publish; let flock decide
+        }
+        std::uint64_t s1 = page.seq.load(std::memory_order_acquire);
+        if (s1 & 1) {
+            continue;
+        }
+        out.pid = page.pid;
+        out.generation = page.generation;
+        out.started_ns = page.started_ns;
+        out.takeover_ns = page.takeover_ns;
+        std::memcpy(out.endpoint, page.endpoint, sizeof(out.endpoint));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (page.seq.load(std::memory_order_relaxed) == s1) {
+            break;
+        }
+    }
+    out.endpoint[kEndpointSize - 1] = '\0';
+    std::uint64_t beat = page.heartbeat_ns.load(std::memory_order_acquire);
+    std::uint64_t now = monotonic_ns();
+    out.heartbeat_age_ns = now > beat ? now - beat : 0;
+    return true;
+}
+
+}  // namespace
+
+std::uint64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);  // vDSO: no syscall
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+bool StatusPublisher::start(const char* endpoint, std::uint64_t lock_ns) {
+    int fd = shm_open(kStatusName, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0 || ftruncate(fd, kPageSize) < 0) {
+        std::cerr << "[" << getpid() << "] status page " << kStatusName << ": "
+                  << std::strerror(errno) << "\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    void* addr = mmap(nullptr, kPageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[" << getpid() << "] status page mmap: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    page_ = static_cast<StatusPage*>(addr);
+
+    // Only the flock holder writes, so the read-modify-write needs no lock.
+    // A fresh (zero-filled) page has no magic yet: seq and heartbeat start at 0.
+    bool existed = page_->magic == kStatusMagic;
+    if (existed) {
+        read_snapshot(*page_, previous_);
+    }
+    generation_ = (existed ? page_->generation : 0) + 1;
+    std::uint64_t seq = page_->seq.load(std::memory_order_relaxed) | 1;
+    page_->seq.store(seq, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page_->pid = static_cast<std::uint32_t>(getpid());
+    page_->generation = generation_;
+    page_->started_ns = monotonic_ns();
+    takeover_ns_ = lock_ns != 0 ? page_->started_ns - lock_ns : 0;
+    page_->takeover_ns = takeover_ns_;
+    std::memset(page_->endpoint, 0, sizeof(page_->endpoint));
+    std::strncpy(page_->endpoint, endpoint, sizeof(page_->endpoint) - 1);
+    page_->heartbeat_ns.store(page_->started_ns, std::memory_order_relaxed);
+    page_->page_size = kPageSize;
+    page_->seq.store(seq + 1, std::memory_order_release);
+    __atomic_store_n(&page_->magic, kStatusMagic, __ATOMIC_RELEASE);
+    return true;
+}
+
+void StatusPublisher::beat() {
+    if (page_) {
+        page_->heartbeat_ns.store(monotonic_ns(), std::memory_order_release);
+    }
+}
+
+void StatusPublisher::stop() {
+    if (!page_) {
+        return;
+    }
+    std::uint64_t seq = page_->seq.load(std::memory_order_relaxed);
+    page_->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page_->pid = 0;
+    page_->seq.store(seq + 2, std::memory_order_release);
+    munmap(page_, kPageSize);
+    page_ = nullptr;
+}
+
+LivenessResult check_liveness() {
+    LivenessResult r;
+    const StatusPage* page = map_for_read();
+    if (page && read_snapshot(*page, r.snapshot)) {
+        // pid 0 (the last holder stopped) is not conclusive either: a new
+        // holder may already have the lock and not have published yet
+        if (r.snapshot.pid != 0 && r.snapshot.heartbeat_age_ns < kStaleMs * 1000000ULL) {
+            r.state = Liveness::kAlive;
+            r.heartbeat_fresh = true;
+            return r;
+        }
+    }
+
+    // Stopped, stale or missing: the lock is the source of truth. LOCK_SH
+    // conflicts with the holder's LOCK_EX but not with other probes.
+    r.used_flock = true;
+    int fd = open(kLockFile, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return r;
+    }
+    if (flock(fd, LOCK_SH | LOCK_NB) < 0) {
+        if (errno == EWOULDBLOCK) {
+            r.state = Liveness::kAlive;  // Held, but not beating (stopped, or overloaded)
+        }
+    }
+    close(fd);  // Releases our LOCK_SH, if we got it
+    return r;
+}
+
+}  // namespace os_daemon
@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Liveness page of the os_scope singleton.
+//
+// The flock holder publishes one page of POSIX shared memory: its pid, a
+// start generation, a CLOCK_MONOTONIC heartbeat and the endpoint clients
+// connect to. Checking "is the singleton up?" is then a memory read plus a
+// vDSO clock_gettime, instead of open + flock on the lock file (which, when
+// it succeeds, briefly holds the lock itself). flock is only the fallback
+// when the heartbeat is stale or the page does not exist yet.
+namespace os_daemon {
+
+constexpr const char* kLockFile = "/tmp/os_scope_singleton.lock";
+constexpr char kStatusName[] = "/os_scope_status";
+constexpr std::uint32_t kStatusMagic = 0x4f535354;  // "OSST"
+constexpr std::uint64_t kHeartbeatMs = 100;
+constexpr std::uint64_t kStaleMs = 500;  // Heartbeat older than this -> ask flock
+constexpr std::size_t kEndpointSize = 108;  // sizeof(sockaddr_un::sun_path)
+
+// Shared layout. The identity fields change only when a holder starts or
+// stops, under `seq` (odd while being rewritten); the heartbeat is a single
+// word on its own cache line so readers do not contend with it.
+struct StatusPage {
+    std::uint32_t magic;
+    std::uint32_t page_size;
+    std::atomic<std::uint64_t> seq;
+    std::uint32_t pid;         // 0 = the last holder stopped cleanly
+    std::uint32_t reserved;
+    std::uint64_t generation;  // +1 per holder that ever started
+    std::uint64_t started_ns;  // CLOCK_MONOTONIC
+    std::uint64_t takeover_ns; // Standby: lock acquired -> published; 0 = cold start
+    char endpoint[kEndpointSize];
+    alignas(64) std::atomic<std::uint64_t> heartbeat_ns;
+};
+
+struct StatusSnapshot {
+    std::uint32_t pid = 0;
+    std::uint64_t generation = 0;
+    std::uint64_t started_ns = 0;
+    std::uint64_t heartbeat_age_ns = 0;
+    std::uint64_t takeover_ns = 0;
+    char endpoint[kEndpointSize] = {};
+};
+
+enum class Liveness {
+    kAlive,       // Fresh heartbeat, or stale but the lock is held
+    kNotRunning,  // No holder (page says stopped, or flock succeeded)
+};
+
+struct LivenessResult {
+    Liveness state = Liveness::kNotRunning;
+    bool used_flock = false;  // The memory read was not conclusive
+    bool heartbeat_fresh = false;
+    StatusSnapshot snapshot;
+};
+
+// Run by the lock holder: publishes the page; the serving loop calls beat()
+// from its own tick, so a wedged loop shows up as a stale heartbeat (without
+// --serve, a timer thread beats it instead)
+class StatusPublisher {
+public:
+    StatusPublisher() = default;
+    ~StatusPublisher() { stop(); }
+
+    StatusPublisher(const StatusPublisher&) = delete;
+    StatusPublisher& operator=(const StatusPublisher&) = delete;
+
+    // false (with a message) if the page cannot be created. lock_ns is the
+    // CLOCK_MONOTONIC time a standby got the lock (0 for a cold start); the
+    // takeover latency up to this publish is recorded in the page.
+    bool start(const char* endpoint, std::uint64_t lock_ns = 0);
+
+    // Call about every kHeartbeatMs from the loop whose liveness the page reports
+    void beat();
+
+    // Marks the page stopped (pid = 0); a crash leaves the heartbeat to go stale
+    void stop();
+
+    std::uint64_t generation() const { return generation_; }
+    std::uint64_t takeover_ns() const { return takeover_ns_; }
+
+    // What the page said before we overwrote it (generation 0 = nothing)
+    const StatusSnapshot& previous() const { return previous_; }
+
+private:
+    StatusPage* page_ = nullptr;
+    std::uint64_t generation_ = 0;
+    std::uint64_t takeover_ns_ = 0;
+    StatusSnapshot previous_;
+};
+
+// Memory read first; falls back to flock(LOCK_SH | LOCK_NB) on kLockFile only
+// when the page is missing, says stopped, or the heartbeat is stale
+LivenessResult check_liveness();
+
+std::uint64_t monotonic_ns();
+
+}  // namespace os_daemon
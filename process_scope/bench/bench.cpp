@@ -0,0 +1,54 @@
+// process_scope_bench: the process_scope strategies' hot paths side by side
+//
+// Runs one probe executable per variant (each needs a different owner for
+// the singleton, so they cannot share a process) and prints CSV:
+//
+//   variant,threads,ns_per_call,first_access_us,load_us
+//
+//   ns_per_call     - accessor call from a dlopen'ed plugin, slowest thread
+//                     when `threads` threads call it concurrently
+//   first_access_us - first accessor call right after dlopen (lazy binding,
+//                     dlsym lookup, shm_open/mmap), median of fresh children
+//   load_us         - dlopen(RTLD_LAZY) of the plugin, median of fresh
+//                     children (includes libprocess_core's logger ctor)
+//
+// Usage: process_scope_bench [iterations] [load_samples] [max_threads]
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const char* variants[] = {"core", "core_api", "main_owner", "dlsym", "shm", "hot_swap"};
+
+    std::string self(argv[0]);
+    std::string dir = self.substr(0, self.rfind('/') + 1);
+
+    std::printf("variant,threads,ns_per_call,first_access_us,load_us\n");
+    std::fflush(stdout);
+
+    int failures = 0;
+    for (const char* variant : variants) {
+        std::string probe = dir + "process_scope_bench_" + variant;
+        std::vector<char*> args{probe.data()};
+        for (int i = 1; i < argc; ++i) {
+            args.push_back(argv[i]);
+        }
+        args.push_back(nullptr);
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            execv(probe.c_str(), args.data());
+            std::perror(probe.c_str());
+            _exit(127);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+// Every process_scope_bench plugin exports the same two entry points around
+// its variant's accessor expression:
+//   bench_access()  - one accessor call (timed on first use = resolution cost)
+//   bench_loop(n)   - n accessor calls, the libA_entry()-style hot path
+// Exported explicitly, so plugins built -fvisibility=hidden work too.
+#define PROCESS_BENCH_EXPORT extern "C" __attribute__((visibility("default")))
+
+#define PROCESS_BENCH_PLUGIN(expr)                                            \
+    PROCESS_BENCH_EXPORT const void* bench_access() {                         \
+        return &(expr);                                                       \
+    }                                                                         \
+    PROCESS_BENCH_EXPORT std::uintptr_t bench_loop(std::uint64_t n) {         \
+        std::uintptr_t sum = 0;                                               \
+        for (std::uint64_t i = 0; i < n; ++i) {                               \
+            sum += reinterpret_cast<std::uintptr_t>(&(expr));                 \
+            asm volatile("" : "+r"(sum));                                     \
+        }                                                                     \
+        return sum;                                                           \
+    }
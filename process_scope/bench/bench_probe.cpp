@@ -0,0 +1,248 @@
+// One process_scope_bench probe per variant (PROBE_VARIANT / PROBE_PLUGIN are
+// set by CMakeLists.txt). Prints CSV rows without a header to stdout:
+//   variant,threads,ns_per_call,first_access_us,load_us
+// and, when race_threads > 0, one first-access race row (singleton_bench):
+//   #race,variant,threads,max_us,p50_us
+//
+// Usage: process_scope_bench_<variant> [iterations] [load_samples] [max_threads]
+//                                      [race_threads]
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#ifndef PROBE_VARIANT
+#define PROBE_VARIANT "unknown"
+#endif
+#ifndef PROBE_PLUGIN
+#define PROBE_PLUGIN "libprocess_bench_plugin.so"
+#endif
+
+#if PROBE_OWNS_LOGGER
+#include "process_logger.hpp"
+
+// main_owner / dlsym_default: the probe is the owner executable
+extern "C" ProcessLogger& get_process_logger() {
+    static ProcessLogger instance("process_scope_bench");
+    return instance;
+}
+#endif
+
+using AccessFn = const void* (*)();
+using LoopFn = std::uintptr_t (*)(std::uint64_t);
+
+struct LoadSample {
+    double load_us;
+    double first_us;
+};
+
+// dlopen + first accessor call in a fresh child, so every sample pays symbol
+// binding, the variant's own resolution (dlsym, shm_open/mmap) and any ctor
+static LoadSample median_load(int samples) {
+    std::vector<double> load;
+    std::vector<double> first;
+    for (int s = 0; s < samples; ++s) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            LoadSample r{-1, -1};
+            auto t0 = std::chrono::steady_clock::now();
+            void* h = dlopen(PROBE_PLUGIN, RTLD_LAZY | RTLD_LOCAL);
+            auto t1 = std::chrono::steady_clock::now();
+            if (h) {
+                auto access = reinterpret_cast<AccessFn>(dlsym(h, "bench_access"));
+                auto t2 = std::chrono::steady_clock::now();
+                const void* p = access ? access() : nullptr;
+                auto t3 = std::chrono::steady_clock::now();
+                asm volatile("" : : "r"(p));
+                r.load_us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+                r.first_us = p ? std::chrono::duration<double, std::micro>(t3 - t2).count() : -1;
+            }
+            ssize_t ignored = write(fds[1], &r, sizeof(r));
+            (void)ignored;
+            _exit(0);
+        }
+        close(fds[1]);
+        LoadSample r{-1, -1};
+        if (read(fds[0], &r, sizeof(r)) == sizeof(r) && r.load_us >= 0 && r.first_us >= 0) {
+            load.push_back(r.load_us);
+            first.push_back(r.first_us);
+        }
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+    }
+    if (load.empty()) {
+        return {-1, -1};
+    }
+    std::sort(load.begin(), load.end());
+    std::sort(first.begin(), first.end());
+    return {load[load.size() / 2], first[first.size() / 2]};
+}
+
+struct RaceSample {
+    double max_us;
+    double p50_us;
+};
+
+// `threads` threads released together into the first accessor call of a
+// fresh child (call_once, dlsym table, shm_open/mmap, first-use ctor); the
+// latency of each runs from the release to its own return
+static RaceSample median_race(int samples, unsigned threads) {
+    std::vector<double> max;
+    std::vector<double> p50;
+    for (int s = 0; s < samples; ++s) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            RaceSample r{-1, -1};
+            void* h = dlopen(PROBE_PLUGIN, RTLD_LAZY | RTLD_LOCAL);
+            auto access = h ? reinterpret_cast<AccessFn>(dlsym(h, "bench_access")) : nullptr;
+            if (access) {
+                std::atomic<unsigned> ready{0};
+                std::atomic<bool> go{false};
+                std::chrono::steady_clock::time_point start;
+                std::vector<double> us(threads);
+                std::vector<std::thread> pool;
+                for (unsigned t = 0; t < threads; ++t) {
+                    pool.emplace_back([&, t] {
+                        ready.fetch_add(1);
+                        while (!go.load(std::memory_order_acquire)) {
+                            std::this_thread::yield();
+                        }
+                        const void* p = access();
+                        auto end = std::chrono::steady_clock::now();
+                        asm volatile("" : : "r"(p));
+                        us[t] = std::chrono::duration<double, std::micro>(end - start).count();
+                    });
+                }
+                while (ready.load() != threads) {
+                    std::this_thread::yield();
+                }
+                start = std::chrono::steady_clock::now();
+                go.store(true, std::memory_order_release);
+                for (auto& th : pool) {
+                    th.join();
+                }
+                std::sort(us.begin(), us.end());
+                r = {us.back(), us[us.size() / 2]};
+            }
+            ssize_t ignored = write(fds[1], &r, sizeof(r));
+            (void)ignored;
+            _exit(0);
+        }
+        close(fds[1]);
+        RaceSample r{-1, -1};
+        if (read(fds[0], &r, sizeof(r)) == sizeof(r) && r.max_us >= 0) {
+            max.push_back(r.max_us);
+            p50.push_back(r.p50_us);
+        }
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+    }
+    if (max.empty()) {
+        return {-1, -1};
+    }
+    std::sort(max.begin(), max.end());
+    std::sort(p50.begin(), p50.end());
+    return {max[max.size() / 2], p50[p50.size() / 2]};
+}
+
+static double ns_per_call(LoopFn loop, std::uint64_t iters) {
+    auto start = std::chrono::steady_clock::now();
+    std::uintptr_t sum = loop(iters);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    asm volatile("" : : "r"(sum));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+// All threads start together; report the slowest thread's ns/call
+static double ns_per_call_mt(LoopFn loop, std::uint64_t iters, unsigned threads) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<double> results(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            results[t] = ns_per_call(loop, iters);
+        });
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) {
+        th.join();
+    }
+    return *std::max_element(results.begin(), results.end());
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000ULL;
+    int samples = argc > 2 ? std::atoi(argv[2]) : 21;
+    int max_arg = argc > 3 ? std::atoi(argv[3])
+                           : static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    int race_arg = argc > 4 ? std::atoi(argv[4]) : 0;
+    if (iters == 0 || samples <= 0 || max_arg < 1 || race_arg < 0) {
+        std::fprintf(stderr, "usage: %s [iterations] [load_samples] [max_threads] [race_threads]\n",
+                     argv[0]);
+        return 2;
+    }
+    unsigned max_threads = static_cast<unsigned>(max_arg);
+    unsigned race_threads = static_cast<unsigned>(race_arg);
+
+    // CSV goes to the original stdout; logger ctor / [shm] chatter goes nowhere
+    std::FILE* out = fdopen(dup(STDOUT_FILENO), "w");
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+
+    LoadSample ls = median_load(samples);
+    RaceSample race = race_threads ? median_race(samples, race_threads) : RaceSample{-1, -1};
+
+    void* h = dlopen(PROBE_PLUGIN, RTLD_NOW | RTLD_LOCAL);
+    auto loop = h ? reinterpret_cast<LoopFn>(dlsym(h, "bench_loop")) : nullptr;
+    if (!loop) {
+        std::fprintf(stderr, "%s: cannot load %s: %s\n", PROBE_VARIANT, PROBE_PLUGIN, dlerror());
+        return 1;
+    }
+    loop(iters / 10);  // Warm up: resolve, construct, fault in pages
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    if (thread_counts.back() != max_threads) {
+        thread_counts.push_back(max_threads);
+    }
+    for (unsigned t : thread_counts) {
+        double ns = t == 1 ? ns_per_call(loop, iters) : ns_per_call_mt(loop, iters, t);
+        std::fprintf(out, "%s,%u,%.3f,%.3f,%.3f\n", PROBE_VARIANT, t, ns, ls.first_us, ls.load_us);
+    }
+    if (race_threads) {
+        std::fprintf(out, "#race,%s,%u,%.3f,%.3f\n", PROBE_VARIANT, race_threads, race.max_us,
+                     race.p50_us);
+    }
+    std::fclose(out);
+    return 0;
+}
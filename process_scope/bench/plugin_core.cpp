@@ -0,0 +1,5 @@
+// core_shared_lib: call into libprocess_core.so through the PLT
+#include "bench_plugin.hpp"
+#include "core_api.hpp"
+
+PROCESS_BENCH_PLUGIN(get_process_logger())
@@ -0,0 +1,17 @@
+// core_shared_lib via the versioned ProcessCoreApi table (fetched on first use)
+#include "bench_plugin.hpp"
+#include "core_api.hpp"
+#include <cstdlib>
+
+static const ProcessCoreApi* core_api() {
+    static const ProcessCoreApi* const api = [] {
+        const ProcessCoreApi* table = process_core_api(1);
+        if (!table) {
+            std::abort();
+        }
+        return table;
+    }();
+    return api;
+}
+
+PROCESS_BENCH_PLUGIN(*core_api()->logger)
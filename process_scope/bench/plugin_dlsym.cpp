@@ -0,0 +1,5 @@
+// dlsym_default: shared DlsymTable (acquire load) + indirect call into main
+#include "bench_plugin.hpp"
+#include "dso_common.hpp"
+
+PROCESS_BENCH_PLUGIN(get_logger_via_dlsym())
@@ -0,0 +1,5 @@
+// hot_swap: a ReadSection (epoch publish) + one acquire load of the instance
+#include "bench_plugin.hpp"
+#include "hot_swap_logger.hpp"
+
+PROCESS_BENCH_PLUGIN(get_process_logger(hot_swap::ReadSection()))
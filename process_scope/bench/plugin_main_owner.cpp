@@ -0,0 +1,7 @@
+// main_owner: get_process_logger() is bound against the probe executable
+#include "bench_plugin.hpp"
+
+struct ProcessLogger;
+extern "C" ProcessLogger& get_process_logger();
+
+PROCESS_BENCH_PLUGIN(get_process_logger())
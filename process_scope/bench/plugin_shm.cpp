@@ -0,0 +1,5 @@
+// shared_memory: std::call_once + mapped ShmBlock inside libshm_helper.so
+#include "bench_plugin.hpp"
+#include "shm_logger.hpp"
+
+PROCESS_BENCH_PLUGIN(get_shm_logger())
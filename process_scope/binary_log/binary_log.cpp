@@ -0,0 +1,191 @@
+#include "binary_log.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace binary_log {
+
+std::atomic<Writer*> g_writer{nullptr};
+
+namespace {
+
+std::atomic<std::uint32_t> g_generation{0};
+std::mutex g_open_mutex;
+
+// Definition records are written through the same reserve() as events
+void write_definition(Writer& w, RecordType type, std::uint16_t tag, std::uint16_t site,
+                      const void* payload, std::size_t len, std::uint8_t nargs) {
+    std::size_t size = sizeof(RecordHeader) + pad8(len);
+    auto* p = static_cast<char*>(w.reserve(size));
+    if (!p) {
+        return;
+    }
+    RecordHeader hdr{0, type, nargs, tag, site, now_ns()};
+    std::memcpy(p, &hdr, sizeof(hdr));
+    std::memcpy(p + sizeof(hdr), payload, len);
+    std::memset(p + sizeof(hdr) + len, 0, pad8(len) - len);
+    __atomic_store_n(reinterpret_cast<std::uint16_t*>(p), static_cast<std::uint16_t>(size),
+                     __ATOMIC_RELEASE);
+}
+
+}  // namespace
+
+Writer* Writer::create(const char* path, std::size_t chunk_size, std::uint32_t generation) {
+    long page = sysconf(_SC_PAGESIZE);
+    chunk_size = (chunk_size + static_cast<std::size_t>(page) - 1) & ~static_cast<std::size_t>(page - 1);
+    if (chunk_size < 64 * 1024) {
+        chunk_size = 64 * 1024;  // A record is at most 64 KiB
+    }
+
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::perror(path);
+        return nullptr;
+    }
+    // Never deleted once returned: a thread may still hold the pointer after
+    // close(). Until then nobody else has seen it.
+    auto* w = new Writer();
+    w->fd_ = fd;
+    w->chunk_size_ = chunk_size;
+    w->generation_ = generation;
+    if (!w->map_chunk()) {
+        ::close(fd);
+        delete w;
+        return nullptr;
+    }
+
+    Chunk* first = w->chunks_.front();
+    FileHeader fh{};
+    std::memcpy(fh.magic, kMagic, sizeof(kMagic));
+    fh.chunk_size = chunk_size;
+    std::memcpy(first->base, &fh, sizeof(fh));
+    first->used.store(sizeof(fh), std::memory_order_relaxed);
+    return w;
+}
+
+// Preallocate and map the next chunk of the file (grow_mutex_ held or
+// during create)
+bool Writer::map_chunk() {
+    off_t offset = static_cast<off_t>(chunks_.size() * chunk_size_);
+    int err = posix_fallocate(fd_, offset, static_cast<off_t>(chunk_size_));
+    if (err != 0) {
+        std::fprintf(stderr, "[binary_log] posix_fallocate: %s\n", std::strerror(err));
+        return false;
+    }
+    void* addr = mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, offset);
+    if (addr == MAP_FAILED) {
+        std::perror("[binary_log] mmap");
+        return false;
+    }
+    auto* c = new Chunk{static_cast<char*>(addr), chunk_size_, {0}};
+    chunks_.push_back(c);
+    chunk_.store(c, std::memory_order_release);
+    return true;
+}
+
+void* Writer::reserve_slow(std::size_t bytes, Chunk* seen) {
+    if (bytes > chunk_size_) {
+        return nullptr;
+    }
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(grow_mutex_);
+            // The tail of `seen` stays zero, which readers treat as end-of-chunk
+            if (chunk_.load(std::memory_order_relaxed) == seen && !map_chunk()) {
+                return nullptr;
+            }
+        }
+        Chunk* c = chunk_.load(std::memory_order_acquire);
+        std::uint64_t off = c->used.fetch_add(bytes, std::memory_order_relaxed);
+        if (off + bytes <= c->size) {
+            return c->base + off;
+        }
+        seen = c;
+    }
+}
+
+std::uint16_t Writer::intern_tag(const char* tag) {
+    std::lock_guard<std::mutex> lock(intern_mutex_);
+    std::size_t i = 0;
+    for (; i < kMaxTags; ++i) {
+        const char* t = tags_[i].load(std::memory_order_relaxed);
+        if (t == tag) {
+            return static_cast<std::uint16_t>(i + 1);
+        }
+        if (!t) {
+            break;
+        }
+    }
+    if (i == kMaxTags) {
+        return 0;  // Decoded as "?"
+    }
+    auto id = static_cast<std::uint16_t>(i + 1);
+    write_definition(*this, kDefineTag, id, 0, tag, std::strlen(tag) + 1, 0);
+    tags_[i].store(tag, std::memory_order_release);
+    return id;
+}
+
+std::uint16_t Writer::intern_site(CallSite& site, const ArgType* types, std::uint8_t n) {
+    std::lock_guard<std::mutex> lock(intern_mutex_);
+    std::uint64_t c = site.cached.load(std::memory_order_relaxed);
+    if ((c >> 16) == generation_) {
+        return static_cast<std::uint16_t>(c & 0xffff);
+    }
+    auto id = static_cast<std::uint16_t>(++next_site_);
+
+    // Payload: n argument types, then "file:line\0fmt\0"
+    char loc[32];
+    int loc_len = std::snprintf(loc, sizeof(loc), ":%d", site.line);
+    std::vector<char> payload(types, types + n);
+    payload.insert(payload.end(), site.file, site.file + std::strlen(site.file));
+    payload.insert(payload.end(), loc, loc + loc_len);
+    payload.push_back('\0');
+    payload.insert(payload.end(), site.fmt, site.fmt + std::strlen(site.fmt) + 1);
+    write_definition(*this, kDefineSite, 0, id, payload.data(), payload.size(), n);
+
+    site.cached.store((static_cast<std::uint64_t>(generation_) << 16) | id,
+                      std::memory_order_release);
+    return id;
+}
+
+std::uint64_t Writer::bytes_used() const {
+    std::uint64_t full = (chunks_.size() - 1) * chunk_size_;
+    std::uint64_t last = chunks_.back()->used.load(std::memory_order_relaxed);
+    return full + (last < chunk_size_ ? last : chunk_size_);
+}
+
+void Writer::finish() {
+    std::uint64_t used = bytes_used();
+    for (Chunk* c : chunks_) {
+        munmap(c->base, c->size);
+    }
+    if (ftruncate(fd_, static_cast<off_t>(used)) != 0) {
+        std::perror("[binary_log] ftruncate");
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool open(const char* path, std::size_t chunk_size) {
+    std::lock_guard<std::mutex> lock(g_open_mutex);
+    if (g_writer.load(std::memory_order_relaxed)) {
+        std::fprintf(stderr, "[binary_log] already open\n");
+        return false;
+    }
+    Writer* w = Writer::create(path, chunk_size, g_generation.fetch_add(1) + 1);
+    g_writer.store(w, std::memory_order_release);
+    return w != nullptr;
+}
+
+void close() {
+    std::lock_guard<std::mutex> lock(g_open_mutex);
+    if (Writer* w = g_writer.exchange(nullptr)) {
+        w->finish();
+    }
+}
+
+}  // namespace binary_log
@@ -0,0 +1,256 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Binary, memory-mapped log for ProcessLogger call sites.
+//
+//   binary_log::open("/tmp/app.blog");
+//   BLOG(get_process_logger(), "request {} took {} us", id, us);
+//   binary_log::close();
+//   ./bin/blog_decode /tmp/app.blog
+//
+// The hot path formats nothing: it reserves space with one fetch-add in the
+// current mmap'ed chunk and stores (timestamp, tag id, call-site id, raw
+// args). Tags and call sites (format, file:line, argument types) are interned
+// once per file and written as definition records, so the file describes
+// itself and the decoder needs nothing from the binary that wrote it.
+//
+// The file is preallocated (posix_fallocate) and grows one chunk at a time;
+// close() trims it to the bytes actually used. Call close() only after every
+// logging thread is done.
+namespace binary_log {
+
+constexpr char kMagic[8] = {'P', 'S', 'B', 'L', 'O', 'G', '0', '1'};
+
+enum RecordType : std::uint8_t { kEvent = 1, kDefineTag = 2, kDefineSite = 3 };
+enum ArgType : std::uint8_t { kI64 = 1, kU64 = 2, kF64 = 3, kPtr = 4, kStr = 5 };
+
+// Offset 0 of the file
+struct FileHeader {
+    char magic[8];
+    std::uint64_t chunk_size;
+};
+
+// Every record starts 8-byte aligned. A zero size means "nothing more in
+// this chunk" (unused tail, or a writer that died mid-record).
+struct RecordHeader {
+    std::uint16_t size;  // Whole record incl. header, multiple of 8; stored last
+    std::uint8_t type;   // RecordType
+    std::uint8_t nargs;
+    std::uint16_t tag;
+    std::uint16_t site;
+    std::uint64_t timestamp_ns;  // CLOCK_REALTIME (vDSO, no syscall)
+};
+
+static_assert(sizeof(RecordHeader) == 16, "on-disk layout");
+
+constexpr std::size_t kMaxStr = 1024;  // Longer string arguments are truncated
+
+constexpr std::size_t pad8(std::size_t n) {
+    return (n + 7) & ~std::size_t{7};
+}
+
+// One per BLOG() expansion; ids are per file (generation)
+struct CallSite {
+    const char* fmt;
+    const char* file;
+    int line;
+    std::atomic<std::uint64_t> cached{0};  // (generation << 16) | site id
+};
+
+struct Chunk {
+    char* base;
+    std::uint64_t size;
+    std::atomic<std::uint64_t> used;
+};
+
+class Writer {
+public:
+    static constexpr std::size_t kMaxTags = 256;
+
+    // nullptr (with a message on stderr) if the file cannot be created
+    static Writer* create(const char* path, std::size_t chunk_size, std::uint32_t generation);
+
+    // Trim the file and unmap it
+    void finish();
+
+    // Space for one record, or nullptr if it can never fit (dropped)
+    void* reserve(std::size_t bytes) {
+        Chunk* c = chunk_.load(std::memory_order_acquire);
+        std::uint64_t off = c->used.fetch_add(bytes, std::memory_order_relaxed);
+        if (__builtin_expect(off + bytes <= c->size, 1)) {
+            return c->base + off;
+        }
+        return reserve_slow(bytes, c);
+    }
+
+    // Tags are looked up by address (a logger's tag storage does not move)
+    std::uint16_t tag_id(const char* tag) {
+        for (std::size_t i = 0; i < kMaxTags; ++i) {
+            const char* t = tags_[i].load(std::memory_order_acquire);
+            if (t == tag) {
+                return static_cast<std::uint16_t>(i + 1);
+            }
+            if (!t) {
+                break;
+            }
+        }
+        return intern_tag(tag);
+    }
+
+    std::uint16_t site_id(CallSite& site, const ArgType* types, std::uint8_t n) {
+        std::uint64_t c = site.cached.load(std::memory_order_acquire);
+        if (__builtin_expect((c >> 16) == generation_, 1)) {
+            return static_cast<std::uint16_t>(c & 0xffff);
+        }
+        return intern_site(site, types, n);
+    }
+
+    std::uint64_t bytes_used() const;
+
+private:
+    Writer() = default;
+
+    void* reserve_slow(std::size_t bytes, Chunk* seen);
+    bool map_chunk();
+    std::uint16_t intern_tag(const char* tag);
+    std::uint16_t intern_site(CallSite& site, const ArgType* types, std::uint8_t n);
+
+    int fd_ = -1;
+    std::uint64_t chunk_size_ = 0;
+    std::uint32_t generation_ = 0;
+    std::atomic<Chunk*> chunk_{nullptr};
+    std::atomic<const char*> tags_[kMaxTags] = {};
+    std::mutex grow_mutex_;    // Mapping the next chunk
+    std::mutex intern_mutex_;  // Tag / site definitions
+    std::uint16_t next_site_ = 0;
+    std::vector<Chunk*> chunks_;
+};
+
+// Process-wide writer, exported by libprocess_binary_log.so; nullptr = off
+extern std::atomic<Writer*> g_writer;
+
+bool open(const char* path, std::size_t chunk_size = 1 << 20);
+void close();
+
+// --- Argument encoding (all at compile time except the copies) ---
+
+template <typename T>
+struct always_false : std::false_type {};
+
+template <typename T>
+constexpr ArgType arg_type() {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*> ||
+                  std::is_same_v<U, std::string_view>) {
+        return kStr;
+    } else if constexpr (std::is_pointer_v<U>) {
+        return kPtr;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return kF64;
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return kI64;
+    } else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+        return kU64;
+    } else {
+        static_assert(always_false<U>::value, "BLOG: unsupported argument type");
+    }
+}
+
+inline std::string_view as_str(const char* s) {
+    return s ? std::string_view(s) : std::string_view("(null)");
+}
+inline std::string_view as_str(std::string_view s) {
+    return s;
+}
+
+template <typename T>
+std::size_t arg_size(const T& v) {
+    if constexpr (arg_type<T>() == kStr) {
+        std::size_t n = as_str(v).size();
+        return 8 + pad8(n < kMaxStr ? n : kMaxStr);
+    } else {
+        return 8;
+    }
+}
+
+template <typename T>
+char* put_arg(char* p, const T& v) {
+    using U = std::decay_t<T>;
+    constexpr ArgType type = arg_type<T>();
+    std::uint64_t word = 0;
+    if constexpr (type == kStr) {
+        std::string_view s = as_str(v);
+        std::size_t n = s.size() < kMaxStr ? s.size() : kMaxStr;
+        word = n;
+        std::memcpy(p, &word, 8);
+        std::memcpy(p + 8, s.data(), n);
+        std::memset(p + 8 + n, 0, pad8(n) - n);
+        return p + 8 + pad8(n);
+    } else if constexpr (type == kPtr) {
+        word = reinterpret_cast<std::uintptr_t>(v);
+    } else if constexpr (type == kF64) {
+        double d = static_cast<double>(v);
+        std::memcpy(&word, &d, 8);
+    } else if constexpr (std::is_enum_v<U>) {
+        word = static_cast<std::uint64_t>(v);
+    } else if constexpr (type == kI64) {
+        std::int64_t i = static_cast<std::int64_t>(v);
+        std::memcpy(&word, &i, 8);
+    } else {
+        word = static_cast<std::uint64_t>(v);
+    }
+    std::memcpy(p, &word, 8);
+    return p + 8;
+}
+
+inline std::uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+template <typename SiteFn, typename... Args>
+void log_at(SiteFn site_fn, const char* tag, const Args&... args) {
+    // Keeps the worst case (all strings at kMaxStr) within the 16-bit size
+    static_assert(sizeof...(Args) <= 32, "BLOG: too many arguments");
+    Writer* w = g_writer.load(std::memory_order_acquire);
+    if (!w) {
+        return;
+    }
+    static constexpr ArgType kTypes[sizeof...(Args) + 1] = {arg_type<Args>()..., ArgType{}};
+    std::uint16_t site = w->site_id(site_fn(), kTypes, sizeof...(Args));
+    std::uint16_t tag_id = w->tag_id(tag);
+
+    std::size_t size = sizeof(RecordHeader) + (std::size_t{0} + ... + arg_size(args));
+    auto* p = static_cast<char*>(w->reserve(size));
+    if (!p) {
+        return;
+    }
+    RecordHeader hdr{0, kEvent, static_cast<std::uint8_t>(sizeof...(Args)), tag_id, site, now_ns()};
+    std::memcpy(p, &hdr, sizeof(hdr));
+    char* out = p + sizeof(hdr);
+    ((out = put_arg(out, args)), ...);
+    (void)out;
+    __atomic_store_n(reinterpret_cast<std::uint16_t*>(p), static_cast<std::uint16_t>(size),
+                     __ATOMIC_RELEASE);
+}
+
+}  // namespace binary_log
+
+// Binary log event; `logger` supplies the tag (ProcessLogger::tag())
+#define BLOG(logger, fmt, ...)                                                 \
+    ::binary_log::log_at(                                                      \
+        []() -> ::binary_log::CallSite& {                                      \
+            static ::binary_log::CallSite blog_site{fmt, __FILE__, __LINE__};  \
+            return blog_site;                                                  \
+        },                                                                     \
+        (logger).tag(), ##__VA_ARGS__)
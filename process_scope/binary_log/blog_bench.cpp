@@ -0,0 +1,117 @@
+// process_binary_log_bench: text ProcessLogger lines vs binary_log records
+//
+// Usage: process_binary_log_bench [records] [threads] [out-dir]
+//   text   - SLOG-style format_to<Info> + ProcessLogger::log() into a file
+//   binary - BLOG() into an mmap'ed binary_log file
+// Both write the same message with the same three arguments.
+#include "binary_log.hpp"
+#include "process_logger.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+ProcessLogger& bench_logger() {
+    static ProcessLogger logger("blog-bench");
+    return logger;
+}
+
+template <typename Fn>
+double run_threads(unsigned threads, std::uint64_t per_thread, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([=] {
+            for (std::uint64_t i = 0; i < per_thread; ++i) {
+                fn(t, i);
+            }
+        });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(per_thread * threads);
+}
+
+std::uint64_t file_size(const std::string& path) {
+    struct stat st{};
+    return stat(path.c_str(), &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000ULL;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 1;
+    std::string dir = argc > 3 ? argv[3] : "/tmp";
+    if (threads == 0) {
+        threads = 1;
+    }
+    std::uint64_t per_thread = records / threads;
+    std::string text_path = dir + "/process_binary_log_bench.txt";
+    std::string blog_path = dir + "/process_binary_log_bench.blog";
+
+    ProcessLogger& logger = bench_logger();
+    std::cout << "=== Binary Log Benchmark ===\n";
+    std::cout << "records=" << per_thread * threads << " threads=" << threads << "\n\n";
+
+    // --- text: stdout redirected to a file, as a daemon's log would be ---
+    std::cout.flush();
+    int saved = dup(STDOUT_FILENO);
+    int text_fd = open(text_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (saved < 0 || text_fd < 0) {
+        std::perror(text_path.c_str());
+        return 1;
+    }
+    dup2(text_fd, STDOUT_FILENO);
+    close(text_fd);
+    double text_ns = run_threads(threads, per_thread, [&](unsigned t, std::uint64_t i) {
+        char line[static_log::kLineSize];
+        logger.log(static_log::format_to<static_log::Level::Info>(
+            line, sizeof(line), SLOG_FMT("request {} thread {} took {} us"), i, t, 0.5 * i));
+    });
+    std::cout.flush();
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    // --- binary ---
+    if (!binary_log::open(blog_path.c_str())) {
+        return 1;
+    }
+    double blog_ns = run_threads(threads, per_thread, [&](unsigned t, std::uint64_t i) {
+        BLOG(logger, "request {} thread {} took {} us", i, t, 0.5 * i);
+    });
+    binary_log::close();
+
+    std::uint64_t n = per_thread * threads;
+    std::uint64_t text_bytes = file_size(text_path);
+    std::uint64_t blog_bytes = file_size(blog_path);
+    std::cout << std::left << std::setw(8) << "format" << std::right << std::setw(12) << "ns/record"
+              << std::setw(14) << "bytes/record" << std::setw(14) << "file(bytes)" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(8) << "text" << std::right << std::setw(12) << text_ns
+              << std::setw(14) << static_cast<double>(text_bytes) / n << std::setw(14) << text_bytes
+              << "\n";
+    std::cout << std::left << std::setw(8) << "binary" << std::right << std::setw(12) << blog_ns
+              << std::setw(14) << static_cast<double>(blog_bytes) / n << std::setw(14) << blog_bytes
+              << "\n";
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "text: formats digits and goes through std::cout (locked, buffered write(2))\n";
+    std::cout << "binary: one fetch-add + raw 8-byte args into a page-cache mapping, no syscall\n";
+    std::cout << "decode: ./bin/blog_decode " << blog_path << "\n";
+    return 0;
+}
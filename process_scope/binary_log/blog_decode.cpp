@@ -0,0 +1,184 @@
+// blog_decode: offline decoder for binary_log files
+//
+// Usage: blog_decode <file.blog>
+// Prints one line per event: "<sec>.<nsec> [tag] message (file:line)".
+// Definitions may appear after the first chunk that uses them is full, so
+// the file is scanned twice: definitions first, then events.
+#include "binary_log.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace binary_log;
+
+namespace {
+
+struct Site {
+    std::vector<ArgType> types;
+    std::string location;
+    std::string fmt;
+};
+
+struct Log {
+    const char* data;
+    std::size_t size;
+    std::uint64_t chunk_size;
+};
+
+// Calls fn(header, payload) for every complete record in file order
+template <typename Fn>
+void for_each_record(const Log& log, Fn fn) {
+    std::uint64_t pos = sizeof(FileHeader);
+    while (pos + sizeof(RecordHeader) <= log.size) {
+        RecordHeader hdr;
+        std::memcpy(&hdr, log.data + pos, sizeof(hdr));
+        std::uint64_t chunk_end = (pos / log.chunk_size + 1) * log.chunk_size;
+        if (hdr.size == 0 || pos + hdr.size > chunk_end || pos + hdr.size > log.size) {
+            pos = chunk_end;  // Unused tail of this chunk
+            continue;
+        }
+        fn(hdr, log.data + pos + sizeof(hdr), hdr.size - sizeof(hdr));
+        pos += hdr.size;
+    }
+}
+
+std::string format_event(const Site& site, const char* p, std::size_t len) {
+    std::string out;
+    std::size_t arg = 0;
+    const char* end = p + len;
+    const std::string& fmt = site.fmt;
+    for (std::size_t i = 0; i < fmt.size(); ++i) {
+        if (fmt[i] != '{' || i + 1 >= fmt.size() || fmt[i + 1] != '}') {
+            out += fmt[i];
+            continue;
+        }
+        ++i;
+        if (arg >= site.types.size() || p + 8 > end) {
+            out += "{?}";
+            continue;
+        }
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        p += 8;
+        char buf[64];
+        switch (site.types[arg++]) {
+        case kI64: {
+            std::int64_t v;
+            std::memcpy(&v, &word, 8);
+            std::snprintf(buf, sizeof(buf), "%" PRId64, v);
+            break;
+        }
+        case kU64:
+            std::snprintf(buf, sizeof(buf), "%" PRIu64, word);
+            break;
+        case kF64: {
+            double d;
+            std::memcpy(&d, &word, 8);
+            std::snprintf(buf, sizeof(buf), "%g", d);
+            break;
+        }
+        case kPtr:
+            std::snprintf(buf, sizeof(buf), "0x%" PRIx64, word);
+            break;
+        case kStr: {
+            std::size_t n = word <= static_cast<std::uint64_t>(end - p) ? word : 0;
+            out.append(p, n);
+            p += pad8(n);
+            buf[0] = '\0';
+            break;
+        }
+        default:
+            std::snprintf(buf, sizeof(buf), "{?}");
+            break;
+        }
+        out += buf;
+    }
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file.blog>\n", argv[0]);
+        return 2;
+    }
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::perror(argv[1]);
+        return 1;
+    }
+    auto size = static_cast<std::size_t>(st.st_size);
+    if (size < sizeof(FileHeader)) {
+        std::fprintf(stderr, "%s: too short for a binary log\n", argv[1]);
+        return 1;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+    FileHeader fh;
+    std::memcpy(&fh, addr, sizeof(fh));
+    if (std::memcmp(fh.magic, kMagic, sizeof(kMagic)) != 0 || fh.chunk_size == 0) {
+        std::fprintf(stderr, "%s: not a binary log (bad magic)\n", argv[1]);
+        return 1;
+    }
+    Log log{static_cast<const char*>(addr), size, fh.chunk_size};
+
+    std::map<std::uint16_t, std::string> tags;
+    std::map<std::uint16_t, Site> sites;
+    for_each_record(log, [&](const RecordHeader& hdr, const char* p, std::size_t len) {
+        if (hdr.type == kDefineTag) {
+            tags[hdr.tag] = std::string(p, strnlen(p, len));
+        } else if (hdr.type == kDefineSite && hdr.nargs <= len) {
+            Site site;
+            site.types.assign(reinterpret_cast<const ArgType*>(p),
+                              reinterpret_cast<const ArgType*>(p) + hdr.nargs);
+            const char* loc = p + hdr.nargs;
+            std::size_t rest = len - hdr.nargs;
+            site.location = std::string(loc, strnlen(loc, rest));
+            if (site.location.size() + 1 < rest) {
+                const char* fmt = loc + site.location.size() + 1;
+                site.fmt = std::string(fmt, strnlen(fmt, rest - site.location.size() - 1));
+            }
+            sites[hdr.site] = std::move(site);
+        }
+    });
+
+    std::uint64_t events = 0;
+    std::uint64_t unknown = 0;
+    for_each_record(log, [&](const RecordHeader& hdr, const char* p, std::size_t len) {
+        if (hdr.type != kEvent) {
+            return;
+        }
+        ++events;
+        auto site = sites.find(hdr.site);
+        auto tag = tags.find(hdr.tag);
+        if (site == sites.end()) {
+            ++unknown;
+            return;
+        }
+        std::printf("%" PRIu64 ".%09" PRIu64 " [%s] %s (%s)\n",
+                    static_cast<std::uint64_t>(hdr.timestamp_ns / 1000000000ULL),
+                    static_cast<std::uint64_t>(hdr.timestamp_ns % 1000000000ULL),
+                    tag != tags.end() ? tag->second.c_str() : "?",
+                    format_event(site->second, p, len).c_str(), site->second.location.c_str());
+    });
+
+    std::fprintf(stderr, "blog_decode: %" PRIu64 " events, %zu tags, %zu sites, %" PRIu64
+                 " with unknown site, %zu bytes\n", events, tags.size(), sites.size(), unknown, size);
+    munmap(addr, size);
+    close(fd);
+    return 0;
+}
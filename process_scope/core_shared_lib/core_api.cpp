@@ -1,9 +1,34 @@
 #include "core_api.hpp"
 #include "process_logger.hpp"
 
+#if SINGLETON_LAZY_INIT
+// Lazy mode: constructed on the first get_process_logger() call
+ProcessLogger& get_process_logger() {
+    SINGLETON_ACCESS("get_process_logger/core_shared_lib");
+    static ProcessLogger instance("core_shared_lib");
+    return instance;
+}
+#else
 // THE singleton instance - lives in libprocess_core.so
 static ProcessLogger g_logger("core_shared_lib");
 
 ProcessLogger& get_process_logger() {
+    SINGLETON_ACCESS("get_process_logger/core_shared_lib");
     return g_logger;
 }
+#endif
+
+static void api_log(const ProcessLogger* logger, const char* who) {
+    logger->log(who);
+}
+
+extern "C" const ProcessCoreApi* process_core_api(std::uint32_t min_version) {
+    // Built on first request, so lazy mode still defers the logger ctor
+    static const ProcessCoreApi api = {
+        PROCESS_CORE_API_VERSION,
+        sizeof(ProcessCoreApi),
+        &get_process_logger(),
+        &api_log,
+    };
+    return min_version <= api.version ? &api : nullptr;
+}
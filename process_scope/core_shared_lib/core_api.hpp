@@ -1,7 +1,42 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 
 struct ProcessLogger;
 
 // Returns the process-wide singleton logger
 // Defined in libprocess_core.so
 ProcessLogger& get_process_logger();
+
+// ============================================
+// Versioned function-table ABI
+// ============================================
+// A plugin fetches the table once (on first use, so SINGLETON_LAZY_INIT still
+// defers the logger ctor) and then calls through the cached pointer: no PLT
+// hop and no further symbol lookups per call.
+//
+// Compatibility rules:
+//   - fields are only ever appended; `size` is sizeof the table the core was
+//     built with, so a plugin can check that a field it needs exists
+//   - `version` is bumped whenever fields are appended
+extern "C" {
+
+#define PROCESS_CORE_API_VERSION 1
+
+struct ProcessCoreApi {
+    std::uint32_t version;
+    std::uint32_t size;
+
+    // --- version 1 ---
+    ProcessLogger* logger;
+    void (*log)(const ProcessLogger* logger, const char* who);
+};
+
+// Returns nullptr if the core is older than min_version
+const ProcessCoreApi* process_core_api(std::uint32_t min_version);
+
+}  // extern "C"
+
+// True if `api` was built with field `member` (for fields newer than v1)
+#define PROCESS_CORE_API_HAS(api, member) \
+    ((api)->size >= offsetof(ProcessCoreApi, member) + sizeof((api)->member))
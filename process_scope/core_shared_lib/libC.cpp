@@ -1,6 +1,25 @@
 #include "core_api.hpp"
 #include "process_logger.hpp"
+#include <cstdlib>
+#include <iostream>
+
+// libC uses the versioned function table instead of get_process_logger():
+// one lookup on the first call, then calls through the cached pointer.
+// Not at load time: building the table constructs the logger, which would
+// undo SINGLETON_LAZY_INIT
+static const ProcessCoreApi* core_api() {
+    static const ProcessCoreApi* const api = [] {
+        const ProcessCoreApi* table = process_core_api(1);
+        if (!table) {
+            std::cerr << "[libC] libprocess_core.so is too old (need API v1)\n";
+            std::abort();
+        }
+        return table;
+    }();
+    return api;
+}
 
 extern "C" void libC_entry() {
-    get_process_logger().log("libC");
+    const ProcessCoreApi* api = core_api();
+    api->log(api->logger, "libC (api table)");
 }
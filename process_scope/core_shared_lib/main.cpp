@@ -8,10 +8,13 @@ extern "C" void libB_entry();
 extern "C" void libC_entry();
 
 int main() {
+    startup_report::mark_main();
+
     std::cout << "=== Process Scope: core_shared_lib Demo ===\n\n";
 
     std::cout << "[main] calling logger directly:\n";
     get_process_logger().log("main");
+    SLOG(get_process_logger(), Debug, "main plugins={}", 3);
 
     std::cout << "\n[main] calling through DSOs:\n";
     libA_entry();
@@ -22,6 +25,8 @@ int main() {
     std::cout << "All DSOs link to libprocess_core.so\n";
     std::cout << "Therefore all share the SAME ProcessLogger instance\n";
     std::cout << "(All addresses above should be identical)\n";
+    std::cout << "libC reaches it through the versioned ProcessCoreApi table (v"
+              << process_core_api(1)->version << ")\n";
 
     return 0;
 }
@@ -1,31 +1,66 @@
 #include "dso_common.hpp"
 #include <dlfcn.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <mutex>
+#include <new>
 #include <stdexcept>
 #include <iostream>
 
-// Cache the resolved function pointer
-static GetLoggerFn g_cached_fn = nullptr;
+// One table for the whole process: this file is built into libdlsym_common.so,
+// shared by dlsym_libA/B/C, instead of being compiled into each plugin
+std::atomic<const DlsymTable*> g_dlsym_table{nullptr};
 
-GetLoggerFn resolve_get_logger() {
-    if (g_cached_fn) {
-        return g_cached_fn;
+// The resolved table gets a page of its own and is made read-only once
+// published: nothing can dirty it, so pre-fork workers keep sharing the
+// parent's copy instead of each faulting in a private one
+union alignas(4096) DlsymTablePage {
+    DlsymTable table;
+    char bytes[4096];
+};
+static_assert(sizeof(DlsymTable) <= sizeof(DlsymTablePage), "table must fit its page");
+
+static DlsymTablePage g_table_page;
+static std::once_flag g_resolve_once;
+
+// pthread_atfork child: a published table is inherited as is; a resolution
+// another thread had in flight is redone (that thread does not exist here)
+static void rearm_after_fork() {
+    if (!g_dlsym_table.load(std::memory_order_acquire)) {
+        new (&g_resolve_once) std::once_flag;
     }
+}
 
-    // RTLD_DEFAULT: search all loaded shared objects
-    // This will find get_process_logger defined in main (with --export-dynamic)
-    void* sym = dlsym(RTLD_DEFAULT, "get_process_logger");
+static const int g_atfork = pthread_atfork(nullptr, nullptr, rearm_after_fork);
 
+static void* lookup(const char* name) {
+    // RTLD_DEFAULT: search all loaded shared objects
+    // This will find symbols main exports (main_exports.list or --export-dynamic)
+    void* sym = dlsym(RTLD_DEFAULT, name);
     if (!sym) {
         const char* err = dlerror();
         throw std::runtime_error(
             std::string("dlsym failed: ") + (err ? err : "unknown error"));
     }
-
-    std::cout << "[dlsym] resolved get_process_logger @" << sym << "\n";
-    g_cached_fn = reinterpret_cast<GetLoggerFn>(sym);
-    return g_cached_fn;
+    std::cout << "[dlsym] resolved " << name << " @" << sym << "\n";
+    return sym;
 }
 
-ProcessLogger& get_logger_via_dlsym() {
-    return resolve_get_logger()();
+const DlsymTable& resolve_dlsym_table() {
+    // Concurrent first callers block here; dlsym runs once per symbol per process.
+    // If a lookup throws, the once_flag stays unset and the next caller retries.
+    std::call_once(g_resolve_once, [] {
+        DlsymTable table{};
+#define DLSYM_TABLE_RESOLVE(name, type) table.name = reinterpret_cast<type>(lookup(#name));
+        DLSYM_TABLE_SYMBOLS(DLSYM_TABLE_RESOLVE)
+#undef DLSYM_TABLE_RESOLVE
+        g_table_page.table = table;
+        // Published before it is protected: a fork() in between leaves the
+        // child a published table on a writable page, never an unpublished
+        // one on a read-only page that rearm_after_fork() would redo.
+        // Best effort: fails harmlessly where pages are larger than 4 KiB
+        g_dlsym_table.store(&g_table_page.table, std::memory_order_release);
+        mprotect(&g_table_page, sizeof(g_table_page), PROT_READ);
+    });
+    return *g_dlsym_table.load(std::memory_order_acquire);
 }
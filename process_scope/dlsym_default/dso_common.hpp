@@ -1,13 +1,47 @@
 #pragma once
+#include <atomic>
+#include "singleton_instrument.hpp"
 
 struct ProcessLogger;
 
 // Function pointer type for get_process_logger()
 using GetLoggerFn = ProcessLogger& (*)();
 
+// Every symbol the plugins look up in the host, resolved together.
+// X(name, type): add an entry here to add a symbol to the table.
+#define DLSYM_TABLE_SYMBOLS(X) \
+    X(get_process_logger, GetLoggerFn)
+
+struct DlsymTable {
+#define DLSYM_TABLE_FIELD(name, type) type name;
+    DLSYM_TABLE_SYMBOLS(DLSYM_TABLE_FIELD)
+#undef DLSYM_TABLE_FIELD
+};
+
+// Published once by libdlsym_common.so; nullptr until the first resolution
+extern std::atomic<const DlsymTable*> g_dlsym_table;
+
+// Slow path: resolve every symbol with dlsym(RTLD_DEFAULT, ...) exactly once
+// per process (std::call_once), then publish the table with a release store
+const DlsymTable& resolve_dlsym_table();
+
+// Fast path: one acquire load after the first call, from any DSO
+inline const DlsymTable& dlsym_table() {
+    const DlsymTable* table = g_dlsym_table.load(std::memory_order_acquire);
+    if (__builtin_expect(table != nullptr, 1)) {
+        return *table;
+    }
+    return resolve_dlsym_table();
+}
+
 // Resolve get_process_logger at runtime using dlsym(RTLD_DEFAULT, ...)
 // This allows DSOs to find symbols without link-time resolution
-GetLoggerFn resolve_get_logger();
+inline GetLoggerFn resolve_get_logger() {
+    return dlsym_table().get_process_logger;
+}
 
 // Convenience wrapper
-ProcessLogger& get_logger_via_dlsym();
+inline ProcessLogger& get_logger_via_dlsym() {
+    SINGLETON_ACCESS("get_logger_via_dlsym (per DSO)");
+    return resolve_get_logger()();
+}
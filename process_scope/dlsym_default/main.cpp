@@ -1,13 +1,23 @@
 #include "process_logger.hpp"
 #include <iostream>
 
+#if SINGLETON_LAZY_INIT
+// Lazy mode: constructed on the first get_process_logger() call
+extern "C" ProcessLogger& get_process_logger() {
+    SINGLETON_ACCESS("get_process_logger/dlsym_default");
+    static ProcessLogger instance("dlsym_default");
+    return instance;
+}
+#else
 // THE singleton instance - lives in main executable
 static ProcessLogger g_logger("dlsym_default");
 
 // Export this function so DSOs can find it via dlsym(RTLD_DEFAULT, ...)
 extern "C" ProcessLogger& get_process_logger() {
+    SINGLETON_ACCESS("get_process_logger/dlsym_default");
     return g_logger;
 }
+#endif
 
 // Declare plugin entry points
 extern "C" void libA_entry();
@@ -15,6 +25,8 @@ extern "C" void libB_entry();
 extern "C" void libC_entry();
 
 int main() {
+    startup_report::mark_main();
+
     std::cout << "=== Process Scope: dlsym_default Demo ===\n\n";
 
     std::cout << "[main] calling logger directly:\n";
@@ -0,0 +1,152 @@
+#include "hot_swap.hpp"
+
+#include <linux/membarrier.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace hot_swap {
+
+// Constant-initialized: readers in other DSOs' constructors may run first
+Domain g_domain{{1}, {false}, {0}};
+
+namespace {
+
+int membarrier(int cmd) {
+    return static_cast<int>(syscall(__NR_membarrier, cmd, 0, 0));
+}
+
+// Intrusive lists, nothing to destroy at exit. Readers are pushed at the
+// head under g_readers_mutex only; removal also takes g_writer_mutex, so a
+// grace period can walk its snapshot of the list without holding the
+// registration lock (a first section on another slot never waits for it)
+std::mutex g_writer_mutex;  // One grace period at a time
+std::mutex g_readers_mutex;
+Reader* g_readers = nullptr;
+pthread_key_t g_exit_key;
+
+// pthread key destructors run after every thread_local destructor, so a
+// section opened during thread teardown still finds its slot registered
+void unregister_reader(void* p) {
+    std::lock_guard<std::mutex> writer(g_writer_mutex);
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    for (Reader* reader = static_cast<Reader*>(p); reader; reader = reader->next_on_thread) {
+        for (Reader** link = &g_readers; *link; link = &(*link)->next) {
+            if (*link == reader) {
+                *link = reader->next;
+                break;
+            }
+        }
+        reader->registered = false;
+    }
+}
+
+// fork(): both locks are taken around it, so the child never inherits one
+// held by a thread that is not there. Only the forking thread survives in
+// the child: its slots stay, every other slot is dropped - one left inside
+// a section would block every later grace period
+void before_fork() {
+    g_writer_mutex.lock();
+    g_readers_mutex.lock();
+}
+
+void after_fork_parent() {
+    g_readers_mutex.unlock();
+    g_writer_mutex.unlock();
+}
+
+void after_fork_child() {
+    g_readers = nullptr;
+    for (Reader* reader = static_cast<Reader*>(pthread_getspecific(g_exit_key)); reader;
+         reader = reader->next_on_thread) {
+        reader->next = g_readers;
+        g_readers = reader;
+    }
+    // Idempotent if the registration came along with the address space; the
+    // child is single-threaded here, so dropping to the fence is safe
+    if (g_domain.expedited.load(std::memory_order_relaxed) &&
+        membarrier(MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED) != 0) {
+        g_domain.expedited.store(false, std::memory_order_relaxed);
+    }
+    g_readers_mutex.unlock();
+    g_writer_mutex.unlock();
+}
+
+// Before main(), before any writer: readers only ever switch from the full
+// fence to the compiler barrier, never the other way
+struct Init {
+    Init() {
+        pthread_key_create(&g_exit_key, unregister_reader);
+        pthread_atfork(before_fork, after_fork_parent, after_fork_child);
+        int cmds = membarrier(MEMBARRIER_CMD_QUERY);
+        if (cmds > 0 && (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+            membarrier(MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED) == 0) {
+            g_domain.expedited.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+Init g_init;
+
+// Pairs with the reader's barrier between publishing its epoch and loading
+// the instance: after this, either the writer sees the reader's epoch or the
+// reader sees the new instance
+void barrier_all() {
+    if (!g_domain.expedited.load(std::memory_order_relaxed) ||
+        membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+void wait_for(const Reader& reader, std::uint64_t target) {
+    for (int spins = 0;; ++spins) {
+        std::uint64_t epoch = reader.epoch.load(std::memory_order_acquire);
+        if (epoch == 0 || epoch >= target) {
+            return;
+        }
+        if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#else
+            std::atomic_signal_fence(std::memory_order_seq_cst);  // Compiler barrier only
+#endif
+        } else if (spins < 1024) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+}  // namespace
+
+void register_reader(Reader& reader) {
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    reader.next = g_readers;
+    g_readers = &reader;
+    reader.next_on_thread = static_cast<Reader*>(pthread_getspecific(g_exit_key));
+    pthread_setspecific(g_exit_key, &reader);
+    reader.registered = true;
+}
+
+void synchronize() {
+    std::lock_guard<std::mutex> writer(g_writer_mutex);
+    barrier_all();
+    std::uint64_t target = g_domain.epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    // Readers registered after this snapshot load `target` or later
+    const Reader* head;
+    {
+        std::lock_guard<std::mutex> lock(g_readers_mutex);
+        head = g_readers;
+    }
+    for (const Reader* reader = head; reader; reader = reader->next) {
+        wait_for(*reader, target);
+    }
+    g_domain.grace_periods.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace hot_swap
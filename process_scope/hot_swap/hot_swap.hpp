@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Epoch-based RCU for process-wide singletons that can be replaced at runtime.
+//
+//   {
+//       hot_swap::ReadSection section;            // no lock, no RMW
+//       const ProcessLogger& logger = get_process_logger(section);
+//       logger.log("worker");
+//   }                                             // logger may be freed after this
+//
+// A reader publishes the current epoch in its per-thread slot on entry and
+// clears it on exit; the instance itself is one acquire load. A writer
+// swaps in the new instance, then waits for a grace period: every reader
+// that might still see the old instance (slot holds an older epoch) has
+// left its section. Only then is the old instance deleted.
+//
+// The store-load ordering between "slot = epoch" and "load the instance" is
+// a compiler barrier on the read side, paid for by the writer with
+// membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED); without membarrier the
+// reader falls back to a full fence.
+//
+// Rules: sections nest; never call replace()/synchronize() inside one on the
+// same thread (it would wait for itself). The first section on a thread
+// registers its slot (mutex, once per thread and DSO); the slot goes away
+// after the thread's last destructor, or at fork() for every thread but the
+// forking one. The domain lives in libprocess_hot_swap.so, so all DSOs share
+// one epoch and one reader list.
+#define HOT_SWAP_API __attribute__((visibility("default")))
+
+namespace hot_swap {
+
+// Trivial, so the inline thread_local below needs no guard and no TLS
+// wrapper; epoch 0 = not in a read section
+struct Reader {
+    std::atomic<std::uint64_t> epoch;
+    std::uint32_t nesting;
+    bool registered;
+    Reader* next;            // Domain's reader list
+    Reader* next_on_thread;  // This thread's slots (one per DSO copy of t_reader)
+};
+
+struct Domain {
+    std::atomic<std::uint64_t> epoch;  // Starts at 1
+    std::atomic<bool> expedited;       // membarrier registered: readers skip the fence
+    std::atomic<std::uint64_t> grace_periods;
+};
+
+extern HOT_SWAP_API Domain g_domain;
+
+HOT_SWAP_API void register_reader(Reader& reader);
+// Wait until every read section that started before the call has ended
+HOT_SWAP_API void synchronize();
+
+inline thread_local Reader t_reader;
+
+class ReadSection {
+public:
+    ReadSection() : reader_(launder_tls(t_reader)) {
+        if (reader_.nesting++ != 0) {
+            return;
+        }
+        if (__builtin_expect(!reader_.registered, 0)) {
+            register_reader(reader_);
+        }
+        reader_.epoch.store(g_domain.epoch.load(std::memory_order_acquire),
+                            std::memory_order_relaxed);
+        if (g_domain.expedited.load(std::memory_order_relaxed)) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    ~ReadSection() {
+        if (--reader_.nesting == 0) {
+            reader_.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+
+private:
+    // One __tls_get_addr per section in a dlopen'ed DSO (see
+    // singleton_instrument.hpp)
+    static Reader& launder_tls(Reader& reader) {
+        Reader* p = &reader;
+        asm("" : "+r"(p));
+        return *p;
+    }
+
+    Reader& reader_;
+};
+
+// The replaceable instance. Never deletes the last one: readers on other
+// threads may still be using it while static destructors run.
+template <typename T>
+class Replaceable {
+public:
+    explicit Replaceable(T* initial) : current_(initial) {}
+
+    Replaceable(const Replaceable&) = delete;
+    Replaceable& operator=(const Replaceable&) = delete;
+
+    // Valid until `section` ends
+    const T& get(const ReadSection&) const { return *current_.load(std::memory_order_acquire); }
+
+    // Publish `next`, wait out the grace period, delete the old instance
+    void replace(std::unique_ptr<T> next) {
+        std::unique_ptr<T> old(current_.exchange(next.release(), std::memory_order_acq_rel));
+        synchronize();
+        retired_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t retired() const { return retired_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<T*> current_;
+    std::atomic<std::uint64_t> retired_{0};
+};
+
+}  // namespace hot_swap
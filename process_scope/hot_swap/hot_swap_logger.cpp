@@ -0,0 +1,13 @@
+#include "hot_swap_logger.hpp"
+
+// Heap-allocated from the start, so every instance can be retired the same
+// way; the last one is left to the OS
+hot_swap::Replaceable<ProcessLogger> g_hot_logger(new ProcessLogger("hot_swap/1"));
+
+void reload_process_logger(const char* tag) {
+    g_hot_logger.replace(std::make_unique<ProcessLogger>(tag));
+}
+
+std::uint64_t process_logger_reloads() {
+    return g_hot_logger.retired();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "hot_swap.hpp"
+#include "process_logger.hpp"
+
+// Variant 5: a process-wide ProcessLogger that can be replaced at runtime
+// (config reload) without a read-side lock. Owned by libprocess_hot_swap.so
+// like core_shared_lib's g_logger, but behind hot_swap::Replaceable.
+extern HOT_SWAP_API hot_swap::Replaceable<ProcessLogger> g_hot_logger;
+
+// The current instance; valid until `section` ends
+inline const ProcessLogger& get_process_logger(const hot_swap::ReadSection& section) {
+    SINGLETON_ACCESS("get_process_logger/hot_swap");
+    return g_hot_logger.get(section);
+}
+
+// Build a ProcessLogger with the new tag, publish it, and delete the old one
+// after a grace period. Blocks for that grace period; never call it inside a
+// ReadSection.
+HOT_SWAP_API void reload_process_logger(const char* tag);
+
+// Instances replaced so far
+HOT_SWAP_API std::uint64_t process_logger_reloads();
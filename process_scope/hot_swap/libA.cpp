@@ -0,0 +1,8 @@
+#include "hot_swap_logger.hpp"
+#include <iostream>
+
+extern "C" void libA_entry() {
+    hot_swap::ReadSection section;
+    std::cout << "[libA] ";
+    get_process_logger(section).log("libA");
+}
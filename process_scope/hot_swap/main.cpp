@@ -0,0 +1,135 @@
+#include "hot_swap_logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" void libA_entry();
+
+constexpr int kReaders = 3;
+constexpr int kReloads = 20;
+constexpr int kCostIters = 10000000;
+
+std::atomic<bool> g_stop{false};
+std::atomic<std::uint64_t> g_reads{0};
+std::atomic<std::uint64_t> g_bad{0};
+
+// A freed ProcessLogger has malloc's free-list pointers over tag_, so a use
+// after free shows up as a wrong tag
+void reader() {
+    std::uint64_t reads = 0;
+    std::uint64_t bad = 0;
+    while (!g_stop.load(std::memory_order_relaxed)) {
+        hot_swap::ReadSection section;
+        const ProcessLogger& logger = get_process_logger(section);
+        for (int i = 0; i < 16; ++i) {
+            bad += std::strncmp(logger.tag(), "hot_swap/", 9) != 0;
+            asm volatile("" ::: "memory");
+        }
+        ++reads;
+    }
+    g_reads.fetch_add(reads);
+    g_bad.fetch_add(bad);
+}
+
+template <typename F>
+double ns_per_op(F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCostIters; ++i) {
+        f();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+               .count() / kCostIters;
+}
+
+int main() {
+    startup_report::mark_main();
+
+    std::cout << "=== Process Scope: hot_swap Demo ===\n\n";
+    {
+        hot_swap::ReadSection section;
+        get_process_logger(section).log("main");
+    }
+    libA_entry();
+
+    std::cout << "\n[main] " << kReloads << " reloads while " << kReaders << " threads read:\n";
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kReaders; ++i) {
+        threads.emplace_back(reader);
+    }
+    std::vector<double> grace_us;
+    for (int i = 2; i < kReloads + 2; ++i) {
+        std::string tag = "hot_swap/" + std::to_string(i);
+        auto start = std::chrono::steady_clock::now();
+        reload_process_logger(tag.c_str());
+        grace_us.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count());
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    g_stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::sort(grace_us.begin(), grace_us.end());
+
+    {
+        hot_swap::ReadSection section;
+        std::cout << "\n[main] current: ";
+        get_process_logger(section).log("main");
+    }
+    libA_entry();
+
+    std::cout << "\n=== Reload Under Load ===\n";
+    std::cout << "read sections     : " << g_reads.load() << "\n";
+    std::cout << "bad reads         : " << g_bad.load() << " (must be 0)\n";
+    std::cout << "instances retired : " << process_logger_reloads() << "\n";
+    std::cout << "reload (p50 / max): " << grace_us[grace_us.size() / 2] << " / "
+              << grace_us.back() << " us (publish + grace period + delete)\n";
+    std::cout << "reader barrier    : "
+              << (hot_swap::g_domain.expedited.load() ? "compiler only (membarrier)"
+                                                      : "full fence (no membarrier)")
+              << "\n";
+
+    // Single-thread read-side cost: what every accessor call pays
+    std::mutex mutex;
+    std::shared_mutex shared;
+    const ProcessLogger* plain;
+    {
+        hot_swap::ReadSection section;
+        plain = &get_process_logger(section);
+    }
+    const ProcessLogger* sink = nullptr;
+    double rcu = ns_per_op([&] {
+        hot_swap::ReadSection section;
+        sink = &get_process_logger(section);
+        asm volatile("" : : "r"(sink) : "memory");
+    });
+    double locked = ns_per_op([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        sink = plain;
+        asm volatile("" : : "r"(sink) : "memory");
+    });
+    double shared_locked = ns_per_op([&] {
+        std::shared_lock<std::shared_mutex> lock(shared);
+        sink = plain;
+        asm volatile("" : : "r"(sink) : "memory");
+    });
+    std::cout << "\n=== Read Cost (1 thread) ===\n";
+    std::cout << "ReadSection + get_process_logger : " << rcu << " ns\n";
+    std::cout << "std::mutex                       : " << locked << " ns\n";
+    std::cout << "std::shared_mutex (shared)       : " << shared_locked << " ns\n";
+
+    std::cout << "\n=== Key Insight ===\n";
+    std::cout << "Readers: one acquire load + a per-thread epoch store, no lock, no RMW\n";
+    std::cout << "Writers publish a new instance and free the old one after a grace period\n";
+    std::cout << "Config reloads need neither a read-side lock nor a restart\n";
+
+    return g_bad.load() == 0 ? 0 : 1;
+}
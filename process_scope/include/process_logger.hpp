@@ -1,8 +1,16 @@
 #pragma once
+#include <cstring>
 #include <iostream>
+#include "static_log.hpp"
+#include "singleton_instrument.hpp"
+#include "startup_report.hpp"
 
 struct ProcessLogger {
-    explicit ProcessLogger(const char* tag) : tag_(tag) {
+    explicit ProcessLogger(const char* tag) {
+        // Copied inline: the shared_memory variant maps this object into
+        // other processes, where a pointer into our .rodata would dangle
+        std::strncpy(tag_, tag, sizeof(tag_) - 1);
+        startup_report::CtorTimer timer("ProcessLogger", this, tag_);
         std::cout << "ProcessLogger[" << tag_ << "] ctor @" << this << "\n";
     }
 
@@ -11,6 +19,17 @@ struct ProcessLogger {
                   << " (tag=" << tag_ << ")\n";
     }
 
+    // Level-filtered, compile-time formatted variant (use via SLOG)
+    template <static_log::Level L, typename Fmt, typename... Args>
+    void logf(Fmt fmt, const Args&... args) const {
+        if constexpr (static_log::enabled<L>) {
+            char line[static_log::kLineSize];
+            log(static_log::format_to<L>(line, sizeof(line), fmt, args...));
+        }
+    }
+
+    const char* tag() const { return tag_; }
+
 private:
-    const char* tag_;
+    char tag_[32] = {};
 };
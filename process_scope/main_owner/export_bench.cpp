@@ -0,0 +1,217 @@
+// main_owner_export_bench: cost of --export-dynamic vs an explicit dynamic list
+//
+// The same owner executable is linked in two modes (see CMakeLists.txt):
+//   list - -Wl,--dynamic-list=main_exports.list
+//   all  - -Wl,--export-dynamic
+// and each reports:
+//   - .dynsym entries / bytes (+ .dynstr, .gnu.hash) and file size
+//   - dlopen(RTLD_NOW) time of a plugin bound against the executable,
+//     measured in fresh child processes
+//   - dlsym(RTLD_DEFAULT, "get_process_logger") latency (dlsym_default path)
+//   - plugin -> executable call latency through the PLT
+//
+// Usage: main_owner_export_bench [iterations] [load_samples]
+//        main_owner_export_bench_all --row [iterations] [load_samples]
+#include "process_logger.hpp"
+
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef EXPORT_BENCH_MODE
+#define EXPORT_BENCH_MODE "unknown"
+#endif
+#ifndef EXPORT_BENCH_PLUGIN
+#define EXPORT_BENCH_PLUGIN "libmain_owner_export_plugin.so"
+#endif
+
+// Function-local so main() can construct it with std::cout muted; the guard
+// check costs the same in both export modes
+extern "C" ProcessLogger& get_process_logger() {
+    static ProcessLogger instance("export_bench");
+    return instance;
+}
+
+using LoopFn = std::uintptr_t (*)(std::uint64_t);
+
+struct DynInfo {
+    std::size_t dynsym_count = 0;
+    std::size_t dynsym_bytes = 0;
+    std::size_t dynstr_bytes = 0;
+    std::size_t gnu_hash_bytes = 0;
+    std::size_t file_bytes = 0;
+};
+
+static DynInfo read_dyn_info(const char* path) {
+    DynInfo info;
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    info.file_bytes = image.size();
+    if (image.size() < sizeof(Elf64_Ehdr)) {
+        return info;
+    }
+
+    auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(image.data());
+    auto* shdrs = reinterpret_cast<const Elf64_Shdr*>(image.data() + ehdr->e_shoff);
+    const char* shstr = image.data() + shdrs[ehdr->e_shstrndx].sh_offset;
+    for (int i = 0; i < ehdr->e_shnum; ++i) {
+        const char* name = shstr + shdrs[i].sh_name;
+        if (shdrs[i].sh_type == SHT_DYNSYM) {
+            info.dynsym_bytes = shdrs[i].sh_size;
+            info.dynsym_count = shdrs[i].sh_size / sizeof(Elf64_Sym);
+        } else if (std::strcmp(name, ".dynstr") == 0) {
+            info.dynstr_bytes = shdrs[i].sh_size;
+        } else if (shdrs[i].sh_type == SHT_GNU_HASH) {
+            info.gnu_hash_bytes = shdrs[i].sh_size;
+        }
+    }
+    return info;
+}
+
+// dlopen in a fresh child so every sample pays the full load + binding cost
+static double median_load_us(int samples) {
+    std::vector<double> us;
+    for (int s = 0; s < samples; ++s) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            auto start = std::chrono::steady_clock::now();
+            void* h = dlopen(EXPORT_BENCH_PLUGIN, RTLD_NOW | RTLD_LOCAL);
+            double t = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            if (!h) {
+                t = -1;
+            }
+            ssize_t ignored = write(fds[1], &t, sizeof(t));
+            (void)ignored;
+            _exit(0);
+        }
+        close(fds[1]);
+        double t = -1;
+        if (read(fds[0], &t, sizeof(t)) == sizeof(t) && t >= 0) {
+            us.push_back(t);
+        }
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+    }
+    if (us.empty()) {
+        return -1;
+    }
+    std::sort(us.begin(), us.end());
+    return us[us.size() / 2];
+}
+
+static double ns_per_dlsym(std::uint64_t iters) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iters; ++i) {
+        void* sym = dlsym(RTLD_DEFAULT, "get_process_logger");
+        asm volatile("" : : "r"(sym));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+static double ns_per_call(LoopFn loop, std::uint64_t iters) {
+    loop(iters / 10);  // Warm up: bind the PLT slot, fault in pages
+    auto start = std::chrono::steady_clock::now();
+    std::uintptr_t sum = loop(iters);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    asm volatile("" : : "r"(sum));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+static int print_row(std::uint64_t iters, int samples) {
+    DynInfo info = read_dyn_info("/proc/self/exe");
+    double load = median_load_us(samples);
+
+    void* h = dlopen(EXPORT_BENCH_PLUGIN, RTLD_NOW | RTLD_LOCAL);
+    if (!h) {
+        std::cerr << "dlopen failed: " << dlerror() << "\n";
+        return 1;
+    }
+    auto loop = reinterpret_cast<LoopFn>(dlsym(h, "export_plugin_loop"));
+    double lookup = ns_per_dlsym(iters / 100);
+    double call = loop ? ns_per_call(loop, iters) : -1;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << std::left << std::setw(6) << EXPORT_BENCH_MODE << std::right
+              << std::setw(9) << info.dynsym_count << std::setw(10) << info.dynsym_bytes
+              << std::setw(10) << info.dynstr_bytes << std::setw(10) << info.gnu_hash_bytes
+              << std::setw(10) << info.file_bytes << std::setw(11) << load
+              << std::setw(11) << lookup << std::setw(10) << call << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    bool row_only = argc > 1 && std::strcmp(argv[1], "--row") == 0;
+    int arg0 = row_only ? 2 : 1;
+    std::uint64_t iters = argc > arg0 ? std::strtoull(argv[arg0], nullptr, 10) : 100000000ULL;
+    int samples = argc > arg0 + 1 ? std::atoi(argv[arg0 + 1]) : 21;
+
+    // Keep "ProcessLogger ctor" out of the table
+    std::cout.setstate(std::ios::failbit);
+    get_process_logger();
+    std::cout.clear();
+
+    if (row_only) {
+        return print_row(iters, samples);
+    }
+
+    std::cout << "=== main_owner Export Mode Benchmark ===\n";
+    std::cout << "iterations=" << iters << " load_samples=" << samples << "\n\n";
+    std::cout << std::left << std::setw(6) << "mode" << std::right
+              << std::setw(9) << "dynsym" << std::setw(10) << "sym(B)"
+              << std::setw(10) << "str(B)" << std::setw(10) << "hash(B)"
+              << std::setw(10) << "file(B)" << std::setw(11) << "load(us)"
+              << std::setw(11) << "dlsym(ns)" << std::setw(10) << "ns/call" << "\n";
+    std::cout.flush();
+
+    median_load_us(3);  // Warm the page cache so the first row is not penalized
+    int rc = print_row(iters, samples);
+    std::cout.flush();
+
+    // Second row: the --export-dynamic build next to this binary
+    std::string self(argv[0]);
+    std::string sibling = self.substr(0, self.rfind('/') + 1) + "main_owner_export_bench_all";
+    std::string it = std::to_string(iters);
+    std::string sm = std::to_string(samples);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl(sibling.c_str(), sibling.c_str(), "--row", it.c_str(), sm.c_str(),
+              static_cast<char*>(nullptr));
+        std::cerr << "cannot run " << sibling << "\n";
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "list: -Wl,--dynamic-list=main_exports.list (only get_process_logger)\n";
+    std::cout << "all:  -Wl,--export-dynamic (every global symbol of the executable)\n";
+    std::cout << "load(us): median dlopen(RTLD_NOW) of a plugin bound against main, fresh child\n";
+    std::cout << "dlsym(ns): dlsym(RTLD_DEFAULT, \"get_process_logger\"), the dlsym_default lookup\n";
+    std::cout << "ns/call: plugin -> main get_process_logger() through the PLT\n";
+
+    return rc != 0 ? rc : (WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+}
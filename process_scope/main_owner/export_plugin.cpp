@@ -0,0 +1,15 @@
+// dlopen'ed by main_owner_export_bench; get_process_logger() is left undefined
+// here and bound against the executable's .dynsym at load time
+#include "process_logger.hpp"
+#include <cstdint>
+
+extern "C" ProcessLogger& get_process_logger();
+
+extern "C" std::uintptr_t export_plugin_loop(std::uint64_t n) {
+    std::uintptr_t sum = 0;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        sum += reinterpret_cast<std::uintptr_t>(&get_process_logger());
+        asm volatile("" : "+r"(sum));
+    }
+    return sum;
+}
@@ -1,7 +1,7 @@
 #include "process_logger.hpp"
 
 // Declaration only - definition is in main executable
-// Resolved at runtime via --export-dynamic
+// Resolved at runtime against main's .dynsym (main_exports.list)
 extern "C" ProcessLogger& get_process_logger();
 
 extern "C" void libA_entry() {
@@ -1,13 +1,23 @@
 #include "process_logger.hpp"
 #include <iostream>
 
+#if SINGLETON_LAZY_INIT
+// Lazy mode: constructed on the first get_process_logger() call
+extern "C" ProcessLogger& get_process_logger() {
+    SINGLETON_ACCESS("get_process_logger/main_owner");
+    static ProcessLogger instance("main_owner");
+    return instance;
+}
+#else
 // THE singleton instance - lives in main executable
 static ProcessLogger g_logger("main_owner");
 
 // Export this function so DSOs can find it at runtime
 extern "C" ProcessLogger& get_process_logger() {
+    SINGLETON_ACCESS("get_process_logger/main_owner");
     return g_logger;
 }
+#endif
 
 // Declare plugin entry points
 extern "C" void libA_entry();
@@ -15,6 +25,8 @@ extern "C" void libB_entry();
 extern "C" void libC_entry();
 
 int main() {
+    startup_report::mark_main();
+
     std::cout << "=== Process Scope: main_owner Demo ===\n\n";
 
     std::cout << "[main] calling logger directly:\n";
@@ -27,7 +39,7 @@ int main() {
 
     std::cout << "\n=== Key Insight ===\n";
     std::cout << "Singleton defined in main executable\n";
-    std::cout << "DSOs find it via -Wl,--export-dynamic\n";
+    std::cout << "DSOs find it in main's .dynsym (-Wl,--dynamic-list or --export-dynamic)\n";
     std::cout << "(All addresses above should be identical)\n";
 
     return 0;
@@ -1,14 +1,208 @@
 #include "shm_logger.hpp"
+#include "shm_log_ring.hpp"
+#include "shm_config.hpp"
 #include "process_logger.hpp"
-#include <iostream>
+#include "fast_exit.hpp"
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
 
 // Declare plugin entry points
 extern "C" void libA_entry();
 extern "C" void libB_entry();
 extern "C" void libC_entry();
 
-int main() {
+// A child dies (SIGKILL) halfway through formatting a fresh segment; we then
+// attach and must recover instead of waiting forever
+static int crash_test() {
+    unlink_shm_segment();
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        set_shm_init_fault_hook([] { raise(SIGKILL); });
+        get_shm_arena();
+        _exit(0);  // Not reached
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    std::cout << "[main] initializer pid " << pid << " killed by signal "
+              << (WIFSIGNALED(status) ? WTERMSIG(status) : 0) << "\n";
+
+    auto start = std::chrono::steady_clock::now();
+    get_shm_logger().log("main");
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::uint32_t recoveries = shm_recoveries();
+    std::cout << "[main] recovered in " << ms << " ms (recoveries=" << recoveries << ")\n";
+    cleanup_shm_logger();
+    return recoveries == 1 ? 0 : 1;
+}
+
+// N producer processes log through the shared ring while main() is the
+// consumer, draining into a file in batches
+static int ring_test(int procs, int records) {
+    const char* path = "/tmp/shm_log_ring.txt";
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ShmLogRing& ring = get_shm_log_ring();
+    if (fd < 0 || !ring.claim_consumer()) {
+        std::cerr << "[main] cannot open " << path << " or another consumer is running\n";
+        return 1;
+    }
+    std::uint64_t produced_before = ring.produced();
+    std::uint64_t dropped_before = ring.dropped();
+    std::uint64_t lost_before = ring.lost();
+
+    std::vector<pid_t> children;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return 1;
+    }
+    for (int p = 0; p < procs; ++p) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            std::string msg = "producer " + std::to_string(p) + " record";
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < records; ++i) {
+                shm_log(msg);
+            }
+            double ns = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count() / records;
+            ssize_t ignored = write(fds[1], &ns, sizeof(ns));
+            (void)ignored;
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    close(fds[1]);
+
+    // Consume while the producers run
+    std::uint64_t written = 0;
+    int running = procs;
+    while (running > 0) {
+        std::size_t n = ring.drain(fd);
+        written += n;
+        while (running > 0 && waitpid(-1, nullptr, WNOHANG) > 0) {
+            --running;
+        }
+        if (n == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    written += ring.drain(fd);
+    ring.release_consumer();
+    close(fd);
+
+    double ns_sum = 0, ns = 0;
+    while (read(fds[0], &ns, sizeof(ns)) == sizeof(ns)) {
+        ns_sum += ns;
+    }
+    close(fds[0]);
+
+    std::cout << "[main] " << procs << " processes x " << records << " records -> " << path << "\n";
+    std::uint64_t claimed = ring.produced() - produced_before;
+    std::uint64_t dropped = ring.dropped() - dropped_before;
+    std::uint64_t lost = ring.lost() - lost_before;
+    std::cout << "[main] written=" << written << " dropped=" << dropped << " lost=" << lost
+              << " batches=" << ring.batches() << " producer ns/record=" << ns_sum / procs << "\n";
+    // Each record exactly once: drained or lost if it claimed a slot, else dropped
+    bool exact = written + lost == claimed &&
+                 claimed + dropped == static_cast<std::uint64_t>(procs) * records;
+    return exact ? 0 : 1;
+}
+
+// N reader processes hammer the seqlock config while main() publishes new
+// versions; every published value is self-consistent (all weights equal the
+// generation), so a torn read that slipped through would be counted
+static int config_test(int readers, int updates) {
+    auto& config = get_shm_config();
+    const std::uint64_t final_version = config.version() + static_cast<std::uint64_t>(updates);
+
+    struct ReaderStats {
+        std::uint64_t reads, retries, torn;
+    };
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return 1;
+    }
+    for (int r = 0; r < readers; ++r) {
+        if (fork() == 0) {
+            close(fds[0]);
+            ReaderStats st{0, 0, 0};
+            while (config.version() < final_version) {
+                unsigned retries = 0;
+                ShmRoutingConfig c = config.read(&retries);
+                for (std::uint32_t w : c.weights) {
+                    if (w != static_cast<std::uint32_t>(c.generation)) {
+                        ++st.torn;
+                        break;
+                    }
+                }
+                ++st.reads;
+                st.retries += retries;
+            }
+            ssize_t ignored = write(fds[1], &st, sizeof(st));
+            (void)ignored;
+            _exit(0);
+        }
+    }
+    close(fds[1]);
+
+    double write_ns = 0;
+    for (int u = 0; u < updates; ++u) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto start = std::chrono::steady_clock::now();
+        config.update([](ShmRoutingConfig& c) {
+            ++c.generation;
+            for (std::uint32_t& w : c.weights) {
+                w = static_cast<std::uint32_t>(c.generation);
+            }
+        });
+        write_ns += std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    ReaderStats total{0, 0, 0}, st{};
+    while (read(fds[0], &st, sizeof(st)) == sizeof(st)) {
+        total.reads += st.reads;
+        total.retries += st.retries;
+        total.torn += st.torn;
+    }
+    close(fds[0]);
+    while (wait(nullptr) > 0) {
+    }
+
+    std::cout << "[main] " << readers << " readers, " << updates << " updates (version "
+              << config.version() << ", generation " << config.read().generation << ")\n";
+    std::cout << "[main] reads=" << total.reads << " retries=" << total.retries
+              << " torn=" << total.torn << " write ns/update=" << write_ns / updates << "\n";
+    return total.torn == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    if (argc > 1 && std::strcmp(argv[1], "--crash-test") == 0) {
+        return crash_test();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--config") == 0) {
+        return config_test(argc > 2 ? std::atoi(argv[2]) : 4, argc > 3 ? std::atoi(argv[3]) : 200);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--ring") == 0) {
+        return ring_test(argc > 2 ? std::atoi(argv[2]) : 4, argc > 3 ? std::atoi(argv[3]) : 100000);
+    }
+
     std::cout << "=== Process Scope: shared_memory Demo ===\n\n";
 
     std::cout << "[main] getting logger from shared memory:\n";
@@ -19,13 +213,22 @@ int main() {
     libB_entry();
     libC_entry();
 
+    // Any other named object can live in the same segment
+    auto& runs = get_shm_singleton<std::atomic<std::uint64_t>>("demo.runs", 0);
+    std::cout << "\n[main] demo.runs = " << runs.fetch_add(1) + 1
+              << " (kept until the segment is unlinked)\n";
+    ShmArena& arena = get_shm_arena();
+    std::cout << "[main] arena: " << arena.entries() << " entries, "
+              << arena.used() << "/" << arena.capacity() << " bytes used\n";
+
     std::cout << "\n=== Key Insight ===\n";
     std::cout << "ProcessLogger lives in kernel-managed shared memory\n";
     std::cout << "All DSOs mmap the same shm object -> same physical memory\n";
+    std::cout << "One segment holds every named singleton (offset-based directory)\n";
     std::cout << "This technique can be extended to cross-process (os_scope)\n";
 
     // Cleanup
     cleanup_shm_logger();
 
-    return 0;
+    return fast_exit::finish(0);
 }
@@ -0,0 +1,208 @@
+#include "shm_arena.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sched.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t align_up(std::uint64_t v, std::uint64_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+constexpr std::uint64_t kHeaderSize = 16;  // sizeof(BlockHeader)
+constexpr std::uint64_t kMinSplit = 64;    // Smallest free block worth keeping
+
+}  // namespace
+
+void ShmArena::init(std::size_t total_bytes) {
+    lock_.store(0, std::memory_order_relaxed);
+    capacity_ = total_bytes;
+    bump_ = align_up(sizeof(ShmArena), 64);
+    free_head_ = 0;
+    used_.store(0, std::memory_order_relaxed);
+    for (Entry& e : entries_) {
+        e.state.store(kFree, std::memory_order_relaxed);
+        e.ctor.reset();
+    }
+    magic_ = kMagic;
+}
+
+// The lock word holds the owner's pid, so a process killed while holding it
+// (e.g. mid-allocation) does not wedge every later acquire(): the next caller
+// takes the lock over, as ShmOnce does for a dead constructor.
+void ShmArena::lock() {
+    const auto self = static_cast<std::uint32_t>(getpid());
+    for (;;) {
+        std::uint32_t cur = lock_.load(std::memory_order_relaxed);
+        if (cur == 0 || !ShmOnce::process_alive(static_cast<pid_t>(cur))) {
+            if (lock_.compare_exchange_weak(cur, self, std::memory_order_acquire)) {
+                return;
+            }
+            continue;
+        }
+        sched_yield();
+    }
+}
+
+void ShmArena::unlock() {
+    lock_.store(0, std::memory_order_release);
+}
+
+void* ShmArena::allocate(std::size_t size, std::size_t align) {
+    lock();
+    void* p = allocate_locked(size, align);
+    unlock();
+    return p;
+}
+
+void* ShmArena::allocate_locked(std::size_t size, std::size_t align) {
+    align = align < 16 ? 16 : align;
+    size = align_up(size ? size : 1, 16);
+
+    // First fit from the free list
+    std::uint64_t* link = &free_head_;
+    while (*link != 0) {
+        std::uint64_t start = *link;
+        auto* blk = reinterpret_cast<BlockHeader*>(base() + start);
+        std::uint64_t payload = align_up(start + kHeaderSize, align);
+        std::uint64_t end = payload + size;
+        if (end <= start + blk->size) {
+            *link = blk->next;
+            std::uint64_t block_end = start + blk->size;
+            if (block_end - end >= kMinSplit) {
+                auto* rest = reinterpret_cast<BlockHeader*>(base() + end);
+                rest->size = block_end - end;
+                rest->next = free_head_;
+                free_head_ = end;
+                block_end = end;
+            }
+            auto* hdr = reinterpret_cast<BlockHeader*>(base() + payload - kHeaderSize);
+            std::uint64_t block_size = block_end - start;
+            hdr->size = block_size;
+            hdr->next = payload - start;
+            used_.fetch_add(block_size, std::memory_order_relaxed);
+            return base() + payload;
+        }
+        link = &blk->next;
+    }
+
+    // Bump
+    std::uint64_t start = bump_;
+    std::uint64_t payload = align_up(start + kHeaderSize, align);
+    std::uint64_t end = align_up(payload + size, 16);
+    if (end > capacity_) {
+        return nullptr;
+    }
+    bump_ = end;
+    auto* hdr = reinterpret_cast<BlockHeader*>(base() + payload - kHeaderSize);
+    hdr->size = end - start;
+    hdr->next = payload - start;
+    used_.fetch_add(end - start, std::memory_order_relaxed);
+    return base() + payload;
+}
+
+void ShmArena::deallocate(void* p) {
+    if (!p) {
+        return;
+    }
+    std::uint64_t payload = static_cast<std::uint64_t>(static_cast<char*>(p) - base());
+    auto* hdr = reinterpret_cast<BlockHeader*>(base() + payload - kHeaderSize);
+    std::uint64_t start = payload - hdr->next;
+    std::uint64_t size = hdr->size;
+
+    lock();
+    auto* blk = reinterpret_cast<BlockHeader*>(base() + start);
+    blk->size = size;
+    blk->next = free_head_;
+    free_head_ = start;
+    used_.fetch_sub(size, std::memory_order_relaxed);
+    unlock();
+}
+
+// A used entry whose name matches. The name is written before the state is
+// published, so it is safe to read after the acquire load.
+ShmArena::Entry* ShmArena::lookup(const char* name) {
+    for (Entry& e : entries_) {
+        if (e.state.load(std::memory_order_acquire) == kUsed &&
+            std::strncmp(e.name, name, kNameSize) == 0) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+void* ShmArena::construct_once(Entry& e, const char* name, std::uint64_t type_key,
+                               std::size_t size, ConstructFn construct, void* ctx) {
+    if (e.type_key != type_key || e.size != size) {
+        std::fprintf(stderr, "[shm] '%s' exists with a different type (%llu bytes, want %zu)\n",
+                     name, static_cast<unsigned long long>(e.size), size);
+        std::abort();
+    }
+    void* storage = base() + e.offset;
+    if (!e.ctor.ready()) {
+        // Outside the arena lock so T's ctor may create other entries
+        e.ctor.call([&](bool recovering) {
+            std::cout << "[shm] " << (recovering ? "re-constructing" : "constructing") << " '"
+                      << name << "' (" << size << " bytes @+" << e.offset << ")\n";
+            construct(storage, ctx);
+        });
+    }
+    return storage;
+}
+
+void* ShmArena::find(const char* name) {
+    Entry* e = lookup(name);
+    return e && e->ctor.ready() ? base() + e->offset : nullptr;
+}
+
+void* ShmArena::acquire(const char* name, std::uint64_t type_key, std::size_t size,
+                        std::size_t align, ConstructFn construct, void* ctx) {
+    std::size_t name_len = std::strlen(name);
+    if (name_len >= kNameSize) {
+        std::fprintf(stderr, "[shm] entry name too long: '%s'\n", name);
+        std::abort();
+    }
+    if (Entry* e = lookup(name)) {
+        return construct_once(*e, name, type_key, size, construct, ctx);
+    }
+
+    lock();
+    Entry* slot = lookup(name);
+    if (!slot) {
+        for (Entry& e : entries_) {
+            if (e.state.load(std::memory_order_relaxed) == kFree) {
+                slot = &e;
+                break;
+            }
+        }
+        void* storage = slot ? allocate_locked(size, align) : nullptr;
+        if (!storage) {
+            unlock();
+            std::fprintf(stderr, "[shm] cannot create '%s': %s\n", name,
+                         slot ? "arena full" : "directory full");
+            std::abort();
+        }
+        std::memcpy(slot->name, name, name_len + 1);
+        slot->align = static_cast<std::uint32_t>(align);
+        slot->type_key = type_key;
+        slot->size = size;
+        slot->offset = static_cast<std::uint64_t>(static_cast<char*>(storage) - base());
+        slot->state.store(kUsed, std::memory_order_release);
+    }
+    unlock();
+    return construct_once(*slot, name, type_key, size, construct, ctx);
+}
+
+std::size_t ShmArena::entries() const {
+    std::size_t n = 0;
+    for (const Entry& e : entries_) {
+        if (e.state.load(std::memory_order_relaxed) == kUsed && e.ctor.ready()) {
+            ++n;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "shm_once.hpp"
+
+// Arena allocator + directory of named objects inside one shared segment.
+//
+// Nothing inside the segment stores a raw pointer, so every process may map it
+// at a different address:
+//   - directory entries hold offsets from the ShmArena header
+//   - objects that point at other arena objects use ShmPtr<T> (self-relative)
+//
+// Allocation is a bump pointer plus a first-fit free list under a small
+// cross-process spinlock that a live process takes over from a dead holder.
+// It only runs when an entry is created; looking up a ready entry takes no lock.
+class ShmArena {
+public:
+    static constexpr std::size_t kMaxEntries = 64;
+    static constexpr std::size_t kNameSize = 48;
+    static constexpr std::uint32_t kMagic = 0x53484d41;  // "SHMA"
+
+    using ConstructFn = void (*)(void* storage, void* ctx);
+
+    // Format an empty arena covering `total_bytes` from this header onwards
+    void init(std::size_t total_bytes);
+    bool valid() const { return magic_ == kMagic; }
+
+    void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t));
+    void deallocate(void* p);
+
+    // Return entry `name`, creating it with construct(storage, ctx) if absent.
+    // Exactly one caller across all attached processes constructs; the others
+    // sleep until it is ready, and re-run construct themselves if that process
+    // died mid-constructor. Aborts if `name` exists with another type/size.
+    void* acquire(const char* name, std::uint64_t type_key, std::size_t size,
+                  std::size_t align, ConstructFn construct, void* ctx);
+
+    // A ready entry, or nullptr
+    void* find(const char* name);
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t used() const { return used_.load(std::memory_order_relaxed); }
+    std::size_t entries() const;
+
+private:
+    enum : std::uint32_t { kFree = 0, kUsed = 1 };
+
+    struct Entry {
+        std::atomic<std::uint32_t> state;  // kUsed once name/type/offset are set
+        ShmOnce ctor;                      // Runs the constructor exactly once
+        std::uint32_t align;
+        std::uint64_t type_key;
+        std::uint64_t size;
+        std::uint64_t offset;  // From the ShmArena header
+        char name[kNameSize];
+    };
+
+    // Sits right before every payload; a free block reuses it as a list node
+    struct BlockHeader {
+        std::uint64_t size;  // Whole block, header and padding included
+        std::uint64_t next;  // Free list link / payload offset within the block
+    };
+
+    void lock();
+    void unlock();
+    void* allocate_locked(std::size_t size, std::size_t align);
+    Entry* lookup(const char* name);
+    void* construct_once(Entry& e, const char* name, std::uint64_t type_key, std::size_t size,
+                         ConstructFn construct, void* ctx);
+
+    char* base() { return reinterpret_cast<char*>(this); }
+
+    std::uint32_t magic_;
+    std::atomic<std::uint32_t> lock_;  // pid of the holder, 0 = free
+    std::uint64_t capacity_;
+    std::uint64_t bump_;
+    std::uint64_t free_head_;  // 0 = empty free list
+    std::atomic<std::uint64_t> used_;
+    Entry entries_[kMaxEntries];
+};
+
+// Pointer to another object in the same segment, stored as the distance from
+// itself. Valid at any mapping address as long as both ends are in the segment.
+template <typename T>
+class ShmPtr {
+public:
+    ShmPtr() = default;
+    ShmPtr(T* p) { set(p); }
+    ShmPtr(const ShmPtr& other) { set(other.get()); }
+    ShmPtr& operator=(const ShmPtr& other) {
+        set(other.get());
+        return *this;
+    }
+    ShmPtr& operator=(T* p) {
+        set(p);
+        return *this;
+    }
+
+    T* get() const {
+        return diff_ == 0 ? nullptr
+                          : reinterpret_cast<T*>(reinterpret_cast<std::intptr_t>(this) + diff_);
+    }
+    T* operator->() const { return get(); }
+    T& operator*() const { return *get(); }
+    explicit operator bool() const { return diff_ != 0; }
+
+private:
+    void set(T* p) {
+        diff_ = p ? reinterpret_cast<std::intptr_t>(p) - reinterpret_cast<std::intptr_t>(this) : 0;
+    }
+
+    std::intptr_t diff_ = 0;  // 0 = null (an object cannot point at itself)
+};
+
+// The arena of the process_scope shared segment (mapped on first use)
+ShmArena& get_shm_arena();
+
+namespace shm_detail {
+
+constexpr std::uint64_t fnv1a(const char* s) {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (; *s; ++s) {
+        h = (h ^ static_cast<unsigned char>(*s)) * 1099511628211ULL;
+    }
+    return h;
+}
+
+template <typename T>
+constexpr std::uint64_t type_key() {
+    return fnv1a(__PRETTY_FUNCTION__);
+}
+
+}  // namespace shm_detail
+
+// Named singleton in the shared segment, constructed from args by whichever
+// process asks first. Resolve once and keep the reference: each call scans
+// the directory.
+//
+// T must be valid at any address in any process: no vtable, no raw pointers
+// (use ShmPtr<T> for links inside the segment).
+template <typename T, typename... Args>
+T& get_shm_singleton(const char* name, Args&&... args) {
+    static_assert(!std::is_polymorphic_v<T>, "vtable pointers are per-process");
+    auto ctor_args = std::forward_as_tuple(std::forward<Args>(args)...);
+    using ArgTuple = decltype(ctor_args);
+    void* obj = get_shm_arena().acquire(
+        name, shm_detail::type_key<T>(), sizeof(T), alignof(T),
+        [](void* storage, void* ctx) {
+            std::apply([storage](auto&&... a) { new (storage) T(std::forward<decltype(a)>(a)...); },
+                       std::move(*static_cast<ArgTuple*>(ctx)));
+        },
+        &ctor_args);
+    return *static_cast<T*>(obj);
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <sched.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "shm_arena.hpp"
+#include "shm_once.hpp"
+
+// Read-mostly value in shared memory, published with a double-buffered seqlock.
+//
+// Readers take no lock and make no syscall: they copy the current buffer and
+// retry only if a writer overwrote it mid-copy (which needs two publishes
+// during one read). A writer fills the *other* buffer and then flips
+// `version_`, so each publish replaces the whole value atomically and a writer
+// that dies mid-write leaves readers untouched.
+//
+// Writers serialize on a pid lock; a dead holder is taken over.
+template <typename T>
+class ShmSeqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "copied with memcpy across processes");
+
+public:
+    explicit ShmSeqlock(const T& initial) {
+        std::memcpy(&buffers_[0].value, &initial, sizeof(T));
+    }
+
+    // Lock-free read of the latest published value
+    T read(unsigned* retries = nullptr) const {
+        T out;
+        for (unsigned attempt = 0;; ++attempt) {
+            std::uint64_t v = version_.load(std::memory_order_acquire);
+            const Buffer& b = buffers_[v & 1];
+            std::uint64_t s1 = b.seq.load(std::memory_order_acquire);
+            if ((s1 & 1) == 0) {
+                std::memcpy(&out, &b.value, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (b.seq.load(std::memory_order_relaxed) == s1) {
+                    if (retries) {
+                        *retries = attempt;
+                    }
+                    return out;
+                }
+            }
+        }
+    }
+
+    // Number of values published so far (0 = the initial one)
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // Publish a new value built from a copy of the current one
+    template <typename Fn>
+    void update(Fn&& fn) {
+        lock();
+        std::uint64_t v = version_.load(std::memory_order_relaxed);
+        T next;
+        std::memcpy(&next, &buffers_[v & 1].value, sizeof(T));
+        fn(next);
+        publish_locked(v, next);
+        unlock();
+    }
+
+    void write(const T& value) {
+        lock();
+        publish_locked(version_.load(std::memory_order_relaxed), value);
+        unlock();
+    }
+
+private:
+    struct alignas(64) Buffer {
+        std::atomic<std::uint64_t> seq{0};  // Odd while being written
+        T value;
+    };
+
+    void publish_locked(std::uint64_t v, const T& value) {
+        Buffer& b = buffers_[(v + 1) & 1];
+        std::uint64_t s = b.seq.load(std::memory_order_relaxed) | 1;  // Odd even after a dead writer
+        b.seq.store(s, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&b.value, &value, sizeof(T));
+        b.seq.store(s + 1, std::memory_order_release);
+        version_.store(v + 1, std::memory_order_release);
+    }
+
+    void lock() {
+        const auto self = static_cast<std::uint32_t>(getpid());
+        for (;;) {
+            std::uint32_t cur = writer_.load(std::memory_order_relaxed);
+            if (cur == 0 || !ShmOnce::process_alive(static_cast<pid_t>(cur))) {
+                if (writer_.compare_exchange_weak(cur, self, std::memory_order_acquire)) {
+                    return;
+                }
+                continue;
+            }
+            sched_yield();
+        }
+    }
+
+    void unlock() { writer_.store(0, std::memory_order_release); }
+
+    alignas(64) std::atomic<std::uint64_t> version_{0};
+    std::atomic<std::uint32_t> writer_{0};  // pid of the writer, 0 = none
+    Buffer buffers_[2];
+};
+
+// Example machine-wide config: routing table shared by every process
+struct ShmRoutingConfig {
+    static constexpr int kShards = 16;
+
+    std::uint64_t generation = 0;
+    std::uint32_t shard_count = kShards;
+    std::uint32_t weights[kShards] = {};
+    char region[32] = "default";
+};
+
+// Attached through the same arena as get_shm_logger(); resolved once per DSO
+inline ShmSeqlock<ShmRoutingConfig>& get_shm_config() {
+    static ShmSeqlock<ShmRoutingConfig>& config =
+        get_shm_singleton<ShmSeqlock<ShmRoutingConfig>>("ShmRoutingConfig", ShmRoutingConfig{});
+    return config;
+}
@@ -0,0 +1,54 @@
+// shm_log_drain: the single consumer of the machine-wide ShmLogRing
+//
+// Usage: shm_log_drain [output-file]      (default: stdout)
+// Runs until SIGINT/SIGTERM, then drains what is left and prints counters.
+#include "shm_log_ring.hpp"
+#include "shm_logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+int main(int argc, char** argv) {
+    int fd = STDOUT_FILENO;
+    if (argc > 1) {
+        fd = open(argv[1], O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, [](int) { g_stop = 1; });
+    std::signal(SIGTERM, [](int) { g_stop = 1; });
+
+    ShmLogRing& ring = get_shm_log_ring();
+    if (!ring.claim_consumer()) {
+        std::fprintf(stderr, "shm_log_drain: another consumer is already running\n");
+        return 1;
+    }
+
+    std::uint64_t written = 0;
+    while (!g_stop) {
+        std::size_t n = ring.drain(fd);
+        written += n;
+        if (n == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    written += ring.drain(fd);
+    ring.release_consumer();
+
+    std::fprintf(stderr, "shm_log_drain: written=%llu batches=%llu dropped=%llu lost=%llu\n",
+                 static_cast<unsigned long long>(written),
+                 static_cast<unsigned long long>(ring.batches()),
+                 static_cast<unsigned long long>(ring.dropped()),
+                 static_cast<unsigned long long>(ring.lost()));
+    return 0;
+}
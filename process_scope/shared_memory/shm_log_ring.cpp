@@ -0,0 +1,220 @@
+#include "shm_log_ring.hpp"
+#include "shm_arena.hpp"
+#include "shm_once.hpp"
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+namespace {
+
+std::uint64_t now_ns(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);  // vDSO: no syscall
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+// getpid()/gettid() are real syscalls; cache them per thread and invalidate
+// the cache in fork children
+std::atomic<unsigned> g_fork_generation{0};
+[[maybe_unused]] const int g_atfork = pthread_atfork(nullptr, nullptr, [] {
+    g_fork_generation.fetch_add(1, std::memory_order_relaxed);
+});
+
+struct ThreadIds {
+    unsigned generation = ~0u;
+    std::uint32_t pid = 0;
+    std::uint32_t tid = 0;
+};
+
+thread_local ThreadIds t_ids;
+
+const ThreadIds& thread_ids() {
+    unsigned gen = g_fork_generation.load(std::memory_order_relaxed);
+    if (__builtin_expect(t_ids.generation != gen, 0)) {
+        t_ids.pid = static_cast<std::uint32_t>(getpid());
+        t_ids.tid = static_cast<std::uint32_t>(syscall(SYS_gettid));
+        t_ids.generation = gen;
+    }
+    return t_ids;
+}
+
+constexpr std::uint64_t kSpinLimitNs = 1000 * 1000;  // Wait for a lagging slot at most 1ms
+
+}  // namespace
+
+ShmLogRing::ShmLogRing() {
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool ShmLogRing::push(std::string_view text) {
+    // Cheap fullness check; several producers may pass it at once, which the
+    // wait in write_slot() absorbs
+    if (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire) >= kCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return write_slot(head_.fetch_add(1, std::memory_order_relaxed), text);
+}
+
+// A claimed slot is counted exactly once: committed and drained, or - if
+// this producer gives up or is too late - skipped and counted in lost_ by
+// the consumer. Never in dropped_, which is for records that claimed nothing.
+bool ShmLogRing::write_slot(std::uint64_t pos, std::string_view text) {
+    ShmLogRecord* rec = take_slot(pos);
+    if (!rec) {
+        return false;
+    }
+    commit_slot(*rec, pos, text);
+    return true;
+}
+
+ShmLogRecord* ShmLogRing::take_slot(std::uint64_t pos) {
+    ShmLogRecord& rec = slots_[pos & (kCapacity - 1)];
+
+    if (rec.seq.load(std::memory_order_acquire) != pos) {
+        std::uint64_t deadline = now_ns(CLOCK_MONOTONIC) + kSpinLimitNs;
+        while (rec.seq.load(std::memory_order_acquire) != pos) {
+            if (now_ns(CLOCK_MONOTONIC) > deadline) {
+                return nullptr;  // The consumer skips this slot once it stalls on it
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Take the slot before touching the record: the consumer may have
+    // skipped it already, and then it belongs to a later lap
+    std::uint64_t expected = pos;
+    if (!rec.seq.compare_exchange_strong(expected, ShmLogRecord::kWriting | thread_ids().pid,
+                                         std::memory_order_acquire, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return &rec;
+}
+
+void ShmLogRing::commit_slot(ShmLogRecord& rec, std::uint64_t pos, std::string_view text) {
+    const ThreadIds& ids = thread_ids();
+    rec.timestamp_ns = now_ns(CLOCK_REALTIME);
+    rec.pid = ids.pid;
+    rec.tid = ids.tid;
+    rec.len = static_cast<std::uint16_t>(text.size() < ShmLogRecord::kTextSize
+                                             ? text.size() : ShmLogRecord::kTextSize);
+    std::memcpy(rec.text, text.data(), rec.len);
+    rec.seq.store(pos + 1, std::memory_order_release);
+}
+
+bool ShmLogRing::claim_consumer() {
+    const auto self = static_cast<std::uint32_t>(getpid());
+    for (;;) {
+        std::uint32_t cur = consumer_.load(std::memory_order_acquire);
+        if (cur == self) {
+            return true;
+        }
+        if (cur != 0 && ShmOnce::process_alive(static_cast<pid_t>(cur))) {
+            return false;
+        }
+        if (consumer_.compare_exchange_strong(cur, self, std::memory_order_acq_rel)) {
+            stall_pos_ = ~0ULL;
+            return true;
+        }
+    }
+}
+
+void ShmLogRing::release_consumer() {
+    auto self = static_cast<std::uint32_t>(getpid());
+    consumer_.compare_exchange_strong(self, 0, std::memory_order_release);
+}
+
+std::size_t ShmLogRing::drain(int fd) {
+    static constexpr std::size_t kMaxLine = ShmLogRecord::kTextSize + 64;
+    char buf[kBatchSize];
+    std::size_t used = 0;
+    std::size_t records = 0;
+    std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+    auto flush = [&] {
+        std::size_t off = 0;
+        while (off < used) {
+            ssize_t n = ::write(fd, buf + off, used - off);
+            if (n <= 0) {
+                break;
+            }
+            off += static_cast<std::size_t>(n);
+        }
+        if (used > 0) {
+            batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+        used = 0;
+    };
+
+    for (;;) {
+        ShmLogRecord& rec = slots_[tail & (kCapacity - 1)];
+        std::uint64_t seq = rec.seq.load(std::memory_order_acquire);
+        if (seq != tail + 1) {
+            // Claimed but not committed: a slow producer, or one that died
+            // between its fetch-add and its commit. Skip it after kStallNs,
+            // unless a live producer is writing it.
+            if (tail >= head_.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if ((seq & ShmLogRecord::kWriting) != 0 &&
+                ShmOnce::process_alive(static_cast<pid_t>(seq & 0xffffffffu))) {
+                stall_pos_ = ~0ULL;
+                break;
+            }
+            std::uint64_t now = now_ns(CLOCK_MONOTONIC);
+            if (stall_pos_ != tail) {
+                stall_pos_ = tail;
+                stall_since_ns_ = now;
+                break;
+            }
+            if (now - stall_since_ns_ < kStallNs) {
+                break;
+            }
+            std::uint64_t expected = seq;
+            if (rec.seq.compare_exchange_strong(expected, tail + kCapacity,
+                                                std::memory_order_acq_rel)) {
+                lost_.fetch_add(1, std::memory_order_relaxed);
+                ++tail;
+                tail_.store(tail, std::memory_order_release);
+            }
+            continue;  // Committed just now, or skipped
+        }
+
+        if (used + kMaxLine > kBatchSize) {
+            flush();
+        }
+        int n = std::snprintf(buf + used, kBatchSize - used, "%llu.%09llu %u/%u ",
+                              static_cast<unsigned long long>(rec.timestamp_ns / 1000000000ULL),
+                              static_cast<unsigned long long>(rec.timestamp_ns % 1000000000ULL),
+                              rec.pid, rec.tid);
+        used += static_cast<std::size_t>(n);
+        std::memcpy(buf + used, rec.text, rec.len);
+        used += rec.len;
+        buf[used++] = '\n';
+
+        rec.seq.store(tail + kCapacity, std::memory_order_release);
+        ++tail;
+        tail_.store(tail, std::memory_order_release);
+        ++records;
+    }
+    flush();
+    return records;
+}
+
+ShmLogRing& get_shm_log_ring() {
+    static ShmLogRing& ring = get_shm_singleton<ShmLogRing>("ShmLogRing");
+    return ring;
+}
+
+bool shm_log(std::string_view text) {
+    return get_shm_log_ring().push(text);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Machine-wide binary log ring in the shared segment (arena entry "ShmLogRing").
+//
+// Producers in any process claim a slot with one fetch-add on head_, take
+// ownership of it by CASing its sequence number to a writing marker, copy a
+// fixed 64-byte record and commit it with a release store of pos + 1 - no
+// lock and no syscall (timestamps come from the vDSO, pid/tid are cached).
+// The consumer never skips a slot a live producer is writing, so a late
+// producer cannot overwrite a record of a later lap.
+// A single consumer process (shm_log_drain, or a daemon) formats committed
+// records and writes them to a file in large batches.
+//
+// Full ring: producers drop and count the record instead of blocking, so
+// logging never stalls when no consumer is running. Every push() ends up in
+// exactly one of: drained, dropped() (ring full, no slot claimed) or lost()
+// (slot claimed but never committed: the producer timed out, was too slow
+// to take it, or died). produced() counts claimed slots, so
+// drained + lost == produced.
+struct ShmLogRecord {
+    static constexpr std::size_t kTextSize = 38;  // Record = one cache line
+    static constexpr std::uint64_t kWriting = 1ULL << 63;
+
+    // pos: free, kWriting | pid: being written, pos + 1: committed
+    std::atomic<std::uint64_t> seq;
+    std::uint64_t timestamp_ns;      // CLOCK_REALTIME
+    std::uint32_t pid;
+    std::uint32_t tid;
+    std::uint16_t len;
+    char text[kTextSize];
+};
+
+static_assert(sizeof(ShmLogRecord) == 64, "one record per cache line");
+
+class ShmLogRing {
+public:
+    static constexpr std::size_t kCapacity = 8192;  // Power of two (512 KiB)
+    static constexpr std::size_t kBatchSize = 64 * 1024;
+    static constexpr std::uint64_t kStallNs = 100 * 1000 * 1000;
+
+    ShmLogRing();
+
+    // Producer side, any process / thread. False if the record was dropped.
+    bool push(std::string_view text);
+
+    // Consumer side. Only one live process may hold the consumer role; a
+    // dead holder is replaced automatically.
+    bool claim_consumer();
+    void release_consumer();
+
+    // Format every committed record into batches of up to kBatchSize and
+    // write(2) them to fd. Returns the number of records written.
+    std::size_t drain(int fd);
+
+    std::uint64_t produced() const { return head_.load(std::memory_order_relaxed); }
+    std::uint64_t consumed() const { return tail_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }  // Ring full
+    std::uint64_t lost() const { return lost_.load(std::memory_order_relaxed); }  // Never committed
+    std::uint64_t batches() const { return batches_.load(std::memory_order_relaxed); }
+
+private:
+    friend struct ShmLogRingTest;  // shm_log_ring_test.cpp: claims without the fullness check
+
+    // Wait for slot `pos` to be free and take it; nullptr if the wait timed
+    // out or the consumer already skipped the slot
+    ShmLogRecord* take_slot(std::uint64_t pos);
+    // Fill a taken slot and publish it
+    void commit_slot(ShmLogRecord& rec, std::uint64_t pos, std::string_view text);
+    bool write_slot(std::uint64_t pos, std::string_view text);
+
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+
+    // Consumer-owned
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    std::atomic<std::uint32_t> consumer_{0};  // pid of the consumer, 0 = none
+    std::atomic<std::uint64_t> lost_{0};      // Claimed but never committed
+    std::atomic<std::uint64_t> batches_{0};
+    std::uint64_t stall_pos_ = ~0ULL;
+    std::uint64_t stall_since_ns_ = 0;
+
+    alignas(64) ShmLogRecord slots_[kCapacity];
+};
+
+// The ring in the process_scope shared segment (resolved once per process)
+ShmLogRing& get_shm_log_ring();
+
+// Convenience producer: get_shm_log_ring().push(text)
+bool shm_log(std::string_view text);
@@ -0,0 +1,186 @@
+// shm_log_ring_test: every record is counted exactly once - drained,
+// dropped() or lost() - on the ring's give-up paths, and a producer stalled
+// between taking a slot and committing it never leaves a torn record
+//
+// Usage: shm_log_ring_test   (ctest: shm_log_ring_test)
+//
+// Uses a private ShmLogRing on the heap, not the shared segment, so it
+// neither needs nor disturbs a running consumer.
+#include "shm_log_ring.hpp"
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Friend of ShmLogRing: a producer whose fullness check passed just before
+// the ring filled up (two producers racing for the last slot)
+struct ShmLogRingTest {
+    static bool push_unchecked(ShmLogRing& ring, const char* text) {
+        return ring.write_slot(ring.head_.fetch_add(1, std::memory_order_relaxed), text);
+    }
+    // A producer that died between its fetch-add and its commit
+    static void abandon_slot(ShmLogRing& ring) {
+        ring.head_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // A producer that took its slot and then stalls before committing
+    static std::uint64_t take(ShmLogRing& ring, ShmLogRecord*& rec) {
+        std::uint64_t pos = ring.head_.fetch_add(1, std::memory_order_relaxed);
+        rec = ring.take_slot(pos);
+        return pos;
+    }
+    static void commit(ShmLogRing& ring, ShmLogRecord& rec, std::uint64_t pos, const char* text) {
+        ring.commit_slot(rec, pos, text);
+    }
+    // A producer of process `pid` that died after taking its slot
+    static void take_as(ShmLogRing& ring, pid_t pid) {
+        std::uint64_t pos = ring.head_.fetch_add(1, std::memory_order_relaxed);
+        ring.slots_[pos & (ShmLogRing::kCapacity - 1)].seq.store(
+            ShmLogRecord::kWriting | static_cast<std::uint32_t>(pid), std::memory_order_release);
+    }
+};
+
+namespace {
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what, unsigned long long got, unsigned long long want) {
+    std::printf("%-40s %8llu (expected %llu)%s\n", what, got, want, ok ? "" : "  FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+// Keep draining until the consumer has stepped over every claimed slot
+// (a stalled slot is skipped after ShmLogRing::kStallNs)
+std::uint64_t drain_all(ShmLogRing& ring, int fd) {
+    std::uint64_t written = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ring.consumed() < ring.produced() && std::chrono::steady_clock::now() < deadline) {
+        written += ring.drain(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return written + ring.drain(fd);
+}
+
+// A producer takes slot 0 and stalls for longer than kStallNs while other
+// producers keep pushing and the consumer keeps draining. The consumer must
+// wait for it instead of skipping the slot, and every drained line must be
+// whole. Then a slot taken by a dead process is skipped and counted lost.
+void stalled_producer() {
+    constexpr int kOthers = 1000;
+    auto ring = std::make_unique<ShmLogRing>();
+    std::FILE* out = std::tmpfile();
+    int fd = fileno(out);
+
+    std::atomic<bool> taken{false};
+    std::thread producer([&] {
+        ShmLogRecord* rec = nullptr;
+        std::uint64_t pos = ShmLogRingTest::take(*ring, rec);
+        taken.store(true);
+        std::this_thread::sleep_for(std::chrono::nanoseconds(3 * ShmLogRing::kStallNs));
+        if (rec) {
+            ShmLogRingTest::commit(*ring, *rec, pos, "stalled");
+        }
+    });
+    while (!taken.load()) {
+        std::this_thread::yield();
+    }
+    std::uint64_t written = 0;
+    std::uint64_t while_stalled = 0;
+    for (int i = 0; i < kOthers; ++i) {
+        ring->push("other");
+        if (i % 100 == 0) {
+            while_stalled += ring->drain(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        }
+    }
+    producer.join();
+    written = while_stalled + drain_all(*ring, fd);
+
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(0);
+    }
+    waitpid(child, nullptr, 0);
+    ShmLogRingTest::take_as(*ring, child);
+    ring->push("after dead");
+    written += drain_all(*ring, fd);
+
+    // Every line is "sec.nsec pid/tid text" with one of the pushed texts
+    std::uint64_t stalled = 0;
+    std::uint64_t torn = 0;
+    std::uint64_t lines = 0;
+    char line[256];
+    std::rewind(out);
+    while (std::fgets(line, sizeof(line), out)) {
+        ++lines;
+        const char* text = std::strchr(line, ' ');
+        text = text ? std::strchr(text + 1, ' ') : nullptr;
+        std::string t = text ? std::string(text + 1) : std::string();
+        if (t == "stalled\n") {
+            ++stalled;
+        } else if (t != "other\n" && t != "after dead\n") {
+            ++torn;
+        }
+    }
+    std::fclose(out);
+
+    std::printf("\n=== ShmLogRing stalled producer ===\n");
+    expect(while_stalled == 0, "drained while slot 0 was being written", while_stalled, 0);
+    expect(written == kOthers + 2, "drained", written, kOthers + 2);
+    expect(lines == written, "lines written", lines, written);
+    expect(stalled == 1, "stalled record committed", stalled, 1);
+    expect(torn == 0, "torn records", torn, 0);
+    expect(ring->lost() == 1, "lost() (taken by a dead process)", ring->lost(), 1);
+}
+
+}  // namespace
+
+int main() {
+    auto ring = std::make_unique<ShmLogRing>();
+    int fd = open("/dev/null", O_WRONLY);
+    const std::uint64_t capacity = ShmLogRing::kCapacity;
+
+    // Fill the ring completely, then:
+    //  - one push() that sees it full  -> dropped
+    //  - one producer past the check   -> times out waiting for slot 0 -> lost
+    //  - one producer that dies        -> lost
+    std::uint64_t pushed = 0;
+    for (std::uint64_t i = 0; i < capacity; ++i) {
+        pushed += ring->push("record") ? 1 : 0;
+    }
+    bool full_push = ring->push("full");
+    bool timed_out = !ShmLogRingTest::push_unchecked(*ring, "late");
+    ShmLogRingTest::abandon_slot(*ring);
+    std::uint64_t attempts = capacity + 3;
+
+    std::uint64_t written = drain_all(*ring, fd);
+    // Slot 0 is free again now: a producer past the check commits normally
+    bool after = ring->push("after");
+    written += drain_all(*ring, fd);
+    attempts += 1;
+    close(fd);
+
+    std::printf("=== ShmLogRing accounting ===\n");
+    expect(pushed == capacity, "committed while filling", pushed, capacity);
+    expect(!full_push, "push() on a full ring refused", full_push ? 0 : 1, 1);
+    expect(timed_out, "producer past the check timed out", timed_out ? 1 : 0, 1);
+    expect(after, "push() after draining", after ? 1 : 0, 1);
+    expect(written == capacity + 1, "drained", written, capacity + 1);
+    expect(ring->dropped() == 1, "dropped() (ring full)", ring->dropped(), 1);
+    expect(ring->lost() == 2, "lost() (timed out + abandoned)", ring->lost(), 2);
+    expect(written + ring->lost() == ring->produced(), "drained + lost == produced()",
+           written + ring->lost(), ring->produced());
+    expect(written + ring->dropped() + ring->lost() == attempts,
+           "drained + dropped + lost == attempts", written + ring->dropped() + ring->lost(),
+           attempts);
+
+    stalled_producer();
+    return g_failures == 0 ? 0 : 1;
+}
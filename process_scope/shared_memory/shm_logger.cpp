@@ -1,73 +1,222 @@
 #include "shm_logger.hpp"
 #include "process_logger.hpp"
+#include "fast_exit.hpp"
 
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 #include <mutex>
+#include <new>
 #include <iostream>
 #include <cstring>
-#include <new>  // placement new
+#include <cstddef>
+#include <cstdlib>
+#include <cerrno>
+#include <fstream>
+#include <string>
 
-static const char* SHM_NAME = "/process_scope_logger";
+// Renamed whenever the segment header layout changes, so a stale segment
+// from an older build is never attached: "/process_scope_shm" was the
+// arena's name before the ShmOnce header
+static const char* SHM_NAME = "/process_scope_singletons";
 
-// Process-local state
-static ShmBlock* g_block = nullptr;
+// Process-local state: g_block is published only once the segment is ready,
+// so the fast path is a single acquire load
+static std::atomic<ShmBlock*> g_block{nullptr};
 static std::once_flag g_init_flag;
+static void (*g_init_fault_hook)() = nullptr;  // Test seam, see set_shm_init_fault_hook
 
-static void init_shm_block() {
-    // Open or create shared memory object
-    int fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+// Same segment name under hugetlbfs, for kShmMapHugeTLB
+static const char* HUGETLB_PATH = "/dev/hugepages/process_scope_singletons";
+
+static unsigned parse_map_flags(const char* spec) {
+    unsigned flags = kShmMapPlain;
+    if (spec) {
+        if (std::strstr(spec, "populate")) {
+            flags |= kShmMapPopulate;
+        }
+        if (std::strstr(spec, "hugetlb")) {
+            flags |= kShmMapHugeTLB;
+        }
+        if (std::strstr(spec, "mlock")) {
+            flags |= kShmMapLock;
+        }
+    }
+    return flags;
+}
+
+static unsigned g_map_flags = parse_map_flags(std::getenv("SHM_LOGGER_MAP"));
+static std::size_t g_map_length = kShmSegmentSize;
+
+static std::size_t huge_page_size() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    std::size_t kb = 0;
+    while (meminfo >> key) {
+        if (key == "Hugepagesize:" && meminfo >> kb) {
+            return kb * 1024;
+        }
+        meminfo.ignore(256, '\n');
+    }
+    return 2 * 1024 * 1024;
+}
+
+// mmap the hugetlbfs file; nullptr (and a note) if huge pages are unavailable
+static void* map_hugetlb(int mmap_flags) {
+    int fd = open(HUGETLB_PATH, O_CREAT | O_RDWR, 0666);
     if (fd < 0) {
-        perror("shm_open failed");
-        std::abort();
+        std::cerr << "[shm] " << HUGETLB_PATH << ": " << std::strerror(errno)
+                  << ", falling back to " << SHM_NAME << "\n";
+        return nullptr;
+    }
+    std::size_t huge = huge_page_size();
+    std::size_t length = (kShmSegmentSize + huge - 1) / huge * huge;
+    void* addr = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(length)) == 0) {
+        addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, mmap_flags, fd, 0);
     }
+    int err = errno;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[shm] no huge pages for " << HUGETLB_PATH << ": " << std::strerror(err)
+                  << ", falling back to " << SHM_NAME << "\n";
+        return nullptr;
+    }
+    g_map_length = length;
+    return addr;
+}
 
-    // Set size (only effective on first creation)
-    if (ftruncate(fd, sizeof(ShmBlock)) < 0) {
-        perror("ftruncate failed");
-        close(fd);
-        std::abort();
+static void init_shm_block() {
+    int mmap_flags = MAP_SHARED | ((g_map_flags & kShmMapPopulate) ? MAP_POPULATE : 0);
+
+    void* addr = (g_map_flags & kShmMapHugeTLB) ? map_hugetlb(mmap_flags) : nullptr;
+    if (!addr) {
+        g_map_flags &= ~kShmMapHugeTLB;
+
+        // Open or create shared memory object
+        int fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+        if (fd < 0) {
+            perror("shm_open failed");
+            std::abort();
+        }
+
+        // Set size (a no-op once the segment exists)
+        if (ftruncate(fd, kShmSegmentSize) < 0) {
+            perror("ftruncate failed");
+            close(fd);
+            std::abort();
+        }
+
+        // Map into our address space
+        addr = mmap(nullptr, kShmSegmentSize, PROT_READ | PROT_WRITE, mmap_flags, fd, 0);
+        close(fd);  // fd can be closed after mmap
+
+        if (addr == MAP_FAILED) {
+            perror("mmap failed");
+            std::abort();
+        }
+        g_map_length = kShmSegmentSize;
+    }
+
+    // Keep the pages resident: no reclaim, no swap-in on the hot path
+    if ((g_map_flags & kShmMapLock) && mlock(addr, g_map_length) != 0) {
+        std::cerr << "[shm] mlock: " << std::strerror(errno) << " (see ulimit -l)\n";
+        g_map_flags &= ~kShmMapLock;
     }
 
-    // Map into our address space
-    void* addr = mmap(nullptr, sizeof(ShmBlock),
-                      PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    close(fd);  // fd can be closed after mmap
+    auto* block = static_cast<ShmBlock*>(addr);
+    std::cout << "[shm] mapped @" << block << "\n";
 
-    if (addr == MAP_FAILED) {
-        perror("mmap failed");
+    // Cross-process one-time init: losers sleep on the futex until it is
+    // ready; if the initializing process dies, one of them re-formats
+    bool formatted = block->init.call([block](bool recovering) {
+        if (recovering) {
+            std::cout << "[shm] previous initializer died, re-formatting arena\n";
+            block->recoveries.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::cout << "[shm] formatting arena\n";
+        }
+        if (g_init_fault_hook) {
+            g_init_fault_hook();
+        }
+        block->arena.init(kShmSegmentSize - offsetof(ShmBlock, arena));
+    });
+    if (!formatted) {
+        std::cout << "[shm] arena already initialized\n";
+    }
+    if (!block->arena.valid()) {
+        std::cerr << "[shm] " << SHM_NAME << " has an unknown layout (stale segment?)\n";
         std::abort();
     }
+    g_block.store(block, std::memory_order_release);
+}
 
-    g_block = static_cast<ShmBlock*>(addr);
-    std::cout << "[shm] mapped @" << g_block << "\n";
-
-    // One-time initialization using atomic flag
-    // Note: This is safe within a single process (multiple DSOs)
-    // For cross-process, we'd need a process-robust mutex
-    bool expected = false;
-    if (g_block->initialized.compare_exchange_strong(expected, true)) {
-        // We are the first to initialize
-        std::cout << "[shm] initializing ProcessLogger in shared memory\n";
-        new (g_block->storage) ProcessLogger("shared_memory");
-    } else {
-        std::cout << "[shm] ProcessLogger already initialized\n";
+// pthread_atfork child. The MAP_SHARED mapping and a finished init carry
+// over unchanged (the segment's pages stay shared, never copy-on-write); an
+// init another thread had in flight is redone, and mlock is re-applied
+// because memory locks are not inherited across fork()
+static void rearm_after_fork() {
+    ShmBlock* block = g_block.load(std::memory_order_acquire);
+    if (!block) {
+        new (&g_init_flag) std::once_flag;
+        return;
+    }
+    if ((g_map_flags & kShmMapLock) && mlock(block, g_map_length) != 0) {
+        g_map_flags &= ~kShmMapLock;
     }
 }
 
-ProcessLogger& get_shm_logger() {
+static const int g_atfork = pthread_atfork(nullptr, nullptr, rearm_after_fork);
+
+ShmArena& get_shm_arena() {
+    ShmBlock* block = g_block.load(std::memory_order_acquire);
+    if (__builtin_expect(block != nullptr, 1)) {
+        return block->arena;
+    }
     std::call_once(g_init_flag, init_shm_block);
-    return *reinterpret_cast<ProcessLogger*>(g_block->storage);
+    return g_block.load(std::memory_order_acquire)->arena;
+}
+
+void set_shm_map_flags(unsigned flags) {
+    g_map_flags = flags;
+}
+
+void set_shm_init_fault_hook(void (*hook)()) {
+    g_init_fault_hook = hook;
+}
+
+ShmMappingInfo shm_mapping_info() {
+    get_shm_arena();
+    return {g_block.load(std::memory_order_acquire), g_map_length, g_map_flags};
+}
+
+std::uint32_t shm_recoveries() {
+    get_shm_arena();
+    return g_block.load(std::memory_order_acquire)->recoveries.load(std::memory_order_relaxed);
+}
+
+ProcessLogger& get_shm_logger() {
+    SINGLETON_ACCESS("get_shm_logger");
+    static ProcessLogger& logger = get_shm_singleton<ProcessLogger>("ProcessLogger", "shared_memory");
+    return logger;
 }
 
 void cleanup_shm_logger() {
-    if (g_block) {
-        munmap(g_block, sizeof(ShmBlock));
-        g_block = nullptr;
+    // The kernel drops the mapping at exit anyway; keep the syscall (and the
+    // TLB shootdown with other threads running) out of a fast exit
+    if (fast_exit::enabled()) {
+        return;
+    }
+    if (ShmBlock* block = g_block.exchange(nullptr)) {
+        munmap(block, g_map_length);
     }
     // Optionally unlink (remove) the shared memory object
     // Only the last process should do this
     // shm_unlink(SHM_NAME);
 }
+
+void unlink_shm_segment() {
+    shm_unlink(SHM_NAME);
+}
@@ -1,19 +1,63 @@
 #pragma once
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+
+#include "shm_arena.hpp"
+#include "shm_once.hpp"
 
 struct ProcessLogger;
 
-// Shared memory block layout
-// This structure lives in kernel-managed shared memory
+// Size of the whole shared segment; pages are only backed once touched
+constexpr std::size_t kShmSegmentSize = 1 << 20;
+
+// Shared memory segment layout
+// This structure lives in kernel-managed shared memory; the arena's heap
+// fills the rest of the segment after it
 struct ShmBlock {
-    std::atomic<bool> initialized{false};  // Atomic flag for one-time init
-    alignas(64) char storage[256];  // Storage for ProcessLogger (aligned)
+    ShmOnce init;                     // uninit / <pid> initializing / ready / owner-dead
+    std::atomic<std::uint32_t> recoveries;  // Times a dead initializer was replaced
+    alignas(64) ShmArena arena;       // Directory of named singletons
+};
+
+// How this process maps the segment (see set_shm_map_flags)
+enum ShmMapFlags : unsigned {
+    kShmMapPlain = 0,
+    kShmMapPopulate = 1u << 0,  // MAP_POPULATE: prefault every page at attach
+    kShmMapHugeTLB = 1u << 1,   // Back the segment with hugetlbfs (/dev/hugepages)
+    kShmMapLock = 1u << 2,      // mlock the mapping
 };
 
+// Mapping options for this process; only effective before the first attach.
+// Default: $SHM_LOGGER_MAP, e.g. "populate,mlock" or "hugetlb,populate".
+// hugetlb moves the segment to another file, so every process attaching to
+// it must use it; it falls back to the normal segment if huge pages are
+// unavailable.
+void set_shm_map_flags(unsigned flags);
+
+// Test seam: hook runs inside this process's one-time format of a fresh
+// segment, before the arena is written (shared_memory_demo --crash-test
+// kills the process there). Only effective before the first attach.
+void set_shm_init_fault_hook(void (*hook)());
+
+struct ShmMappingInfo {
+    void* base;
+    std::size_t length;
+    unsigned flags;  // Effective flags after any fallback
+};
+
+ShmMappingInfo shm_mapping_info();
+
 // Get the singleton logger from shared memory
 // First caller creates and initializes it, subsequent callers get the same instance
 ProcessLogger& get_shm_logger();
 
-// Cleanup shared memory (call once at program exit)
+// Number of times any process recovered the segment from a dead initializer
+std::uint32_t shm_recoveries();
+
+// Cleanup shared memory (call once at program exit); a no-op under
+// fast_exit::enabled(), where the mapping simply goes away with the process
 void cleanup_shm_logger();
+
+// Remove the named segment; processes that have it mapped keep their mapping
+void unlink_shm_segment();
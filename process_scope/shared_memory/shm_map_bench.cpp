@@ -0,0 +1,184 @@
+// shm_map_bench: attach / first-touch cost of the shared segment per mapping mode
+//
+// Every sample runs in a fresh child process that sets the mode, attaches
+// (get_shm_arena), then touches every page of the segment and resolves the
+// logger. Page faults come from getrusage(RUSAGE_SELF) around each step.
+//
+// Usage: shm_map_bench [samples]
+#include "shm_logger.hpp"
+#include "process_logger.hpp"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Sample {
+    double attach_us;   // shm_open / mmap (+ populate, mlock)
+    double touch_us;    // First touch of every page
+    double logger_us;   // First get_shm_logger()
+    long attach_minflt;
+    long touch_minflt;
+    long majflt;
+    unsigned effective;
+};
+
+static long minflt() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt;
+}
+
+static long majflt() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_majflt;
+}
+
+static Sample measure_child(unsigned flags) {
+    using clock = std::chrono::steady_clock;
+    auto us = [](clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double, std::micro>(b - a).count();
+    };
+    Sample s{};
+    set_shm_map_flags(flags);
+
+    long f0 = minflt();
+    long m0 = majflt();
+    auto t0 = clock::now();
+    get_shm_arena();
+    auto t1 = clock::now();
+    long f1 = minflt();
+
+    ShmMappingInfo info = shm_mapping_info();
+    auto* p = static_cast<volatile char*>(info.base);
+    long page = sysconf(_SC_PAGESIZE);
+    for (std::size_t off = 0; off < info.length; off += static_cast<std::size_t>(page)) {
+        (void)p[off];
+    }
+    auto t2 = clock::now();
+    long f2 = minflt();
+
+    get_shm_logger();
+    auto t3 = clock::now();
+
+    s.attach_us = us(t0, t1);
+    s.touch_us = us(t1, t2);
+    s.logger_us = us(t2, t3);
+    s.attach_minflt = f1 - f0;
+    s.touch_minflt = f2 - f1;
+    s.majflt = majflt() - m0;
+    s.effective = info.flags;
+    return s;
+}
+
+static bool run_child(unsigned flags, Sample& out) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);  // Silence [shm] / ctor lines
+        dup2(devnull, STDERR_FILENO);  // Fallback notes show up as "effective"
+        Sample s = measure_child(flags);
+        ssize_t ignored = write(fds[1], &s, sizeof(s));
+        (void)ignored;
+        _exit(0);
+    }
+    close(fds[1]);
+    bool ok = read(fds[0], &out, sizeof(out)) == sizeof(out);
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return ok;
+}
+
+static std::string flag_names(unsigned flags) {
+    std::string s;
+    auto add = [&](const char* n) { s += s.empty() ? n : std::string("+") + n; };
+    if (flags & kShmMapHugeTLB) {
+        add("hugetlb");
+    }
+    if (flags & kShmMapPopulate) {
+        add("populate");
+    }
+    if (flags & kShmMapLock) {
+        add("mlock");
+    }
+    return s.empty() ? "plain" : s;
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+    int samples = argc > 1 ? std::atoi(argv[1]) : 9;
+
+    const unsigned modes[] = {
+        kShmMapPlain,
+        kShmMapPopulate,
+        kShmMapLock,
+        kShmMapPopulate | kShmMapLock,
+        kShmMapHugeTLB,
+        kShmMapHugeTLB | kShmMapPopulate,
+    };
+
+    std::cout << "=== Shared Segment Mapping Modes ===\n";
+    std::cout << "segment=" << kShmSegmentSize << " bytes, samples=" << samples << "\n\n";
+    std::cout << std::left << std::setw(18) << "mode" << std::setw(18) << "effective" << std::right
+              << std::setw(11) << "attach(us)" << std::setw(11) << "touch(us)"
+              << std::setw(12) << "logger(us)" << std::setw(13) << "attach flt"
+              << std::setw(11) << "touch flt" << std::setw(8) << "majflt" << "\n";
+
+    Sample warmup;
+    run_child(kShmMapPlain, warmup);  // Create the segment, warm caches
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (unsigned mode : modes) {
+        std::vector<Sample> runs;
+        for (int i = 0; i < samples; ++i) {
+            Sample s;
+            if (run_child(mode, s)) {
+                runs.push_back(s);
+            }
+        }
+        if (runs.empty()) {
+            std::cout << std::left << std::setw(18) << flag_names(mode) << "failed\n";
+            continue;
+        }
+        auto median = [&](double Sample::*field) {
+            std::vector<double> v;
+            for (const Sample& s : runs) {
+                v.push_back(s.*field);
+            }
+            std::sort(v.begin(), v.end());
+            return v[v.size() / 2];
+        };
+        const Sample& last = runs.back();
+        std::cout << std::left << std::setw(18) << flag_names(mode)
+                  << std::setw(18) << flag_names(last.effective) << std::right
+                  << std::setw(11) << median(&Sample::attach_us)
+                  << std::setw(11) << median(&Sample::touch_us)
+                  << std::setw(12) << median(&Sample::logger_us)
+                  << std::setw(13) << last.attach_minflt << std::setw(11) << last.touch_minflt
+                  << std::setw(8) << last.majflt << "\n";
+    }
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "attach: shm_open + mmap (+ MAP_POPULATE prefault, + mlock)\n";
+    std::cout << "touch: first read of every page; without prefaulting the faults land here\n";
+    std::cout << "       (fault-around maps several tmpfs pages per fault)\n";
+    std::cout << "effective: flags after fallback (hugetlb needs hugetlbfs at /dev/hugepages\n";
+    std::cout << "           and reserved pages; mlock needs a large enough ulimit -l)\n";
+    std::cout << "Times are medians; fault counts are from the last sample\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+// Cross-process, crash-robust once flag for objects in shared memory.
+//
+// One 32-bit word is both the state and the futex:
+//   0           uninit
+//   <pid>       being initialized by process <pid>
+//   kOwnerDead  the initializer died; the next caller re-runs init
+//   kReady      done, published with a release store
+//
+// Waiters sleep in FUTEX_WAIT (not FUTEX_PRIVATE: the word is in a shared
+// mapping). Each time the wait times out they check whether the owner pid
+// still exists; if it does not, the word becomes kOwnerDead and one waiter
+// takes over. Pids are only meaningful inside one pid namespace.
+class ShmOnce {
+public:
+    static constexpr std::uint32_t kReady = 1u << 31;
+    static constexpr std::uint32_t kOwnerDead = 1u << 30;
+    static constexpr long kPollMs = 20;  // Owner-liveness check interval
+
+    // Fast path: a single acquire load
+    bool ready() const { return word_.load(std::memory_order_acquire) == kReady; }
+
+    // Run init(recovering) unless some process already completed it. At most
+    // one caller runs it at a time; if that caller dies, a waiter runs it again
+    // with recovering == true. If init throws, the flag goes back to uninit.
+    // Returns true if this caller ran init.
+    template <typename Init>
+    bool call(Init&& init) {
+        const auto self = static_cast<std::uint32_t>(getpid());
+        for (;;) {
+            std::uint32_t w = word_.load(std::memory_order_acquire);
+            if (w == kReady) {
+                return false;
+            }
+            if (w == 0 || w == kOwnerDead) {
+                if (!word_.compare_exchange_strong(w, self, std::memory_order_acquire)) {
+                    continue;
+                }
+                try {
+                    init(w == kOwnerDead);
+                } catch (...) {
+                    word_.store(0, std::memory_order_release);
+                    wake();
+                    throw;
+                }
+                word_.store(kReady, std::memory_order_release);
+                wake();
+                return true;
+            }
+            if (!wait(w) && !process_alive(static_cast<pid_t>(w))) {
+                if (word_.compare_exchange_strong(w, kOwnerDead, std::memory_order_relaxed)) {
+                    wake();
+                }
+            }
+        }
+    }
+
+    // EPERM means the process exists but belongs to someone else
+    static bool process_alive(pid_t pid) { return kill(pid, 0) == 0 || errno != ESRCH; }
+
+    // Only while no other process can be using the flag (e.g. while formatting)
+    void reset() { word_.store(0, std::memory_order_relaxed); }
+
+private:
+    std::uint32_t* addr() { return reinterpret_cast<std::uint32_t*>(&word_); }
+
+    // false on timeout; spurious and value-changed wakeups return true
+    bool wait(std::uint32_t expected) {
+        timespec ts{0, kPollMs * 1000000L};
+        long rc = syscall(SYS_futex, addr(), FUTEX_WAIT, expected, &ts, nullptr, 0);
+        return !(rc == -1 && errno == ETIMEDOUT);
+    }
+
+    void wake() { syscall(SYS_futex, addr(), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0); }
+
+    std::atomic<std::uint32_t> word_;
+};
+
+static_assert(sizeof(ShmOnce) == sizeof(std::uint32_t), "futex word must be 32 bits");
@@ -4,16 +4,37 @@ Singleton Scope Report Generator
 
 Generates a Markdown report for the C++ singleton scope tutorial,
 suitable for presentation slides.
+
+With benchmark results (singleton_bench JSON), the report also gets a
+runtime cost section, and a comparison against a stored baseline that
+flags regressions:
+
+    ./build/bin/singleton_bench > run1.json
+    scripts/generate_report.py --bench run1.json --baseline bench_baseline.json
+    scripts/generate_report.py --bench run1.json --save-baseline bench_baseline.json
 """
 
+import argparse
+import json
 import re
+import statistics
+import sys
 from pathlib import Path
-from typing import Optional, Dict, Any
+from typing import Optional, Dict, Any, List, Tuple
 
 # Project root directory
 PROJECT_ROOT = Path(__file__).parent.parent
 OUTPUT_FILE = PROJECT_ROOT / "singleton_scope_report.md"
 
+BENCH_SCHEMA = "singleton_bench/1"
+SCOPE_ORDER = ["tu_scope", "dso_scope", "thread_scope", "process_scope"]
+
+# A metric regresses when it is both this much slower relative to the
+# baseline and above the absolute floor for its unit (timer noise). The us
+# metrics come from a handful of fresh processes and are noisier.
+DEFAULT_THRESHOLD_PCT = {"ns": 10.0, "us": 25.0}
+NOISE_FLOOR = {"ns": 0.5, "us": 5.0}
+
 
 # =============================================================================
 # SCOPE DEFINITIONS
@@ -530,15 +551,214 @@ Single binary with multiple TUs?
 ```"""
 
 
+# =============================================================================
+# BENCHMARK RESULTS
+# =============================================================================
+
+def load_bench(paths: List[Path]) -> Optional[dict]:
+    """
+    Load singleton_bench JSON files and merge them into one document.
+    Repeated runs of the same variant are combined by taking the median
+    of every metric.
+    """
+    docs = []
+    for path in paths:
+        doc = json.loads(path.read_text(encoding="utf-8"))
+        if doc.get("schema") != BENCH_SCHEMA:
+            raise ValueError(f"{path}: not a {BENCH_SCHEMA} document")
+        docs.append(doc)
+    if not docs:
+        return None
+
+    runs: Dict[str, List[dict]] = {}
+    for doc in docs:
+        for acc in doc["accessors"]:
+            runs.setdefault(acc["variant"], []).append(acc)
+
+    def median(values):
+        values = [v for v in values if v is not None]
+        return statistics.median(values) if values else None
+
+    accessors = []
+    for variant, accs in runs.items():
+        merged = dict(accs[0])
+        for key in ("load_us", "first_access_us"):
+            merged[key] = median(a[key] for a in accs)
+        threads = sorted({p["threads"] for a in accs for p in a["scaling"]})
+        merged["scaling"] = [
+            {"threads": t, "ns_per_call": median(p["ns_per_call"] for a in accs
+                                                 for p in a["scaling"] if p["threads"] == t)}
+            for t in threads
+        ]
+        race = dict(accs[0]["first_access_race"])
+        for key in ("max_us", "p50_us"):
+            race[key] = median(a["first_access_race"][key] for a in accs)
+        merged["first_access_race"] = race
+        accessors.append(merged)
+
+    return {
+        "schema": BENCH_SCHEMA,
+        "host": docs[0]["host"],
+        "params": docs[0]["params"],
+        "runs": len(docs),
+        "accessors": accessors,
+        "failures": sum(d.get("failures", 0) for d in docs),
+    }
+
+
+def bench_metrics(doc: dict) -> Dict[Tuple[str, str], Tuple[float, str]]:
+    """Flatten a bench document to {(variant, metric): (value, unit)}."""
+    metrics = {}
+    for acc in doc["accessors"]:
+        variant = acc["variant"]
+        for point in acc["scaling"]:
+            metrics[(variant, f"ns_per_call@{point['threads']}")] = (point["ns_per_call"], "ns")
+        for key in ("first_access_us", "load_us"):
+            if acc.get(key) is not None:
+                metrics[(variant, key)] = (acc[key], "us")
+        race = acc["first_access_race"]
+        if race.get("max_us") is not None:
+            metrics[(variant, f"race_max_us@{race['threads']}")] = (race["max_us"], "us")
+    return metrics
+
+
+def compare_to_baseline(current: dict, baseline: dict,
+                        threshold_pct: Dict[str, float]) -> List[dict]:
+    """Every metric present in both documents, with its verdict."""
+    cur = bench_metrics(current)
+    base = bench_metrics(baseline)
+    rows = []
+    for key in sorted(cur.keys() & base.keys()):
+        value, unit = cur[key]
+        old, _ = base[key]
+        delta = value - old
+        pct = (delta / old * 100.0) if old else 0.0
+        if pct > threshold_pct[unit] and delta > NOISE_FLOOR[unit]:
+            status = "REGRESSION"
+        elif pct < -threshold_pct[unit] and -delta > NOISE_FLOOR[unit]:
+            status = "improved"
+        else:
+            status = "ok"
+        rows.append({"variant": key[0], "metric": key[1], "unit": unit,
+                     "baseline": old, "current": value, "pct": pct, "status": status})
+    return rows
+
+
+def fmt(value: Optional[float], digits: int = 2) -> str:
+    return "—" if value is None else f"{value:.{digits}f}"
+
+
+def generate_bench_section(doc: dict, comparison: Optional[List[dict]],
+                           baseline: Optional[dict], threshold_pct: Dict[str, float]) -> str:
+    """Generate the runtime cost section from singleton_bench results."""
+    host = doc["host"]
+    params = doc["params"]
+    sections = [
+        "## 9. Runtime Cost (singleton_bench)",
+        "",
+        f"Host: {host['cpus']} CPU(s), {host['machine']}, kernel {host['kernel']}, "
+        f"compiler {host['compiler']}. {doc['runs']} run(s), "
+        f"{params['iterations']:,} iterations, {params['samples']} fresh-process samples.",
+        "",
+        "- **ns/call**: accessor called from a dlopen'ed plugin, slowest thread",
+        "- **scaling**: ns/call at the highest thread count divided by ns/call at 1 thread",
+        "- **first access**: first call after dlopen; **race**: slowest of "
+        f"{params['race_threads']} threads released together into the first call",
+    ]
+    if doc.get("failures"):
+        sections.append(f"\n**{doc['failures']} probe(s) failed; their rows are missing.**")
+
+    by_scope: Dict[str, List[dict]] = {}
+    for acc in doc["accessors"]:
+        by_scope.setdefault(acc["scope"], []).append(acc)
+    for scope in SCOPE_ORDER + sorted(by_scope.keys() - set(SCOPE_ORDER)):
+        if scope not in by_scope:
+            continue
+        sections += [
+            "",
+            f"### {scope}",
+            "",
+            "| Variant | Accessor | ns/call (1 thr) | ns/call (max thr) | Scaling | "
+            "First access (us) | dlopen (us) | Race max (us) |",
+            "|---------|----------|-----------------|-------------------|---------|"
+            "-------------------|-------------|---------------|",
+        ]
+        for acc in by_scope[scope]:
+            scaling = acc["scaling"]
+            one = scaling[0]["ns_per_call"] if scaling else None
+            top = scaling[-1] if scaling else None
+            factor = (top["ns_per_call"] / one) if top and one else None
+            sections.append(
+                f"| {acc['variant']} | `{acc['accessor']}` | {fmt(one)} | "
+                f"{fmt(top['ns_per_call'] if top else None)} ({top['threads'] if top else '—'}) | "
+                f"{fmt(factor)}x | {fmt(acc['first_access_us'])} | {fmt(acc['load_us'], 1)} | "
+                f"{fmt(acc['first_access_race']['max_us'], 1)} |")
+
+    if comparison is not None:
+        regressions = [r for r in comparison if r["status"] == "REGRESSION"]
+        sections += [
+            "",
+            "### Baseline Comparison",
+            "",
+            f"Threshold: +{threshold_pct['ns']:g}% and more than {NOISE_FLOOR['ns']} ns for "
+            f"ns/call, +{threshold_pct['us']:g}% and more than {NOISE_FLOOR['us']} us for "
+            "startup metrics. "
+            f"**{len(regressions)} regression(s)** in {len(comparison)} metric(s).",
+        ]
+        base_host = baseline["host"] if baseline else {}
+        if base_host and (base_host.get("cpus"), base_host.get("compiler")) != \
+                (host["cpus"], host["compiler"]):
+            sections.append(f"\n> Baseline host differs ({base_host.get('cpus')} CPU(s), "
+                            f"compiler {base_host.get('compiler')}): compare with care.")
+        sections += [
+            "",
+            "| Variant | Metric | Baseline | Current | Delta | Status |",
+            "|---------|--------|----------|---------|-------|--------|",
+        ]
+        # Regressions first, then the rest in variant order
+        order = {"REGRESSION": 0, "improved": 1, "ok": 2}
+        for r in sorted(comparison, key=lambda r: order[r["status"]]):
+            status = "**REGRESSION**" if r["status"] == "REGRESSION" else r["status"]
+            sections.append(
+                f"| {r['variant']} | {r['metric']} | {fmt(r['baseline'])} {r['unit']} | "
+                f"{fmt(r['current'])} {r['unit']} | {r['pct']:+.1f}% | {status} |")
+
+    return "\n".join(sections)
+
+
 # =============================================================================
 # MAIN
 # =============================================================================
 
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Generate the singleton scope report.")
+    parser.add_argument("--bench", type=Path, action="append", default=[],
+                        help="singleton_bench JSON (repeat to merge runs by median)")
+    parser.add_argument("--baseline", type=Path,
+                        help="stored singleton_bench JSON to compare against")
+    parser.add_argument("--save-baseline", type=Path,
+                        help="write the merged --bench results as the new baseline")
+    parser.add_argument("--threshold", type=float, default=DEFAULT_THRESHOLD_PCT["ns"],
+                        help="ns/call regression threshold in percent (default: %(default)s)")
+    parser.add_argument("--threshold-us", type=float, default=DEFAULT_THRESHOLD_PCT["us"],
+                        help="first-access / dlopen / race threshold in percent "
+                             "(default: %(default)s)")
+    parser.add_argument("--fail-on-regression", action="store_true",
+                        help="exit 1 when the baseline comparison finds a regression")
+    parser.add_argument("--output", type=Path, default=OUTPUT_FILE,
+                        help="report path (default: %(default)s)")
+    return parser.parse_args()
+
+
 def main():
     """Generate the singleton scope report."""
+    args = parse_args()
+    if (args.baseline or args.save_baseline) and not args.bench:
+        sys.exit("--baseline / --save-baseline need at least one --bench file")
+
     print(f"Generating report...")
     print(f"Project root: {PROJECT_ROOT}")
-    print(f"Output file: {OUTPUT_FILE}")
+    print(f"Output file: {args.output}")
 
     # Generate all sections
     sections = [
@@ -552,14 +772,36 @@ def main():
         generate_takeaways(),
     ]
 
+    regressions = 0
+    thresholds = {"ns": args.threshold, "us": args.threshold_us}
+    bench = load_bench(args.bench)
+    if bench:
+        baseline = comparison = None
+        if args.baseline:
+            baseline = json.loads(args.baseline.read_text(encoding="utf-8"))
+            comparison = compare_to_baseline(bench, baseline, thresholds)
+            for r in comparison:
+                if r["status"] == "REGRESSION":
+                    regressions += 1
+                    print(f"REGRESSION: {r['variant']} {r['metric']}: "
+                          f"{r['baseline']:.3f} -> {r['current']:.3f} {r['unit']} ({r['pct']:+.1f}%)")
+        sections.append(generate_bench_section(bench, comparison, baseline, thresholds))
+        if args.save_baseline:
+            args.save_baseline.write_text(json.dumps(bench, indent=2) + "\n", encoding="utf-8")
+            print(f"Baseline saved: {args.save_baseline}")
+
     report = "\n\n".join(sections)
 
     # Write output
-    OUTPUT_FILE.write_text(report, encoding="utf-8")
+    args.output.write_text(report, encoding="utf-8")
 
     print(f"\nReport generated successfully!")
     print(f"Size: {len(report):,} characters")
     print(f"Lines: {report.count(chr(10)):,}")
+    if args.baseline:
+        print(f"Regressions: {regressions}")
+    if regressions and args.fail_on_regression:
+        sys.exit(1)
 
 
 if __name__ == "__main__":
@@ -1,4 +1,6 @@
 #include "thread_logger.hpp"
+#include <cstring>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -6,7 +8,15 @@ void worker(int id) {
     get_thread_logger().log(("worker " + std::to_string(id)).c_str());
 }
 
-int main() {
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    // --buffered: per-thread batches, flushed by one writer thread
+    std::unique_ptr<ThreadLogWriter> writer;
+    if (argc > 1 && std::strcmp(argv[1], "--buffered") == 0) {
+        writer = std::make_unique<ThreadLogWriter>();
+    }
+
     std::cout << "=== Thread Scope Basic Demo ===\n\n";
 
     get_thread_logger().log("main");
@@ -20,6 +30,18 @@ int main() {
         t.join();
     }
 
+    if (writer) {
+        // Workers flushed their batches at thread exit; main flushes explicitly
+        get_thread_logger().flush();
+        writer->stop();  // Drains the queue and joins the writer thread
+        std::cout << "\n[buffered] " << writer->batches() << " batch(es) handed to the writer";
+        if (writer->lost_batches() != 0) {
+            std::cout << ", " << writer->lost_batches() << " not written (writev failed)";
+        }
+        std::cout << "\n";
+        writer.reset();
+    }
+
     std::cout << "\n=== Expected Result ===\n";
     std::cout << "Each thread has its own ThreadLogger (different addresses)\n";
 
@@ -0,0 +1,78 @@
+#pragma once
+#include "thread_logger.hpp"
+#include <new>
+#include <type_traits>
+
+// Guard-free per-thread ThreadLogger.
+//
+// `inline thread_local ThreadLogger` has a non-trivial constructor, so every
+// access goes through the TLS init wrapper (_ZTW*, a guard check and often a
+// PLT call from a .so). Here the TLS itself is trivially initialized - raw
+// storage plus a pointer that starts as nullptr - and the object is built
+// explicitly:
+//   - fast_thread_logger::attach() at thread start (e.g. via spawn()), after
+//     which get_thread_logger_unchecked() is a single TLS load, or
+//   - lazily on the cold slow path of get_thread_logger_fast().
+//
+// The TLS uses the initial-exec model so that even inside a -fPIC .so the
+// fast path is one %fs-relative load instead of a __tls_get_addr call. That is
+// correct for libraries linked at startup; a dlopen()ed library must define
+// FAST_THREAD_LOGGER_TLS_MODEL to "global-dynamic".
+#ifndef FAST_THREAD_LOGGER_TLS_MODEL
+#define FAST_THREAD_LOGGER_TLS_MODEL "initial-exec"
+#endif
+
+namespace fast_thread_logger {
+
+#define FAST_TLS __attribute__((tls_model(FAST_THREAD_LOGGER_TLS_MODEL)))
+
+inline thread_local std::aligned_storage_t<sizeof(ThreadLogger), alignof(ThreadLogger)>
+    g_storage FAST_TLS;
+inline thread_local ThreadLogger* g_instance FAST_TLS = nullptr;
+
+#undef FAST_TLS
+
+// Only touched on the slow path; its destructor tears the logger down at thread exit
+struct Reaper {
+    ~Reaper() {
+        if (g_instance) {
+            g_instance->~ThreadLogger();
+            g_instance = nullptr;
+        }
+    }
+};
+
+// Cold path: construct in place and arrange destruction
+__attribute__((noinline, cold)) inline ThreadLogger& attach() {
+    if (!g_instance) {
+        static thread_local Reaper reaper;
+        (void)reaper;
+        g_instance = new (&g_storage) ThreadLogger();
+    }
+    return *g_instance;
+}
+
+// Thread-start hook: runs fn on a new std::thread with the logger pre-attached
+template <typename Fn>
+std::thread spawn(Fn fn) {
+    return std::thread([fn = std::move(fn)]() mutable {
+        attach();
+        fn();
+    });
+}
+
+}  // namespace fast_thread_logger
+
+// One TLS load + a well-predicted branch
+inline ThreadLogger& get_thread_logger_fast() {
+    ThreadLogger* p = fast_thread_logger::g_instance;
+    if (__builtin_expect(p != nullptr, 1)) {
+        return *p;
+    }
+    return fast_thread_logger::attach();
+}
+
+// One TLS load; only valid after attach() ran on this thread
+inline ThreadLogger& get_thread_logger_unchecked() {
+    return *fast_thread_logger::g_instance;
+}
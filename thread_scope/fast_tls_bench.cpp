@@ -0,0 +1,90 @@
+// thread_fast_tls_bench: inline thread_local ThreadLogger (TLS init wrapper)
+// vs trivially-initialized TLS with explicit construction.
+//
+// Usage: thread_fast_tls_bench [iterations]
+#include "fast_thread_logger.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#define FAST_TLS_LOOP(name, expr)                                            \
+    extern "C" __attribute__((noinline))                                     \
+    std::uintptr_t name(std::uint64_t n) {                                   \
+        std::uintptr_t sum = 0;                                              \
+        for (std::uint64_t i = 0; i < n; ++i) {                              \
+            sum += reinterpret_cast<std::uintptr_t>(&(expr));                \
+            asm volatile("" : "+r"(sum) : : "memory");                       \
+        }                                                                    \
+        return sum;                                                          \
+    }
+
+FAST_TLS_LOOP(fast_tls_exe_inline, get_thread_logger())
+FAST_TLS_LOOP(fast_tls_exe_fast, get_thread_logger_fast())
+FAST_TLS_LOOP(fast_tls_exe_unchecked, get_thread_logger_unchecked())
+
+extern "C" std::uintptr_t fast_tls_lib_inline(std::uint64_t);
+extern "C" std::uintptr_t fast_tls_lib_fast(std::uint64_t);
+extern "C" std::uintptr_t fast_tls_lib_unchecked(std::uint64_t);
+
+using LoopFn = std::uintptr_t (*)(std::uint64_t);
+
+static double ns_per_access(LoopFn loop, std::uint64_t iters) {
+    loop(1000);
+    auto start = std::chrono::steady_clock::now();
+    std::uintptr_t sum = loop(iters);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    asm volatile("" : : "r"(sum));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+static void report(std::uint64_t iters) {
+    struct Row {
+        const char* name;
+        LoopFn exe;
+        LoopFn lib;
+    };
+    const Row rows[] = {
+        {"inline thread_local", fast_tls_exe_inline, fast_tls_lib_inline},
+        {"fast (ptr + branch)", fast_tls_exe_fast, fast_tls_lib_fast},
+        {"unchecked (attach)", fast_tls_exe_unchecked, fast_tls_lib_unchecked},
+    };
+    std::cout << std::left << std::setw(22) << "accessor" << std::right
+              << std::setw(12) << "exe ns/op" << std::setw(12) << "lib ns/op" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (const Row& r : rows) {
+        std::cout << std::left << std::setw(22) << r.name << std::right
+                  << std::setw(12) << ns_per_access(r.exe, iters)
+                  << std::setw(12) << ns_per_access(r.lib, iters) << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    std::uint64_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000ULL;
+
+    std::cout << "=== Thread Scope Guard-Free TLS Benchmark ===\n";
+    std::cout << "iterations=" << iters << "\n\n";
+
+    // Main thread: attach explicitly, then compare
+    fast_thread_logger::attach();
+    get_thread_logger();
+    report(iters);
+
+    // Worker thread started through the thread-start hook
+    std::cout << "\n[worker started via fast_thread_logger::spawn]\n";
+    fast_thread_logger::spawn([iters] {
+        get_thread_logger();
+        report(iters);
+    }).join();
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "inline thread_local: TLS init wrapper + guard check per access\n";
+    std::cout << "fast: trivially-initialized TLS pointer, ctor on a cold slow path\n";
+    std::cout << "unchecked: single TLS load, requires attach() at thread start\n";
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+// Shared-library side of thread_fast_tls_bench: the same loops, but compiled
+// -fPIC into a .so where the TLS init wrapper is reached through the PLT.
+#include "fast_thread_logger.hpp"
+#include <cstdint>
+
+#define FAST_TLS_LOOP(name, expr)                                            \
+    extern "C" __attribute__((visibility("default"), noinline))              \
+    std::uintptr_t name(std::uint64_t n) {                                   \
+        std::uintptr_t sum = 0;                                              \
+        for (std::uint64_t i = 0; i < n; ++i) {                              \
+            sum += reinterpret_cast<std::uintptr_t>(&(expr));                \
+            asm volatile("" : "+r"(sum) : : "memory");                       \
+        }                                                                    \
+        return sum;                                                          \
+    }
+
+FAST_TLS_LOOP(fast_tls_lib_inline, get_thread_logger())
+FAST_TLS_LOOP(fast_tls_lib_fast, get_thread_logger_fast())
+FAST_TLS_LOOP(fast_tls_lib_unchecked, get_thread_logger_unchecked())
@@ -11,6 +11,8 @@ void test_cross_dso() {
 }
 
 int main() {
+    startup_report::mark_main();
+
     std::cout << "=== Thread Scope Mixed Demo (Cross-DSO) ===\n\n";
 
     std::cout << "[Main Thread]\n";
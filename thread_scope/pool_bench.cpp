@@ -0,0 +1,212 @@
+// thread_pool_bench: ThreadLogger construction churn, raw threads vs a pool
+//
+// Every task touches get_thread_logger() and does a little work. With one
+// std::thread per task, each task pays for a ThreadLogger ctor + dtor; with a
+// fixed work-stealing pool, only one ThreadLogger per worker is ever built.
+//
+// Usage: thread_pool_bench [pool_tasks] [raw_tasks] [work_iters]
+#include "thread_logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static unsigned g_work_iters = 200;
+
+// One task: touch the thread-scope singleton, burn a little CPU
+static void run_task() {
+    std::uintptr_t acc = reinterpret_cast<std::uintptr_t>(&get_thread_logger());
+    for (unsigned i = 0; i < g_work_iters; ++i) {
+        acc = acc * 6364136223846793005ULL + 1;
+        asm volatile("" : "+r"(acc));
+    }
+}
+
+// Fixed-size pool; each worker owns a deque and steals from the others when
+// its own is empty (owner pops the back, thieves take the front)
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(unsigned workers) : queues_(workers) {
+        for (unsigned i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        stop_.store(true, std::memory_order_release);
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    void submit(Task task) {
+        unsigned q = next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(queues_[q].mutex);
+        queues_[q].tasks.push_back(std::move(task));
+    }
+
+    void wait_idle() {
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool pop_local(unsigned i, Task& out) {
+        std::lock_guard<std::mutex> lock(queues_[i].mutex);
+        if (queues_[i].tasks.empty()) {
+            return false;
+        }
+        out = std::move(queues_[i].tasks.back());
+        queues_[i].tasks.pop_back();
+        return true;
+    }
+
+    bool steal(unsigned self, Task& out) {
+        for (unsigned n = 1; n < queues_.size(); ++n) {
+            Queue& victim = queues_[(self + n) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(unsigned i) {
+        Task task;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (pop_local(i, task) || steal(i, task)) {
+                task();
+                pending_.fetch_sub(1, std::memory_order_release);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<unsigned> next_{0};
+    std::atomic<std::uint64_t> pending_{0};
+    std::atomic<bool> stop_{false};
+};
+
+struct Result {
+    double tasks_per_sec;
+    std::uint64_t tls_created;
+    double p50_us, p99_us, p999_us;
+};
+
+static Result summarize(std::vector<double>& latency_us, Clock::duration elapsed,
+                        std::uint64_t tls_before) {
+    std::sort(latency_us.begin(), latency_us.end());
+    auto pct = [&](double p) {
+        return latency_us[std::min(latency_us.size() - 1,
+                                   static_cast<std::size_t>(p * latency_us.size()))];
+    };
+    double secs = std::chrono::duration<double>(elapsed).count();
+    return Result{latency_us.size() / secs, ThreadLogger::instances_created() - tls_before,
+                  pct(0.50), pct(0.99), pct(0.999)};
+}
+
+// Baseline: one fresh std::thread per task (what basic_demo.cpp does)
+static Result run_raw(std::size_t tasks) {
+    std::vector<double> latency(tasks);
+    std::uint64_t before = ThreadLogger::instances_created();
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < tasks; ++i) {
+        auto submitted = Clock::now();
+        std::thread([&, i, submitted] {
+            run_task();
+            latency[i] = std::chrono::duration<double, std::micro>(Clock::now() - submitted).count();
+        }).join();
+    }
+    return summarize(latency, Clock::now() - start, before);
+}
+
+static Result run_pool(unsigned workers, std::size_t tasks) {
+    std::vector<double> latency(tasks);
+    std::uint64_t before = ThreadLogger::instances_created();
+    auto start = Clock::now();
+    {
+        WorkStealingPool pool(workers);
+        for (std::size_t i = 0; i < tasks; ++i) {
+            auto submitted = Clock::now();
+            pool.submit([&latency, i, submitted] {
+                run_task();
+                latency[i] = std::chrono::duration<double, std::micro>(Clock::now() - submitted).count();
+            });
+        }
+        pool.wait_idle();
+    }
+    return summarize(latency, Clock::now() - start, before);
+}
+
+static void print_row(std::FILE* out, const char* name, unsigned workers, const Result& r) {
+    std::fprintf(out, "%-6s %8u %14.0f %12llu %10.2f %10.2f %10.2f\n", name, workers,
+                 r.tasks_per_sec, static_cast<unsigned long long>(r.tls_created),
+                 r.p50_us, r.p99_us, r.p999_us);
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    std::size_t pool_tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::size_t raw_tasks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    int work_iters = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(g_work_iters);
+    if (pool_tasks == 0 || raw_tasks == 0 || work_iters < 0) {
+        std::fprintf(stderr, "usage: %s [pool_tasks] [raw_tasks] [work_iters]\n", argv[0]);
+        return 2;
+    }
+    g_work_iters = static_cast<unsigned>(work_iters);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    // ThreadLogger ctors print to stdout; keep the table on the real stdout
+    std::FILE* out = fdopen(dup(STDOUT_FILENO), "w");
+    std::fflush(stdout);
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+
+    std::fprintf(out, "=== Thread Scope Pool Scaling Harness ===\n");
+    std::fprintf(out, "pool_tasks=%zu raw_tasks=%zu work_iters=%u cores=%u\n\n",
+                 pool_tasks, raw_tasks, g_work_iters, cores);
+    std::fprintf(out, "%-6s %8s %14s %12s %10s %10s %10s\n", "mode", "workers",
+                 "tasks/sec", "TLS created", "p50(us)", "p99(us)", "p99.9(us)");
+
+    print_row(out, "raw", 1, run_raw(raw_tasks));
+    for (unsigned w = 1; w <= cores; w = (w < cores && w * 2 > cores) ? cores : w * 2) {
+        print_row(out, "pool", w, run_pool(w, pool_tasks));
+    }
+
+    std::fprintf(out, "\n=== Notes ===\n");
+    std::fprintf(out, "raw:  one std::thread per task -> one ThreadLogger ctor/dtor per task\n");
+    std::fprintf(out, "pool: ThreadLogger built once per worker, then reused by every task\n");
+    std::fprintf(out, "latency: submit -> task finished (includes queueing in pool mode)\n");
+    std::fclose(out);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+// thread_stats_demo: per-thread sharded counters vs one contended std::atomic
+//
+// Usage: thread_stats_demo [threads] [adds_per_thread]
+#include "thread_stats.hpp"
+#include "startup_report.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+enum Counter : std::size_t { kRequests = 0, kBytes = 1 };
+
+static std::atomic<std::uint64_t> g_contended{0};
+
+template <typename Body>
+static double run_threads(unsigned threads, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(body);
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    unsigned threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1]))
+                                : std::max(4u, std::thread::hardware_concurrency());
+    std::uint64_t adds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000000;
+
+    std::cout << "=== Thread Scope Sharded Stats Demo ===\n";
+    std::cout << "threads=" << threads << " adds/thread=" << adds << "\n\n";
+
+    // Reader samples totals while the writers are running
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load()) {
+            std::cout << "[reader] requests=" << thread_stats::total(kRequests)
+                      << " live_threads=" << thread_stats::live_threads() << "\n";
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    });
+
+    double sharded_ms = run_threads(threads, [adds] {
+        for (std::uint64_t i = 0; i < adds; ++i) {
+            thread_stats::add(kRequests);
+            thread_stats::add(kBytes, 64);
+        }
+    });
+    done.store(true);
+    reader.join();
+
+    double atomic_ms = run_threads(threads, [adds] {
+        for (std::uint64_t i = 0; i < adds; ++i) {
+            g_contended.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    std::uint64_t expected = static_cast<std::uint64_t>(threads) * adds;
+    std::cout << "\nrequests total=" << thread_stats::total(kRequests)
+              << " (retired=" << thread_stats::retired(kRequests)
+              << ", expected=" << expected << ")\n";
+    std::cout << "bytes total=" << thread_stats::total(kBytes) << "\n";
+    std::cout << "sharded:   " << sharded_ms * 1e6 / (2.0 * expected) << " ns/add\n";
+    std::cout << "atomic:    " << atomic_ms * 1e6 / expected << " ns/add (one shared std::atomic)\n";
+
+    std::cout << "\n=== Expected Result ===\n";
+    std::cout << "Totals match exactly; exited threads' counts live in the retired total\n";
+    std::cout << "Sharded adds stay flat as threads grow; the shared atomic does not\n";
+
+    return 0;
+}
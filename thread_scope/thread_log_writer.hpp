@@ -0,0 +1,180 @@
+#pragma once
+#include <pthread.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include "fast_exit.hpp"
+
+// Central writer for buffered ThreadLogger output.
+//
+// Each thread's ThreadLogger fills a private LogBatch without any locking.
+// Full batches (and the partial batch of an exiting thread) are pushed onto a
+// lock-free MPSC stack; one writer thread takes the whole stack with a single
+// exchange, restores FIFO order and writes it with writev(2).
+//
+// Usage: construct a ThreadLogWriter in main(); while it is alive every
+// ThreadLogger::log() call is buffered. Like g_thread_logger, the inline
+// static state is shared between the executable and libthread_worker.so.
+// fast_exit::finish() calls stop(): the calling thread's batch and everything
+// already submitted are written, other live threads' open batches are not.
+//
+// fork(): the writer thread does not exist in the child. The forking
+// thread's batch is submitted in the parent first; the child forgets the
+// writer (and the parent's queued batches, which the parent writes) and logs
+// synchronously until it constructs its own ThreadLogWriter.
+struct LogBatch {
+    static constexpr std::size_t kSize = 16 * 1024;
+
+    LogBatch* next = nullptr;
+    std::size_t used = 0;
+    char data[kSize];
+};
+
+class ThreadLogWriter {
+public:
+    ThreadLogWriter() {
+        static const int atfork = pthread_atfork(&before_fork, nullptr, &after_fork_child);
+        (void)atfork;
+        writer_ = std::thread([this] { run(); });
+        g_active.store(this, std::memory_order_release);
+    }
+
+    ~ThreadLogWriter() { stop(); }
+
+    // Defined in thread_logger.hpp: flushes the calling thread's batch, then
+    // uninstalls the writer, joins it once the stack is drained and writes
+    // whatever was submitted after its last pass; idempotent
+    void stop();
+
+    ThreadLogWriter(const ThreadLogWriter&) = delete;
+    ThreadLogWriter& operator=(const ThreadLogWriter&) = delete;
+
+    static ThreadLogWriter* active() {
+        return g_active.load(std::memory_order_acquire);
+    }
+
+    // Lock-free push (Treiber stack); ownership moves to the writer
+    void submit(LogBatch* batch) {
+        LogBatch* head = pending_.load(std::memory_order_relaxed);
+        do {
+            batch->next = head;
+        } while (!pending_.compare_exchange_weak(head, batch, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t batches() const { return submitted_.load(std::memory_order_relaxed); }
+    std::uint64_t write_calls() const { return write_calls_.load(std::memory_order_relaxed); }
+    // Batches not written in full because writev(2) failed
+    std::uint64_t lost_batches() const { return lost_batches_.load(std::memory_order_relaxed); }
+
+    // Used when no writer is active (e.g. a thread exits after shutdown)
+    static void write_direct(const LogBatch& batch) {
+        std::size_t off = 0;
+        while (off < batch.used) {
+            ssize_t n = ::write(STDOUT_FILENO, batch.data + off, batch.used - off);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            off += static_cast<std::size_t>(n);
+        }
+    }
+
+private:
+    // pthread_atfork handlers, defined in thread_logger.hpp
+    static void before_fork();
+    static void after_fork_child();
+
+    // Take everything pushed so far; returns the batches oldest-first
+    LogBatch* take_all() {
+        LogBatch* lifo = pending_.exchange(nullptr, std::memory_order_acquire);
+        LogBatch* fifo = nullptr;
+        while (lifo) {
+            LogBatch* next = lifo->next;
+            lifo->next = fifo;
+            fifo = lifo;
+            lifo = next;
+        }
+        return fifo;
+    }
+
+    void write_chain(LogBatch* chain) {
+        static constexpr int kMaxIov = 64;
+        while (chain) {
+            struct iovec iov[kMaxIov];
+            LogBatch* owned[kMaxIov];
+            int n = 0;
+            for (; chain && n < kMaxIov; chain = chain->next) {
+                iov[n].iov_base = chain->data;
+                iov[n].iov_len = chain->used;
+                owned[n++] = chain;
+            }
+            // One syscall per group of up to 64 batches; a short write
+            // resumes at the first byte the kernel did not take
+            struct iovec* pos = iov;
+            int left = n;
+            std::size_t done = 0;
+            for (;;) {
+                while (left > 0 && done >= pos->iov_len) {
+                    done -= pos->iov_len;
+                    ++pos;
+                    --left;
+                }
+                if (left == 0) {
+                    break;
+                }
+                pos->iov_base = static_cast<char*>(pos->iov_base) + done;
+                pos->iov_len -= done;
+                ssize_t w = ::writev(STDOUT_FILENO, pos, left);
+                write_calls_.fetch_add(1, std::memory_order_relaxed);
+                if (w < 0 && errno == EINTR) {
+                    done = 0;
+                    continue;
+                }
+                if (w <= 0) {
+                    lost_batches_.fetch_add(static_cast<std::uint64_t>(left),
+                                            std::memory_order_relaxed);
+                    break;
+                }
+                done = static_cast<std::size_t>(w);
+            }
+            for (int i = 0; i < n; ++i) {
+                delete owned[i];
+            }
+        }
+    }
+
+    void run() {
+        for (;;) {
+            bool stopping = !running_.load(std::memory_order_acquire);
+            LogBatch* chain = take_all();
+            if (chain) {
+                write_chain(chain);
+            } else if (stopping) {
+                return;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    static inline std::atomic<ThreadLogWriter*> g_active{nullptr};
+
+    alignas(64) std::atomic<LogBatch*> pending_{nullptr};
+    alignas(64) std::atomic<bool> running_{true};
+    std::atomic<std::uint64_t> submitted_{0};
+    std::atomic<std::uint64_t> write_calls_{0};
+    std::atomic<std::uint64_t> lost_batches_{0};
+    std::thread writer_;
+    fast_exit::Flusher<ThreadLogWriter, &ThreadLogWriter::stop> exit_flush_{"ThreadLogWriter", this};
+};
@@ -1,22 +1,150 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <thread>
+#include "singleton_instrument.hpp"
+#include "startup_report.hpp"
+#include "thread_log_writer.hpp"
 
 struct ThreadLogger {
     ThreadLogger() {
+        startup_report::CtorTimer timer("ThreadLogger", this);
+        g_created.fetch_add(1, std::memory_order_relaxed);
+        std::ostringstream tid;
+        tid << std::this_thread::get_id();
+        std::snprintf(tid_, sizeof(tid_), "%s", tid.str().c_str());
         std::cout << "ThreadLogger ctor @" << this
                   << " tid=" << std::this_thread::get_id() << "\n";
+        next_ = t_live_;
+        t_live_ = this;
+    }
+
+    // Runs at thread exit: hand any buffered records to the writer
+    ~ThreadLogger() {
+        flush();
+        for (ThreadLogger** p = &t_live_; *p; p = &(*p)->next_) {
+            if (*p == this) {
+                *p = next_;
+                break;
+            }
+        }
+    }
+
+    ThreadLogger(const ThreadLogger&) = delete;
+    ThreadLogger& operator=(const ThreadLogger&) = delete;
+
+    // Total ThreadLogger instances ever constructed (one per thread that used it)
+    static std::uint64_t instances_created() {
+        return g_created.load(std::memory_order_relaxed);
     }
 
     void log(const char* context) {
+        // Buffered mode: append to this thread's batch, no lock, no syscall
+        if (ThreadLogWriter::active()) {
+            append(context);
+            return;
+        }
         std::cout << "[" << context << "] @" << this
                   << " tid=" << std::this_thread::get_id() << "\n";
     }
+
+    // Flushes this thread's loggers that already exist, without constructing one
+    // (g_thread_logger and fast_thread_logger's instance can both be live)
+    static void flush_this_thread() {
+        for (ThreadLogger* p = t_live_; p; p = p->next_) {
+            p->flush();
+        }
+    }
+
+    void flush() {
+        if (!batch_ || batch_->used == 0) {
+            return;
+        }
+        if (ThreadLogWriter* writer = ThreadLogWriter::active()) {
+            writer->submit(batch_);
+        } else {
+            ThreadLogWriter::write_direct(*batch_);
+            delete batch_;
+        }
+        batch_ = nullptr;
+    }
+
+private:
+    void append(const char* context) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            if (!batch_) {
+                batch_ = new LogBatch;
+            }
+            std::size_t room = LogBatch::kSize - batch_->used;
+            int n = std::snprintf(batch_->data + batch_->used, room, "[%s] @%p tid=%s\n",
+                                  context, static_cast<const void*>(this), tid_);
+            if (n >= 0 && static_cast<std::size_t>(n) < room) {
+                batch_->used += static_cast<std::size_t>(n);
+                return;
+            }
+            if (n >= 0 && batch_->used == 0) {
+                // Larger than a whole batch: keep the truncated prefix and mark it
+                static constexpr char kMarker[] = "...[truncated]\n";
+                std::memcpy(batch_->data + LogBatch::kSize - (sizeof(kMarker) - 1), kMarker,
+                            sizeof(kMarker) - 1);
+                batch_->used = LogBatch::kSize;
+                flush();
+                return;
+            }
+            flush();  // Batch full: hand it off and retry in a fresh one
+        }
+    }
+
+    static inline std::atomic<std::uint64_t> g_created{0};
+    // Trivially initialized, so reading it never runs a TLS init wrapper
+    static inline thread_local ThreadLogger* t_live_ = nullptr;
+
+    char tid_[32] = {};
+    LogBatch* batch_ = nullptr;
+    ThreadLogger* next_ = nullptr;
 };
 
 // C++17: inline thread_local - per-thread, but shared across DSOs
 inline thread_local ThreadLogger g_thread_logger;
 
 inline ThreadLogger& get_thread_logger() {
+    SINGLETON_ACCESS("get_thread_logger");
     return g_thread_logger;
 }
+
+inline void ThreadLogWriter::stop() {
+    if (!writer_.joinable()) {
+        return;
+    }
+    // This thread's ThreadLogger outlives the writer; flush it while we can
+    ThreadLogger::flush_this_thread();
+    g_active.store(nullptr, std::memory_order_release);
+    running_.store(false, std::memory_order_release);
+    writer_.join();
+    // A thread that saw the writer as active just before it was uninstalled
+    // may have submitted after the writer's last take_all()
+    write_chain(take_all());
+}
+
+inline void ThreadLogWriter::before_fork() {
+    // In an atfork handler: never construct a logger here, only flush one
+    if (active()) {
+        ThreadLogger::flush_this_thread();
+    }
+}
+
+inline void ThreadLogWriter::after_fork_child() {
+    ThreadLogWriter* writer = g_active.exchange(nullptr, std::memory_order_acq_rel);
+    if (!writer) {
+        return;
+    }
+    // The queued batches are the parent's copies; the thread handle names a
+    // thread of the parent, so it is overwritten rather than joined
+    writer->pending_.store(nullptr, std::memory_order_relaxed);
+    writer->running_.store(false, std::memory_order_relaxed);
+    new (&writer->writer_) std::thread();
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Sharded per-thread counters: a thread-scope singleton used as a statistic.
+//
+// Each thread owns a cache-line-aligned Block, reached through an inline
+// thread_local pointer (shared by the executable and libthread_worker.so like
+// g_thread_logger). The owning thread bumps its counters with a relaxed
+// load + store - a plain add, no lock prefix, no cache-line bouncing.
+//
+// Blocks sit on an append-only list with an atomic head and immutable next
+// pointers, and are never freed, so readers walk it and sum without any lock
+// and without stopping the writers. An exiting thread folds what it added
+// into the retired totals and marks its block free; the next new thread
+// claims it and keeps counting on top. The list is as long as the peak
+// number of concurrent threads.
+namespace thread_stats {
+
+constexpr std::size_t kCounters = 8;  // 8 x 8 bytes = one cache line
+
+struct alignas(64) Block {
+    std::atomic<std::uint64_t> counters[kCounters] = {};
+    // Owner-only: counter values when the current owner claimed the block
+    std::uint64_t base[kCounters] = {};
+    std::atomic<bool> in_use{true};
+    Block* next = nullptr;  // Set before the block is published, then immutable
+
+    // Single writer (the owning thread): no atomic read-modify-write needed
+    void add(std::size_t id, std::uint64_t n) {
+        auto& c = counters[id];
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+struct Registry {
+    std::atomic<Block*> head{nullptr};
+    std::atomic<std::uint64_t> retired[kCounters] = {};
+    std::atomic<std::size_t> live{0};
+};
+
+// Constant-initialized: safe to use from any thread_local ctor/dtor
+inline Registry g_registry;
+
+// Reuse a block left by an exited thread, or publish a new one
+inline Block* claim_block() {
+    Block* head = g_registry.head.load(std::memory_order_acquire);
+    for (Block* b = head; b; b = b->next) {
+        bool expected = false;
+        if (!b->in_use.load(std::memory_order_relaxed) &&
+            b->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return b;
+        }
+    }
+    Block* b = new Block;
+    b->next = head;
+    while (!g_registry.head.compare_exchange_weak(b->next, b, std::memory_order_release,
+                                                  std::memory_order_acquire)) {
+    }
+    return b;
+}
+
+// The thread_local part: one pointer, claimed on first use
+struct Owner {
+    Block* block;
+
+    Owner() : block(claim_block()) {
+        for (std::size_t i = 0; i < kCounters; ++i) {
+            block->base[i] = block->counters[i].load(std::memory_order_relaxed);
+        }
+        g_registry.live.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~Owner() {
+        for (std::size_t i = 0; i < kCounters; ++i) {
+            std::uint64_t mine = block->counters[i].load(std::memory_order_relaxed) - block->base[i];
+            g_registry.retired[i].fetch_add(mine, std::memory_order_relaxed);
+        }
+        g_registry.live.fetch_sub(1, std::memory_order_relaxed);
+        // Release: the next owner sees the final counter values
+        block->in_use.store(false, std::memory_order_release);
+    }
+
+    Owner(const Owner&) = delete;
+    Owner& operator=(const Owner&) = delete;
+};
+
+inline thread_local Owner g_thread_block;
+
+inline void add(std::size_t id, std::uint64_t n = 1) {
+    g_thread_block.block->add(id, n);
+}
+
+// Every count ever added, by live and exited threads alike (a reused block
+// carries its previous owners' counts); lock-free, writers keep running
+inline std::uint64_t total(std::size_t id) {
+    std::uint64_t sum = 0;
+    for (Block* b = g_registry.head.load(std::memory_order_acquire); b; b = b->next) {
+        sum += b->counters[id].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+// The part of total() added by threads that have exited
+inline std::uint64_t retired(std::size_t id) {
+    return g_registry.retired[id].load(std::memory_order_relaxed);
+}
+
+inline std::size_t live_threads() {
+    return g_registry.live.load(std::memory_order_relaxed);
+}
+
+}  // namespace thread_stats
@@ -0,0 +1,93 @@
+// thread_tls_bench: cost of get_thread_logger() under each TLS access model,
+// called from the main executable and from a shared library.
+//
+//   global-dynamic  __tls_get_addr call (default for -fPIC code)
+//   local-dynamic   module base via __tls_get_addr + offset; forced with
+//                   -ftls-model it binds the module's own copy, so the lib
+//                   row reaches a private g_thread_logger (lib same = NO)
+//   initial-exec    %fs-relative load of a GOT offset (static TLS block only)
+//   local-exec      %fs-relative constant offset (executable only)
+//
+// Usage: thread_tls_bench [iterations]
+#include "thread_logger.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using LoopFn = std::uintptr_t (*)(std::uint64_t);
+
+#define DECLARE_LOOP(side, model) extern "C" std::uintptr_t tls_loop_##side##_##model(std::uint64_t);
+DECLARE_LOOP(exe, global_dynamic)
+DECLARE_LOOP(exe, local_dynamic)
+DECLARE_LOOP(exe, initial_exec)
+DECLARE_LOOP(exe, local_exec)
+DECLARE_LOOP(lib, global_dynamic)
+DECLARE_LOOP(lib, local_dynamic)
+DECLARE_LOOP(lib, initial_exec)
+
+struct Case {
+    const char* model;
+    LoopFn exe;
+    LoopFn lib;  // nullptr: not legal in a shared object
+};
+
+static double ns_per_access(LoopFn loop, std::uint64_t iters, bool& same) {
+    loop(1000);  // Warm up
+    auto start = std::chrono::steady_clock::now();
+    std::uintptr_t sum = loop(iters);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    // Every model must reach the executable's (merged) g_thread_logger
+    same = loop(1) == reinterpret_cast<std::uintptr_t>(&get_thread_logger());
+    asm volatile("" : : "r"(sum));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+int main(int argc, char** argv) {
+    startup_report::mark_main();
+
+    std::uint64_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000ULL;
+
+    const Case cases[] = {
+        {"global-dynamic", tls_loop_exe_global_dynamic, tls_loop_lib_global_dynamic},
+        {"local-dynamic", tls_loop_exe_local_dynamic, tls_loop_lib_local_dynamic},
+        {"initial-exec", tls_loop_exe_initial_exec, tls_loop_lib_initial_exec},
+        {"local-exec", tls_loop_exe_local_exec, nullptr},
+    };
+
+    std::cout << "=== Thread Scope TLS Access-Model Benchmark ===\n";
+    std::cout << "iterations=" << iters << "\n\n";
+    get_thread_logger();  // Construct the main thread's instance up front
+
+    std::cout << std::left << std::setw(16) << "model" << std::right
+              << std::setw(14) << "exe ns/op" << std::setw(14) << "lib ns/op"
+              << std::setw(10) << "exe same" << std::setw(10) << "lib same" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (const Case& c : cases) {
+        bool exe_same = false;
+        bool lib_same = false;
+        double exe = ns_per_access(c.exe, iters, exe_same);
+        std::cout << std::left << std::setw(16) << c.model << std::right << std::setw(14) << exe;
+        if (c.lib) {
+            double lib = ns_per_access(c.lib, iters, lib_same);
+            std::cout << std::setw(14) << lib << std::setw(10) << (exe_same ? "yes" : "NO")
+                      << std::setw(10) << (lib_same ? "yes" : "NO") << "\n";
+        } else {
+            std::cout << std::setw(14) << "n/a" << std::setw(10) << (exe_same ? "yes" : "NO")
+                      << std::setw(10) << "-" << "\n";
+        }
+    }
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "same: the loop reached the same g_thread_logger as main (correctness check)\n";
+    std::cout << "      NO means the model bound a module-local copy - fast but wrong\n";
+    std::cout << "lib numbers include the PLT call to the TLS init wrapper (_ZTW*)\n";
+    std::cout << "local-dynamic is unusable for the exported g_thread_logger in a shared object\n";
+    std::cout << "local-exec cannot be used in a shared object (link error)\n";
+    std::cout << "initial-exec is correct for libthread_worker.so because it is linked at\n";
+    std::cout << "startup, not dlopen()ed - see THREAD_WORKER_TLS_MODEL in CMakeLists.txt\n";
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+// Compiled once per TLS model and side (exe / lib) by the thread_tls_bench
+// matrix; TLS_BENCH_SYMBOL names the resulting loop function.
+#include "thread_logger.hpp"
+#include <cstdint>
+
+extern "C" __attribute__((visibility("default"), noinline))
+std::uintptr_t TLS_BENCH_SYMBOL(std::uint64_t n) {
+    std::uintptr_t sum = 0;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        sum += reinterpret_cast<std::uintptr_t>(&get_thread_logger());
+        asm volatile("" : "+r"(sum) : : "memory");
+    }
+    return sum;
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include "fast_exit.hpp"
+
+// Optional asynchronous sink for Logger::log().
+//
+// Producers copy a fixed-size record into a preallocated lock-free ring
+// (bounded MPSC, one sequence number per slot). A single background drainer
+// formats records and batches them into large write(2) calls on stdout.
+//
+// Usage: construct an AsyncSink; while it is alive every Logger::log() call
+// is routed through it. Destroy it after all logging threads are done.
+// fast_exit::finish() stops it like the destructor would, so queued records
+// reach stdout even though the destructor never runs.
+class AsyncSink {
+public:
+    enum class Overflow {
+        Drop,   // Ring full: discard the record and count it
+        Block,  // Ring full: spin/yield until the drainer frees a slot
+    };
+
+    static constexpr std::size_t kCapacity = 4096;  // Must be a power of two
+    static constexpr std::size_t kTextSize = 40;    // Bytes of msg kept per record (slot = 1 cache line)
+    static constexpr std::size_t kBatchSize = 64 * 1024;
+
+    explicit AsyncSink(Overflow policy = Overflow::Drop) : policy_(policy) {
+        for (std::size_t i = 0; i < kCapacity; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        drainer_ = std::thread([this] { drain_loop(); });
+        g_active.store(this, std::memory_order_release);
+    }
+
+    ~AsyncSink() { stop(); }
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    // The currently installed sink, or nullptr for synchronous std::cout mode
+    static AsyncSink* active() {
+        return g_active.load(std::memory_order_acquire);
+    }
+
+    // Hot path: one CAS on the ring head plus a small memcpy
+    void push(const void* owner, const char* msg) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        bool waited = false;
+        for (;;) {
+            Slot& slot = slots_[pos & (kCapacity - 1)];
+            std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.owner = owner;
+                    std::size_t len = std::strlen(msg);
+                    slot.len = static_cast<std::uint16_t>(len < kTextSize ? len : kTextSize);
+                    std::memcpy(slot.text, msg, slot.len);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+            } else if (diff < 0) {
+                // Ring is full
+                if (policy_ == Overflow::Drop) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (!waited) {
+                    blocked_.fetch_add(1, std::memory_order_relaxed);
+                    waited = true;
+                }
+                std::this_thread::yield();
+                pos = head_.load(std::memory_order_relaxed);
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Uninstall, drain what is queued and join the drainer; idempotent
+    void stop() {
+        if (!drainer_.joinable()) {
+            return;
+        }
+        g_active.store(nullptr, std::memory_order_release);
+        running_.store(false, std::memory_order_release);
+        drainer_.join();
+    }
+
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    std::uint64_t blocked() const { return blocked_.load(std::memory_order_relaxed); }
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t batches() const { return batches_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::size_t> seq;
+        const void* owner;
+        std::uint16_t len;
+        char text[kTextSize];
+    };
+
+    // Single consumer: tail_ is only touched by the drainer thread
+    bool pop_into(char* out, std::size_t& used) {
+        Slot& slot = slots_[tail_ & (kCapacity - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) {
+            return false;
+        }
+        // Same format as the synchronous path: "[msg] @0x...\n"
+        out[used++] = '[';
+        std::memcpy(out + used, slot.text, slot.len);
+        used += slot.len;
+        used += static_cast<std::size_t>(
+            std::snprintf(out + used, kBatchSize - used, "] @%p\n", slot.owner));
+        slot.seq.store(tail_ + kCapacity, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    void flush(const char* buf, std::size_t& used) {
+        std::size_t off = 0;
+        while (off < used) {
+            ssize_t n = ::write(STDOUT_FILENO, buf + off, used - off);
+            if (n <= 0) {
+                break;
+            }
+            off += static_cast<std::size_t>(n);
+        }
+        if (used > 0) {
+            batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+        used = 0;
+    }
+
+    void drain_loop() {
+        static constexpr std::size_t kMaxRecord = kTextSize + 32;
+        char buf[kBatchSize];
+        std::size_t used = 0;
+
+        for (;;) {
+            // Read the stop flag before draining so records pushed before
+            // shutdown are never lost
+            bool stopping = !running_.load(std::memory_order_acquire);
+            std::uint64_t n = 0;
+            while (used + kMaxRecord <= kBatchSize && pop_into(buf, used)) {
+                ++n;
+            }
+            written_.fetch_add(n, std::memory_order_relaxed);
+
+            if (n == 0 || used + kMaxRecord > kBatchSize) {
+                flush(buf, used);
+            }
+            if (n == 0) {
+                if (stopping) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+    static inline std::atomic<AsyncSink*> g_active{nullptr};
+
+    const Overflow policy_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::size_t tail_ = 0;
+    alignas(64) std::atomic<bool> running_{true};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> blocked_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    Slot slots_[kCapacity];
+    std::thread drainer_;
+    fast_exit::Flusher<AsyncSink, &AsyncSink::stop> exit_flush_{"AsyncSink", this};
+};
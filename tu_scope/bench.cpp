@@ -0,0 +1,170 @@
+// tu_scope_bench: access cost of four singleton accessor strategies
+//
+//   static     - get_logger_static()   (per-TU copy, internal linkage)
+//   inline     - get_logger_inline()   (C++17 inline variable)
+//   meyers     - function-local static (guard variable + __cxa_guard_acquire)
+//   constinit  - Singleton<T, ConstantInit> (no guard, no dynamic initializer)
+//
+// Usage: tu_scope_bench [iterations] [max_threads]
+#include "logger_static.hpp"
+#include "logger_inline.hpp"
+#include "logger_constinit.hpp"
+
+#include <elf.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- Meyers singleton (constinit comes from logger_constinit.hpp) ---
+
+// always_inline so bench_access_meyers measures the guard check, not a tail call
+__attribute__((always_inline)) inline Logger& get_logger_meyers() {
+    static Logger instance;  // Guarded: every call checks the guard byte
+    return instance;
+}
+
+// --- Out-of-line copies, used only to measure generated code size ---
+
+#define BENCH_ACCESSOR(name, expr)                                    \
+    extern "C" __attribute__((noinline, used)) const void*            \
+    bench_access_##name() {                                           \
+        return &(expr);                                               \
+    }
+
+BENCH_ACCESSOR(static, get_logger_static())
+BENCH_ACCESSOR(inline, get_logger_inline())
+BENCH_ACCESSOR(meyers, get_logger_meyers())
+BENCH_ACCESSOR(constinit, get_logger_constinit())
+
+// Look up st_size of bench_access_* in our own ELF symbol table
+static std::size_t symbol_size(const char* name) {
+    std::ifstream in("/proc/self/exe", std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (image.size() < sizeof(Elf64_Ehdr)) {
+        return 0;
+    }
+
+    auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(image.data());
+    auto* shdrs = reinterpret_cast<const Elf64_Shdr*>(image.data() + ehdr->e_shoff);
+    for (int i = 0; i < ehdr->e_shnum; ++i) {
+        if (shdrs[i].sh_type != SHT_SYMTAB && shdrs[i].sh_type != SHT_DYNSYM) {
+            continue;
+        }
+        auto* syms = reinterpret_cast<const Elf64_Sym*>(image.data() + shdrs[i].sh_offset);
+        const char* strtab = image.data() + shdrs[shdrs[i].sh_link].sh_offset;
+        std::size_t count = shdrs[i].sh_size / sizeof(Elf64_Sym);
+        for (std::size_t s = 0; s < count; ++s) {
+            if (std::strcmp(strtab + syms[s].st_name, name) == 0) {
+                return syms[s].st_size;
+            }
+        }
+    }
+    return 0;
+}
+
+// --- Timing loops ---
+
+// Keep the pointer "used" without letting the compiler drop the access
+static inline void escape(const void* p) {
+    asm volatile("" : : "r"(p) : "memory");
+}
+
+template <typename Access>
+static double ns_per_access(Access access, std::uint64_t iters) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iters; ++i) {
+        escape(access());
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+// All threads start together and hammer the same accessor
+template <typename Access>
+static double ns_per_access_mt(Access access, std::uint64_t iters, unsigned threads) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<double> results(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            results[t] = ns_per_access(access, iters);
+        });
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) {
+        th.join();
+    }
+    return *std::max_element(results.begin(), results.end());
+}
+
+template <typename Access>
+static void run_row(const char* name, const char* symbol, Access access,
+                    std::uint64_t iters, const std::vector<unsigned>& thread_counts) {
+    escape(access());  // Warm up: run the constructor before timing
+    std::cout << std::left << std::setw(11) << name << std::right
+              << std::setw(11) << symbol_size(symbol)
+              << std::setw(12) << ns_per_access(access, iters);
+    for (unsigned t : thread_counts) {
+        std::cout << std::setw(14) << ns_per_access_mt(access, iters, t);
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000ULL;
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                    : std::max(2u, std::thread::hardware_concurrency());
+
+    std::cout << "=== TU Scope Accessor Benchmark ===\n";
+    std::cout << "iterations/thread=" << iters << " max_threads=" << max_threads << "\n\n";
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    if (thread_counts.back() != max_threads) {
+        thread_counts.push_back(max_threads);
+    }
+
+    std::cout << std::left << std::setw(11) << "strategy" << std::right
+              << std::setw(11) << "code(B)" << std::setw(12) << "1T ns/op";
+    for (unsigned t : thread_counts) {
+        std::cout << std::setw(9) << t << "T max";
+    }
+    std::cout << "\n" << std::fixed << std::setprecision(3);
+
+    // Lambdas are inlined into the timing loop, like real call sites
+    run_row("static", "bench_access_static",
+            [] { return static_cast<const void*>(&get_logger_static()); }, iters, thread_counts);
+    run_row("inline", "bench_access_inline",
+            [] { return static_cast<const void*>(&get_logger_inline()); }, iters, thread_counts);
+    run_row("meyers", "bench_access_meyers",
+            [] { return static_cast<const void*>(&get_logger_meyers()); }, iters, thread_counts);
+    run_row("constinit", "bench_access_constinit",
+            [] { return static_cast<const void*>(&get_logger_constinit()); }, iters, thread_counts);
+
+    std::cout << "\n=== Notes ===\n";
+    std::cout << "code(B): size of an out-of-line accessor (bench_access_*)\n";
+    std::cout << "meyers pays a guard-byte load + branch per access; the others are a constant address\n";
+    std::cout << "NT max: slowest thread's ns/op with N threads hammering the same accessor\n";
+
+    return 0;
+}
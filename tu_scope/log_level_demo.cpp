@@ -0,0 +1,35 @@
+#include "logger_inline.hpp"
+#include <iostream>
+
+static int g_expensive_calls = 0;
+
+static int expensive_value() {
+    ++g_expensive_calls;
+    return 42;
+}
+
+int main() {
+    startup_report::mark_main();
+
+    std::cout << "=== TU Scope Compile-Time Log Level Demo ===\n\n";
+    std::cout << "Compiled-in minimum level: "
+              << static_log::level_name(static_log::kMinLevel) << "\n\n";
+
+    SLOG(get_logger_inline(), Trace, "trace value={}", expensive_value());
+    SLOG(get_logger_inline(), Debug, "debug value={} ptr={}", expensive_value(),
+         static_cast<const void*>(&get_logger_inline()));
+    SLOG(get_logger_inline(), Info, "info ratio={} ok={}", 0.5, true);
+    SLOG(get_logger_inline(), Error, "error code={}", -1);
+
+    // Would fail to compile: placeholder count mismatch / unbalanced braces
+    // SLOG(get_logger_inline(), Info, "missing {}");
+    // SLOG(get_logger_inline(), Info, "bad { brace", 1);
+
+    std::cout << "\nexpensive_value() evaluated " << g_expensive_calls << " time(s)\n";
+
+    std::cout << "\n=== Expected Result ===\n";
+    std::cout << "Debug build (default): all four lines, 2 evaluations\n";
+    std::cout << "-DNDEBUG or -DSINGLETON_LOG_LEVEL=INFO: trace/debug compile to nothing, 0 evaluations\n";
+
+    return 0;
+}
@@ -1,9 +1,29 @@
 #pragma once
 #include <iostream>
+#include "async_sink.hpp"
+#include "static_log.hpp"
+#include "startup_report.hpp"
 
 struct Logger {
-    Logger() { std::cout << "Logger ctor @" << this << "\n"; }
+    Logger() {
+        startup_report::CtorTimer timer("Logger", this);
+        std::cout << "Logger ctor @" << this << "\n";
+    }
     void log(const char* msg) const {
+        // Async mode: hand the record to the ring, format/write off-thread
+        if (AsyncSink* sink = AsyncSink::active()) {
+            sink->push(this, msg);
+            return;
+        }
         std::cout << "[" << msg << "] @" << this << "\n";
     }
+
+    // Level-filtered, compile-time formatted variant (use via SLOG)
+    template <static_log::Level L, typename Fmt, typename... Args>
+    void logf(Fmt fmt, const Args&... args) const {
+        if constexpr (static_log::enabled<L>) {
+            char line[static_log::kLineSize];
+            log(static_log::format_to<L>(line, sizeof(line), fmt, args...));
+        }
+    }
 };
@@ -0,0 +1,19 @@
+#pragma once
+#include "singleton.hpp"
+#include <iostream>
+
+// Constant-initializable logger: constexpr constructor, no side effects.
+// (Logger itself prints in its constructor, so Singleton<Logger, ConstantInit>
+// is rejected at compile time.)
+struct ConstantLogger {
+    constexpr ConstantLogger() = default;
+
+    void log(const char* msg) const {
+        std::cout << "[" << msg << "] @" << this << "\n";
+    }
+};
+
+// Guard-free, no dynamic initializer: the cheapest possible accessor
+inline ConstantLogger& get_logger_constinit() {
+    return Singleton<ConstantLogger, ConstantInit>::instance();
+}
@@ -1,9 +1,20 @@
 #pragma once
 #include "logger.hpp"
+#include "singleton_instrument.hpp"
+#include "singleton.hpp"
 
+#if SINGLETON_LAZY_INIT
+// Lazy mode: constructed on first call instead of during static initialization
+inline Logger& get_logger_inline() {
+    SINGLETON_ACCESS("get_logger_inline");
+    return Singleton<Logger, LocalStatic>::instance();
+}
+#else
 // C++17: inline variable guarantees a single instance across the entire binary
 inline Logger g_logger_inline;
 
 inline Logger& get_logger_inline() {
+    SINGLETON_ACCESS("get_logger_inline");
     return g_logger_inline;
 }
+#endif
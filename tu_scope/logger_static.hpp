@@ -1,6 +1,14 @@
 #pragma once
 #include "logger.hpp"
 
+#if SINGLETON_LAZY_INIT
+// Lazy mode: constructed on first call, still one instance per TU - the
+// function has internal linkage, so each TU has its own function-local static
+static Logger& get_logger_static() {
+    static Logger g_logger_static;
+    return g_logger_static;
+}
+#else
 // WARNING: Each TU that includes this header gets its own g_logger_static
 // This is a common pitfall when using static in headers
 static Logger g_logger_static;
@@ -8,3 +16,4 @@ static Logger g_logger_static;
 static Logger& get_logger_static() {
     return g_logger_static;
 }
+#endif
@@ -1,9 +1,12 @@
+#include "startup_report.hpp"
 #include <iostream>
 
 void user_a_report();
 void user_b_report();
 
 int main() {
+    startup_report::mark_main();
+
     std::cout << "=== TU Scope Singleton Demo ===\n\n";
 
     user_a_report();
@@ -13,6 +16,7 @@ int main() {
     std::cout << "\n=== Expected Result ===\n";
     std::cout << "static:  user_a != user_b (per-TU)\n";
     std::cout << "inline:  user_a == user_b (per-binary)\n";
+    std::cout << "constinit: user_a == user_b (per-binary, no constructor before main)\n";
 
     return 0;
 }
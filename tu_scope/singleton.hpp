@@ -0,0 +1,73 @@
+#pragma once
+#include <type_traits>
+
+// Singleton<T, Policy>: one instance per binary, storage chosen by Policy.
+//
+//   ConstantInit - constant-initialized storage: no guard branch, no dynamic
+//                  initializer, nothing runs before main(). T must have a
+//                  constexpr default constructor, otherwise this fails to
+//                  compile.
+//   InlineInit   - `inline` variable (like g_logger_inline): constructor runs
+//                  during static initialization.
+//   LocalStatic  - function-local static (Meyers): constructed on first call,
+//                  every call checks the guard variable.
+
+#if defined(__cpp_constinit)
+#define SINGLETON_CONSTINIT constinit
+#elif defined(__clang__)
+#define SINGLETON_CONSTINIT [[clang::require_constant_initialization]]
+#else
+#define SINGLETON_CONSTINIT
+#endif
+
+namespace singleton_detail {
+
+// Evaluated in a constant expression: fails to compile if T{} is not constexpr
+template <typename T>
+constexpr bool constant_constructible() {
+    T probe{};
+    (void)probe;
+    return true;
+}
+
+}  // namespace singleton_detail
+
+struct ConstantInit {
+    template <typename T>
+    struct Storage {
+        static_assert(singleton_detail::constant_constructible<T>(),
+                      "ConstantInit requires a constexpr default constructor");
+        SINGLETON_CONSTINIT static inline T value{};
+
+        static T& get() noexcept { return value; }
+    };
+};
+
+struct InlineInit {
+    template <typename T>
+    struct Storage {
+        static inline T value{};
+
+        static T& get() noexcept { return value; }
+    };
+};
+
+struct LocalStatic {
+    template <typename T>
+    struct Storage {
+        static T& get() {
+            static T value;
+            return value;
+        }
+    };
+};
+
+template <typename T, typename Policy = ConstantInit>
+class Singleton {
+public:
+    Singleton() = delete;
+
+    static T& instance() noexcept(noexcept(Policy::template Storage<T>::get())) {
+        return Policy::template Storage<T>::get();
+    }
+};
@@ -1,7 +1,9 @@
 #include "logger_static.hpp"
 #include "logger_inline.hpp"
+#include "logger_constinit.hpp"
 
 void user_a_report() {
     std::cout << "[user_a] static:  " << &get_logger_static() << "\n";
     std::cout << "[user_a] inline:  " << &get_logger_inline() << "\n";
+    std::cout << "[user_a] constinit: " << &get_logger_constinit() << "\n";
 }
@@ -1,7 +1,9 @@
 #include "logger_static.hpp"
 #include "logger_inline.hpp"
+#include "logger_constinit.hpp"
 
 void user_b_report() {
     std::cout << "[user_b] static:  " << &get_logger_static() << "\n";
     std::cout << "[user_b] inline:  " << &get_logger_inline() << "\n";
+    std::cout << "[user_b] constinit: " << &get_logger_constinit() << "\n";
 }